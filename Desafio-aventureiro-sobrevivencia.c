@@ -1,15 +1,317 @@
+#define _POSIX_C_SOURCE 200809L // clock_gettime, pthread_rwlock_t, strnlen, fdatasync e fileno com -std=c11
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Estatisticas de execucao: quantas insercoes, remocoes, buscas e ordenacoes
+// foram feitas, quantas comparacoes, itens movidos e alocacoes elas custaram e,
+// por operacao, um histograma de latencias medidas com o relogio monotono.
+// O histograma usa baldes em potencias de 2: o balde b conta as latencias em
+// [2^b, 2^(b+1)) ns e o ultimo tambem guarda as maiores.
+// As medicoes passam pelas macros ESTAT_*; compilando com -DSEM_ESTATISTICAS
+// elas nao leem o relogio nem tocam nos contadores.
+// Este bloco e a copia de referencia: o mestre e o novato repetem o mesmo codigo (cada
+// desafio e um programa de um arquivo so). Mudancas comecam aqui e sao copiadas para la.
+typedef enum {
+    OP_INSERIR,
+    OP_REMOVER,
+    OP_BUSCAR,
+    OP_ORDENAR,
+    NUM_OPERACOES
+} OperacaoMedida;
+
+#define BALDES_LATENCIA 32
+
+typedef struct {
+    long long operacoes[NUM_OPERACOES];
+    long long nanossegundos[NUM_OPERACOES]; // Soma das latencias, para a media
+    long long latencias[NUM_OPERACOES][BALDES_LATENCIA];
+    long long comparacoes;
+    long long movimentos;
+    long long alocacoes;
+} Estatisticas;
+
+// Contadores do programa. As alocacoes podem vir de varias threads e sao somadas
+// com atomicos relaxados; as latencias so sao registradas pela thread do menu.
+Estatisticas estatisticas;
+const char* nomesOperacoes[NUM_OPERACOES] = { "inserir", "remover", "buscar", "ordenar" };
+
+#ifndef SEM_ESTATISTICAS
+// Relogio monotono em nanossegundos (nao anda para tras se o relogio do sistema for ajustado).
+static inline uint64_t relogioNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Conta uma operacao e coloca sua latencia no balde da potencia de 2 correspondente.
+// Complexidade: O(1).
+static void registrarLatencia(OperacaoMedida op, uint64_t ns) {
+    int balde = 63 - __builtin_clzll(ns | 1);
+    if (balde >= BALDES_LATENCIA) {
+        balde = BALDES_LATENCIA - 1;
+    }
+    estatisticas.operacoes[op]++;
+    estatisticas.nanossegundos[op] += (long long)ns;
+    estatisticas.latencias[op][balde]++;
+}
+
+#define ESTAT_INICIAR(t) ((t) = relogioNs())
+#define ESTAT_REGISTRAR(op, t) registrarLatencia((op), relogioNs() - (t))
+#define ESTAT_SOMAR(campo, n) __atomic_fetch_add(&estatisticas.campo, (long long)(n), __ATOMIC_RELAXED)
+#else
+#define ESTAT_INICIAR(t) ((t) = 0)
+#define ESTAT_REGISTRAR(op, t) ((void)(op), (void)(t))
+#define ESTAT_SOMAR(campo, n) ((void)(n))
+#endif
+
+// Funcao para mostrar as estatisticas: contadores e, para cada operacao feita,
+// a latencia media e os baldes nao vazios do histograma.
+void mostrarEstatisticas() {
+#ifdef SEM_ESTATISTICAS
+    printf("Estatisticas desligadas na compilacao (-DSEM_ESTATISTICAS).\n");
+#else
+    printf("\n--- Estatisticas ---\n");
+    printf("Comparacoes: %lld | Itens movidos: %lld | Alocacoes: %lld\n", estatisticas.comparacoes, estatisticas.movimentos, estatisticas.alocacoes);
+    for (int op = 0; op < NUM_OPERACOES; op++) {
+        long long n = estatisticas.operacoes[op];
+        if (n == 0) {
+            continue;
+        }
+        printf("%s: %lld operacoes, media %.0f ns\n", nomesOperacoes[op], n, (double)estatisticas.nanossegundos[op] / n);
+        for (int b = 0; b < BALDES_LATENCIA; b++) {
+            if (estatisticas.latencias[op][b] > 0) {
+                printf("  ate %12llu ns: %lld\n", (1ULL << (b + 1)) - 1, estatisticas.latencias[op][b]);
+            }
+        }
+    }
+#endif
+}
+
+// Funcao para exportar as estatisticas em CSV (metrica,valor), para outros programas.
+// Os baldes aparecem como <operacao>.ate_<limite>ns, com todos os baldes listados.
+// Retorna 1 se o arquivo foi gravado, 0 caso contrario.
+int exportarEstatisticas(const char* caminho) {
+    FILE* arquivo = fopen(caminho, "w");
+    if (!arquivo) {
+        return 0;
+    }
+    fprintf(arquivo, "metrica,valor\n");
+    fprintf(arquivo, "comparacoes,%lld\n", estatisticas.comparacoes);
+    fprintf(arquivo, "movimentos,%lld\n", estatisticas.movimentos);
+    fprintf(arquivo, "alocacoes,%lld\n", estatisticas.alocacoes);
+    for (int op = 0; op < NUM_OPERACOES; op++) {
+        fprintf(arquivo, "%s.quantidade,%lld\n", nomesOperacoes[op], estatisticas.operacoes[op]);
+        fprintf(arquivo, "%s.ns_total,%lld\n", nomesOperacoes[op], estatisticas.nanossegundos[op]);
+        for (int b = 0; b < BALDES_LATENCIA; b++) {
+            fprintf(arquivo, "%s.ate_%lluns,%lld\n", nomesOperacoes[op], (1ULL << (b + 1)) - 1, estatisticas.latencias[op][b]);
+        }
+    }
+    return fclose(arquivo) == 0;
+}
+
+// Nova capacidade: 'atual' dobrada ate alcancar 'necessario' (crescimento geometrico).
+// Retorna -1 se o dobro passaria de INT_MAX, isto e, se 'necessario' nao cabe.
+static int capacidadeDobrada(int atual, int necessario) {
+    while (atual < necessario) {
+        if (atual > INT_MAX / 2) {
+            return -1;
+        }
+        atual *= 2;
+    }
+    return atual;
+}
+
+// Dicionario de tipos: cada tipo distinto e guardado uma unica vez e
+// identificado por um id pequeno (posicao no dicionario).
+#define MAX_TIPOS 256 // Os ids cabem em um uint8_t
+typedef struct {
+    char (*nomes)[20];
+    int quantidade;
+    int capacidade;
+} DicionarioTipos;
+
+// Dicionario unico do programa: os ids guardados nos itens valem em todas as mochilas.
+DicionarioTipos tiposItens;
 
 // Definicao da struct Item, que representa um item na mochila.
 // Contem nome, tipo e quantidade.
+// prefixoNome guarda os 8 primeiros bytes do nome (ver normalizarItem): a busca binaria
+// e a ordenacao do vetor resolvem quase toda comparacao com um unico compare de inteiros.
+// O tipo e o id no dicionario tiposItens (1 byte em vez de 20); o Item ocupa 48 bytes.
+// apagado marca uma lapide no vetor (ver removerItemVetor) e usa um byte que antes era
+// so preenchimento, entao o tamanho do Item nao muda.
 typedef struct {
+    uint64_t prefixoNome;
     char nome[30];
-    char tipo[20];
+    uint8_t tipo;
+    uint8_t apagado;
     int quantidade;
 } Item;
 
+// Funcoes para DicionarioTipos
+
+// Inicializa o dicionario vazio.
+void initDicionario(DicionarioTipos* dic) {
+    dic->nomes = NULL;
+    dic->quantidade = 0;
+    dic->capacidade = 0;
+}
+
+// Libera a memoria do dicionario.
+void liberarDicionario(DicionarioTipos* dic) {
+    free(dic->nomes);
+    initDicionario(dic);
+}
+
+// Id de um tipo ja conhecido.
+// Retorna o id, ou -1 se o tipo nunca foi inserido.
+// Complexidade: O(t), com t tipos distintos (poucos na pratica).
+int buscarTipo(const DicionarioTipos* dic, const char* tipo) {
+    for (int i = 0; i < dic->quantidade; i++) {
+        if (strcmp(dic->nomes[i], tipo) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Id do tipo, inserindo-o no dicionario se for novo.
+// Retorna o id, ou -1 se falhar a alocacao ou o limite de MAX_TIPOS for atingido.
+// Complexidade: O(t).
+int internarTipo(DicionarioTipos* dic, const char* tipo) {
+    int id = buscarTipo(dic, tipo);
+    if (id != -1) {
+        return id;
+    }
+    if (dic->quantidade == MAX_TIPOS) {
+        return -1;
+    }
+    if (dic->quantidade == dic->capacidade) {
+        int nova = dic->capacidade > 0 ? dic->capacidade * 2 : 8;
+        ESTAT_SOMAR(alocacoes, 1);
+        char (*novos)[20] = realloc(dic->nomes, (size_t)nova * sizeof(*novos));
+        if (!novos) {
+            return -1;
+        }
+        dic->nomes = novos;
+        dic->capacidade = nova;
+    }
+    strncpy(dic->nomes[dic->quantidade], tipo, sizeof(dic->nomes[0]) - 1);
+    dic->nomes[dic->quantidade][sizeof(dic->nomes[0]) - 1] = '\0';
+    return dic->quantidade++;
+}
+
+// Desfaz o internarTipo que acabou de criar 'id', quando o item que trouxe o tipo nao
+// chegou a ser inserido: um tipo sem itens nao deve ocupar um dos MAX_TIPOS ids.
+// So age se 'id' ainda for o ultimo do dicionario.
+// Complexidade: O(1).
+void descartarTipo(DicionarioTipos* dic, int id) {
+    if (id == dic->quantidade - 1) {
+        dic->quantidade--;
+    }
+}
+
+// Copia o dicionario 'origem' para 'destino' (que deve estar vazio): quem precisa
+// internar varios tipos e so aplicar o resultado se tudo der certo trabalha na copia.
+// Retorna 1 se sucesso, 0 se falhar a alocacao (destino continua vazio).
+// Complexidade: O(t).
+int copiarDicionario(DicionarioTipos* destino, const DicionarioTipos* origem) {
+    initDicionario(destino);
+    if (origem->quantidade == 0) {
+        return 1;
+    }
+    ESTAT_SOMAR(alocacoes, 1);
+    destino->nomes = malloc((size_t)origem->capacidade * sizeof(*destino->nomes));
+    if (!destino->nomes) {
+        return 0;
+    }
+    memcpy(destino->nomes, origem->nomes, (size_t)origem->quantidade * sizeof(*destino->nomes));
+    destino->quantidade = origem->quantidade;
+    destino->capacidade = origem->capacidade;
+    return 1;
+}
+
+// Nome legivel de um id do dicionario.
+// Complexidade: O(1).
+const char* nomeDoTipo(const DicionarioTipos* dic, int id) {
+    return dic->nomes[id];
+}
+
+
+// Prefixo normalizado do nome: ate 8 bytes em big-endian, completado com zeros.
+// Comparar dois prefixos como inteiros da o mesmo resultado que comparar os 8 bytes.
+uint64_t prefixoNome(const char* nome) {
+    uint64_t prefixo = 0;
+    int fim = 0;
+    for (int i = 0; i < 8; i++) {
+        if (!fim && nome[i] == '\0') {
+            fim = 1;
+        }
+        prefixo = (prefixo << 8) | (fim ? 0 : (unsigned char)nome[i]);
+    }
+    return prefixo;
+}
+
+// Prepara o item para as comparacoes rapidas do vetor: completa o nome com zeros
+// ate o fim do campo (a comparacao de largura fixa olha os 30 bytes) e atualiza o prefixo.
+// Tambem marca o item como vivo (nao e lapide).
+void normalizarItem(Item* it) {
+    const char* fim = (const char*)memchr(it->nome, '\0', sizeof(it->nome));
+    size_t usados = fim ? (size_t)(fim - it->nome) : sizeof(it->nome) - 1;
+    memset(it->nome + usados, 0, sizeof(it->nome) - usados);
+    it->prefixoNome = prefixoNome(it->nome);
+    it->apagado = 0;
+}
+
+// Compara dois nomes de largura fixa (30 bytes, completados com zeros); mesmo sinal de strcmp.
+// Com SSE2 sao duas cargas de 16 bytes por lado (a segunda sobrepoe a primeira e termina
+// no fim do campo); o primeiro byte diferente sai da mascara de igualdade.
+static int compararNomesFixos(const char* a, const char* b) {
+#ifdef __SSE2__
+    __m128i a0 = _mm_loadu_si128((const __m128i*)a);
+    __m128i b0 = _mm_loadu_si128((const __m128i*)b);
+    __m128i a1 = _mm_loadu_si128((const __m128i*)(a + 14));
+    __m128i b1 = _mm_loadu_si128((const __m128i*)(b + 14));
+    unsigned int diferentes = ((unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(a0, b0)) ^ 0xFFFFu)
+                            | ((unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(a1, b1)) ^ 0xFFFFu) << 14;
+    if (diferentes == 0) {
+        return 0;
+    }
+    int i = __builtin_ctz(diferentes);
+    return (unsigned char)a[i] - (unsigned char)b[i];
+#else
+    return memcmp(a, b, 30);
+#endif
+}
+
+// Compara os nomes de dois itens normalizados: prefixo primeiro, campo inteiro so no empate.
+static inline int compararNomes(const Item* a, const Item* b) {
+    if (a->prefixoNome != b->prefixoNome) {
+        return a->prefixoNome < b->prefixoNome ? -1 : 1;
+    }
+    return compararNomesFixos(a->nome, b->nome);
+}
+
+// Monta um item de busca com o nome dado, pronto para compararNomes.
+void montarChaveNome(Item* chave, const char* nome) {
+    memset(chave->nome, 0, sizeof(chave->nome));
+    strncpy(chave->nome, nome, sizeof(chave->nome) - 1);
+    chave->prefixoNome = prefixoNome(chave->nome);
+}
+
 // Definicao da struct No para a lista encadeada.
 // Cada no contem um Item e um ponteiro para o proximo no.
 typedef struct No {
@@ -17,335 +319,4777 @@ typedef struct No {
     struct No* proximo;
 } No;
 
+// Slot do indice hash: posicao do item no vetor (-1 = vazio) e o hash do seu nome.
+// Guardar o hash evita recalcula-lo ao reorganizar a tabela e descarta a maioria
+// das colisoes sem chamar strcmp.
+typedef struct {
+    int posicao;
+    unsigned int hash;
+} SlotHash;
+
+// Indice hash sobre o nome dos itens, com enderecamento aberto e sondagem linear.
+// A capacidade e sempre potencia de 2 e no maximo metade dos slots fica ocupada.
+typedef struct {
+    SlotHash* slots;
+    int capacidade;
+    int ocupados;
+} IndiceHash;
+
+// Agregados de uma mochila: numero de itens e soma das quantidades, no total e por tipo.
+// Cada estrutura atualiza os agregados em O(1) a cada insercao e remocao, entao os
+// totais sao lidos sem percorrer os itens. O array por tipo so cresce ate o maior id
+// visto na mochila, para nao pesar nas mochilas pequenas da loja.
+typedef struct {
+    int itens;
+    long long quantidade;
+} TotalTipo;
+
+typedef struct {
+    TotalTipo* porTipo; // Indexado pelo id em tiposItens
+    int numTipos;       // Ids com espaco em porTipo
+    int itens;
+    long long quantidade;
+} ResumoMochila;
+
 // Definicao da mochila usando vetor (array sequencial).
-// Usa um array fixo de tamanho MAX e um contador de tamanho atual.
-#define MAX 100
+// O array fica no heap e cresce geometricamente (dobra a capacidade) quando enche,
+// o que torna a insercao no final O(1) amortizado.
+// Trie compacta (radix) dos nomes, para busca por prefixo.
+// Cada no guarda o trecho do nome na aresta que chega nele (ate ROTULO_TRIE bytes;
+// trechos maiores viram uma cadeia curta de nos) e quantos nomes terminam ali.
+// Os filhos ficam numa lista de irmaos ordenada pelo primeiro byte, entao a
+// subarvore e percorrida em ordem alfabetica. Nos ficam num array (indices em vez
+// de ponteiros) e os removidos vao para uma lista de livres.
+// A trie so guarda nomes: as posicoes vem do indice hash, que ja e mantido a cada
+// movimento de item.
+#define ROTULO_TRIE 12
+typedef struct {
+    char rotulo[ROTULO_TRIE];
+    uint8_t tamanho; // Bytes usados em rotulo (0 so na raiz)
+    int filho;       // Primeiro filho, -1 se nao tem
+    int irmao;       // Proximo irmao, -1 se e o ultimo (tambem encadeia a lista de livres)
+    int contagem;    // Nomes que terminam neste no (nomes repetidos contam mais de uma vez)
+    int total;       // Nomes na subarvore (este no e descendentes): conta resultados sem visita-los
+} NoTrie;
+
+typedef struct {
+    NoTrie* nos;     // nos[0] e a raiz
+    int quantidade;  // Nos ja usados no array (inclusive os que estao na lista de livres)
+    int capacidade;
+    int livres;      // Primeiro no livre, -1 se nenhum
+    int ativa;       // 1 se o indice de prefixos esta ligado para o vetor
+} TriePrefixos;
+
+// Layout de Eytzinger dos nomes do vetor ordenado (ver buscarEytzingerVetor).
+// Os prefixos dos nomes vivos ficam na ordem de um percurso em largura da arvore binaria
+// implicita: raiz em 1, filhos de k em 2k e 2k + 1. Os primeiros niveis, por onde toda
+// busca passa, ficam juntos no inicio do array (e na cache), e os 8 descendentes de k
+// tres niveis abaixo (8k a 8k + 7) ocupam uma unica linha de 64 bytes.
 typedef struct {
-    Item itens[MAX];
+    uint64_t* prefixos;     // prefixos[1..tamanho]; alinhado a 64 bytes
+    int* posicoes;          // posicoes[k]: posicao no vetor do item de prefixos[k]
     int tamanho;
+    int capacidade;
+    long long modificacoes; // mv->modificacoes quando o layout foi montado (-1: nunca)
+} LayoutEytzinger;
+
+// Remocoes no vetor ordenado deixam lapides (itens marcados como apagados) em vez de
+// deslocar o resto do array; o vetor e compactado numa unica passada quando mais de
+// 1/PROPORCAO_LAPIDES das posicoes sao lapides.
+#define CAPACIDADE_INICIAL 16
+#define PROPORCAO_LAPIDES 4
+typedef struct {
+    Item* itens;
+    int tamanho;     // Posicoes ocupadas em itens, incluindo as lapides
+    int apagados;    // Lapides em itens[0, tamanho) (fora do indice hash, da trie e do resumo)
+    int capacidade;
+    int realocacoes; // Quantas vezes o array foi realocado (para analise de desempenho)
+    int ordenado;    // 1 se o vetor esta ordenado por nome (remocao preserva a ordem)
+    int manterOrdenado; // Modo "manter ordenado": insercoes vao direto para a posicao certa
+    long long comparacoes; // Comparacoes acumuladas na manutencao da ordem (insercao/remocao/ordenacao)
+    long long movimentos;  // Itens copiados acumulados na manutencao da ordem
+    IndiceHash indice; // Indice hash por nome, mantido em sincronia com 'itens'
+    TriePrefixos prefixos; // Indice de prefixos dos nomes (opcional, ver definirIndicePrefixos)
+    ResumoMochila resumo;  // Totais por tipo, mantidos a cada insercao e remocao
+    long long modificacoes; // Alteracoes no conteudo ou na ordem dos itens (invalida 'eytzinger')
+    LayoutEytzinger eytzinger; // Montado sob demanda pela busca de Eytzinger
+    void* mapa;        // Arquivo mapeado de onde vem 'itens' e o indice (NULL se estao no heap)
+    size_t tamanhoMapa;
 } MochilaVetor;
 
+// Bloco de nos contiguos do pool da lista encadeada.
+// Os nos de um bloco ficam lado a lado na memoria, o que melhora a localidade
+// do percurso e troca NOS_POR_BLOCO chamadas de malloc por uma so.
+#define NOS_POR_BLOCO 64
+typedef struct BlocoNos {
+    struct BlocoNos* proximo;
+    No nos[NOS_POR_BLOCO];
+} BlocoNos;
+
+// Pool (alocador em blocos com lista de livres) para os nos da lista.
+// Nos removidos voltam para a lista de livres e sao reaproveitados antes de
+// qualquer nova alocacao.
+typedef struct {
+    BlocoNos* blocos;      // Blocos alocados (o mais recente primeiro)
+    int usadosNoBloco;     // Nos ja entregues do bloco mais recente
+    No* livres;            // Nos devolvidos, encadeados pelo campo proximo
+    long chamadasMalloc;   // Quantos malloc o pool realmente fez
+    long nosEntregues;     // Quantos nos foram pedidos (= malloc sem o pool)
+    long nosReciclados;    // Quantos pedidos foram atendidos pela lista de livres
+} PoolNos;
+
 // Definicao da mochila usando lista encadeada.
-// Aponta para o inicio da lista.
+// Aponta para o inicio da lista; os nos vem do pool da propria mochila.
 typedef struct {
     No* inicio;
+    PoolNos pool;
+    ResumoMochila resumo;
 } MochilaLista;
 
-// Funcoes para MochilaVetor
+// Definicao do no da lista desenrolada (unrolled linked list).
+// Cada no guarda ate ITENS_POR_BLOCO itens contiguos, de modo que o percurso
+// le varios itens por linha de cache e so salta de ponteiro a cada bloco.
+#define ITENS_POR_BLOCO 12
+typedef struct NoDesenrolado {
+    int usados; // Quantos itens do bloco estao ocupados
+    struct NoDesenrolado* proximo;
+    Item itens[ITENS_POR_BLOCO];
+} NoDesenrolado;
 
-// Inicializa a mochila vetor, definindo tamanho como 0.
-void initVetor(MochilaVetor* mv) {
-    mv->tamanho = 0;
+// Definicao da mochila usando lista desenrolada.
+// Aponta para o primeiro bloco e guarda o total de itens.
+typedef struct {
+    NoDesenrolado* inicio;
+    int tamanho;
+    ResumoMochila resumo;
+} MochilaDesenrolada;
+
+// Definicao do no da skip list.
+// Alem do ponteiro para o proximo no (nivel 0), cada no tem ponteiros "expressos"
+// nos niveis 1 a nivel-1, que pulam varios nos de uma vez. O numero de niveis e
+// sorteado na insercao (cada nivel a mais com probabilidade 1/4), entao cerca de
+// n/4^k nos aparecem no nivel k e a busca desce os niveis em O(log n) esperado.
+#define NIVEL_MAXIMO_SKIP 16 // 4^16 nos antes de os niveis deixarem de ajudar
+typedef struct NoSkip {
+    Item dados;
+    int nivel;
+    struct NoSkip* proximo[]; // 'nivel' ponteiros, alocados junto com o no
+} NoSkip;
+
+// Definicao da mochila skip list: lista encadeada mantida ordenada por nome.
+// Insercao, remocao e busca em O(log n) esperado, sem deslocar itens.
+typedef struct {
+    NoSkip* cabeca[NIVEL_MAXIMO_SKIP]; // Primeiro no de cada nivel
+    int nivel;                         // Niveis em uso (pelo menos 1)
+    int tamanho;
+    unsigned int semente;              // Estado do sorteio de niveis
+    long long comparacoes;             // Comparacoes acumuladas em insercoes e remocoes
+    ResumoMochila resumo;
+} MochilaSkip;
+
+// Definicao da mochila colunar (structure of arrays).
+// Cada campo fica no seu proprio array: uma consulta que so precisa das
+// quantidades (ou dos tipos) percorre 4 (ou 1) bytes por item, em vez de
+// puxar o Item inteiro de 48 bytes pela cache. Os tipos sao ids de tiposItens.
+typedef struct {
+    char (*nomes)[30];
+    uint8_t* tipos;
+    int* quantidades;
+    int tamanho;
+    int capacidade;
+    ResumoMochila resumo;
+} MochilaSoA;
+
+// Estruturas disponiveis para a mochila no menu.
+typedef enum {
+    ESTRUTURA_VETOR = 1,
+    ESTRUTURA_LISTA,
+    ESTRUTURA_DESENROLADA,
+    ESTRUTURA_SOA,
+    ESTRUTURA_SKIP
+} Estrutura;
+
+// Diario de operacoes (append-only)
+//
+// Cada insercao e remocao no vetor ou na lista encadeada vira um registro binario
+// curto no fim do diario. Na proxima execucao o diario e repetido por cima do
+// ultimo snapshot (salvarVetor) e depois compactado de volta nele.
+//
+// Arquivo: CabecalhoDiario seguido dos registros:
+//   [tamanho u8][operacao u8][estrutura u8][quantidade i32][tamNome u8][nome][tamTipo u8][tipo][soma u32]
+// A soma (FNV-1a dos bytes anteriores do registro) detecta um registro cortado por uma
+// queda no meio da gravacao: a repeticao para nele.
+//
+// Commit em grupo: os registros ficam num buffer proprio e sao gravados com um unico
+// write + fdatasync a cada 'intervalo' registros (1 = duravel a cada operacao; maior =
+// menos fdatasyncs). Os registros ainda no buffer quando o programa cai se perdem: ate
+// 'intervalo' operacoes (as pendentes, ou o grupo inteiro se a queda vier no meio do
+// write + fdatasync; a repeticao para no registro cortado).
+#define ARQUIVO_SNAPSHOT "mochila.bin"
+#define ARQUIVO_DIARIO "mochila.diario"
+#define MAGICA_DIARIO "DIARIO"
+#define VERSAO_DIARIO 1
+#define INTERVALO_DIARIO_PADRAO 16
+#define TAMANHO_BUFFER_DIARIO 4096
+#define MAX_REGISTRO_DIARIO 64 // 1 + 1 + 1 + 4 + 1 + 29 + 1 + 19 + 4 = 61
+
+typedef enum {
+    OPERACAO_INSERIR = 1,
+    OPERACAO_REMOVER
+} OperacaoDiario;
+
+typedef struct {
+    char magica[8];
+    uint32_t versao;
+    uint32_t reservado;
+    uint64_t somaSnapshot; // Soma do snapshot sobre o qual os registros do vetor se aplicam (0: nenhum)
+} CabecalhoDiario;
+
+typedef struct {
+    int fd;                 // -1: diario fechado (nada e registrado)
+    char caminho[256];
+    int intervalo;          // Registros por commit
+    int pendentes;          // Registros no buffer ainda nao gravados
+    size_t usado;
+    unsigned char buffer[TAMANHO_BUFFER_DIARIO];
+    long long registros;    // Contadores desde a abertura
+    long long commits;
+    long long falhas;
+    long long falhasAvisadas; // Falhas ja mostradas ao usuario (ver avisarFalhasDiario)
+    long long compactacoes;
+} Diario;
+
+Diario diario = { .fd = -1 };
+
+// FNV-1a de 32 bits sobre os bytes de um registro.
+static uint32_t somaRegistro(const unsigned char* p, size_t tamanho) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < tamanho; i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
 }
 
-// Insere um novo item no final do vetor.
-// Retorna 1 se sucesso, 0 se mochila cheia.
-// Complexidade: O(1) - insercao constante.
-int inserirItemVetor(MochilaVetor* mv, Item it) {
-    if (mv->tamanho >= MAX) {
-        return 0; // Mochila cheia
+// Grava todos os 'tamanho' bytes em fd, repetindo em escritas parciais.
+// Retorna 1 se sucesso, 0 se falha de escrita.
+static int gravarTudo(int fd, const void* dados, size_t tamanho) {
+    const unsigned char* p = (const unsigned char*)dados;
+    while (tamanho > 0) {
+        ssize_t escritos = write(fd, p, tamanho);
+        if (escritos <= 0) {
+            return 0;
+        }
+        p += escritos;
+        tamanho -= (size_t)escritos;
+    }
+    return 1;
+}
+
+// Abre (ou cria) o diario em 'caminho' para acrescentar registros.
+// Um arquivo vazio recebe o cabecalho com 'somaSnapshot'.
+// Retorna 1 se sucesso, 0 se falha ao abrir ou gravar.
+int abrirDiario(Diario* d, const char* caminho, int intervalo, uint64_t somaSnapshot) {
+    if (snprintf(d->caminho, sizeof(d->caminho), "%s", caminho) >= (int)sizeof(d->caminho)) {
+        return 0;
+    }
+    d->fd = open(caminho, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (d->fd < 0) {
+        return 0;
+    }
+    d->intervalo = intervalo > 0 ? intervalo : 1;
+    d->pendentes = 0;
+    d->usado = 0;
+    struct stat info;
+    if (fstat(d->fd, &info) == 0 && info.st_size == 0) {
+        CabecalhoDiario cab;
+        memset(&cab, 0, sizeof(cab));
+        memcpy(cab.magica, MAGICA_DIARIO, sizeof(MAGICA_DIARIO));
+        cab.versao = VERSAO_DIARIO;
+        cab.somaSnapshot = somaSnapshot;
+        if (!gravarTudo(d->fd, &cab, sizeof(cab)) || fsync(d->fd) != 0) {
+            close(d->fd);
+            d->fd = -1;
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Commit do grupo: grava os registros pendentes com um write e um fdatasync.
+// Retorna 1 se sucesso (ou nada pendente), 0 se falha (os registros sao descartados).
+int confirmarDiario(Diario* d) {
+    if (d->fd < 0 || d->usado == 0) {
+        return 1;
+    }
+    int ok = gravarTudo(d->fd, d->buffer, d->usado) && fdatasync(d->fd) == 0;
+    d->usado = 0;
+    d->pendentes = 0;
+    d->commits++;
+    if (!ok) {
+        d->falhas++;
+    }
+    return ok;
+}
+
+// Confirma o que estiver pendente e fecha o diario.
+void fecharDiario(Diario* d) {
+    if (d->fd >= 0) {
+        confirmarDiario(d);
+        close(d->fd);
+        d->fd = -1;
+    }
+}
+
+// Mostra as falhas de gravacao do diario ocorridas desde o ultimo aviso: os registros
+// desses commits foram descartados e as operacoes nao sobrevivem a uma queda.
+void avisarFalhasDiario(Diario* d) {
+    if (d->falhas > d->falhasAvisadas) {
+        printf("Aviso: %lld falha(s) ao gravar o diario %s; as ultimas operacoes nao foram persistidas.\n",
+               d->falhas - d->falhasAvisadas, d->caminho);
+        d->falhasAvisadas = d->falhas;
+    }
+}
+
+// Acrescenta um registro ao buffer do diario (nada acontece com o diario fechado).
+// Confirma o grupo ao completar o intervalo.
+// Complexidade: O(1); um write + fdatasync a cada 'intervalo' chamadas.
+static void acrescentarRegistro(Diario* d, OperacaoDiario operacao, Estrutura estrutura, const char* nome, const char* tipo, int quantidade) {
+    if (d->fd < 0) {
+        return;
+    }
+    size_t tamNome = strnlen(nome, 29);
+    size_t tamTipo = strnlen(tipo, 19);
+    size_t tamanho = 1 + 1 + 1 + 4 + 1 + tamNome + 1 + tamTipo + 4;
+    if (d->usado + tamanho > sizeof(d->buffer)) {
+        confirmarDiario(d);
+    }
+    unsigned char* p = d->buffer + d->usado;
+    p[0] = (unsigned char)tamanho;
+    p[1] = (unsigned char)operacao;
+    p[2] = (unsigned char)estrutura;
+    memcpy(p + 3, &quantidade, 4);
+    p[7] = (unsigned char)tamNome;
+    memcpy(p + 8, nome, tamNome);
+    p[8 + tamNome] = (unsigned char)tamTipo;
+    memcpy(p + 9 + tamNome, tipo, tamTipo);
+    uint32_t soma = somaRegistro(p, tamanho - 4);
+    memcpy(p + tamanho - 4, &soma, 4);
+    d->usado += tamanho;
+    d->registros++;
+    if (++d->pendentes >= d->intervalo) {
+        confirmarDiario(d);
+    }
+}
+
+// Ganchos chamados pelas funcoes de insercao e remocao do vetor e da lista.
+// Usam o diario global, que so fica aberto no modo interativo (nao nos benchmarks
+// nem durante a repeticao do diario).
+static void registrarInsercao(Estrutura estrutura, const Item* it) {
+    acrescentarRegistro(&diario, OPERACAO_INSERIR, estrutura, it->nome, nomeDoTipo(&tiposItens, it->tipo), it->quantidade);
+}
+
+static void registrarRemocao(Estrutura estrutura, const char* nome) {
+    acrescentarRegistro(&diario, OPERACAO_REMOVER, estrutura, nome, "", 0);
+}
+
+// Funcoes para IndiceHash
+
+// Funcao hash FNV-1a de 32 bits sobre o nome.
+unsigned int hashNome(const char* nome) {
+    unsigned int h = 2166136261u;
+    while (*nome) {
+        h ^= (unsigned char)*nome++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Inicializa o indice vazio, sem memoria alocada.
+void initIndice(IndiceHash* ih) {
+    ih->slots = NULL;
+    ih->capacidade = 0;
+    ih->ocupados = 0;
+}
+
+// Libera a memoria do indice.
+void liberarIndice(IndiceHash* ih) {
+    free(ih->slots);
+    initIndice(ih);
+}
+
+// Coloca a posicao 'pos' (com hash 'h') no primeiro slot livre da sua sequencia de sondagem.
+static void indiceColocar(IndiceHash* ih, int pos, unsigned int h) {
+    unsigned int mascara = (unsigned int)ih->capacidade - 1;
+    unsigned int i = h & mascara;
+    while (ih->slots[i].posicao != -1) {
+        i = (i + 1) & mascara;
+    }
+    ih->slots[i].posicao = pos;
+    ih->slots[i].hash = h;
+    ih->ocupados++;
+}
+
+// Reconstroi o indice a partir dos n primeiros itens do vetor.
+// Usado apos operacoes que reorganizam o vetor inteiro (ordenacao).
+// Complexidade: O(n + capacidade).
+void indiceReconstruir(IndiceHash* ih, const Item* itens, int n) {
+    for (int i = 0; i < ih->capacidade; i++) {
+        ih->slots[i].posicao = -1;
+    }
+    ih->ocupados = 0;
+    for (int i = 0; i < n; i++) {
+        if (!itens[i].apagado) { // Lapides nao entram no indice
+            indiceColocar(ih, i, hashNome(itens[i].nome));
+        }
+    }
+}
+
+// Garante que o indice comporte 'total' entradas mantendo fator de carga <= 1/2.
+// Se precisar crescer, aloca uma nova tabela e reinsere os n itens atuais.
+// Retorna 1 se sucesso, 0 se falha na alocacao (o indice original fica intacto).
+static int indiceReservar(IndiceHash* ih, const Item* itens, int n, int total) {
+    if (total > INT_MAX / 2) {
+        return 0;
+    }
+    if (total * 2 <= ih->capacidade) {
+        return 1;
+    }
+    int nova = capacidadeDobrada(ih->capacidade > 0 ? ih->capacidade : CAPACIDADE_INICIAL * 2, total * 2);
+    if (nova < 0) {
+        return 0;
+    }
+    ESTAT_SOMAR(alocacoes, 1);
+    SlotHash* slots = (SlotHash*)malloc((size_t)nova * sizeof(SlotHash));
+    if (!slots) {
+        return 0;
+    }
+    free(ih->slots);
+    ih->slots = slots;
+    ih->capacidade = nova;
+    indiceReconstruir(ih, itens, n);
+    return 1;
+}
+
+// Registra no indice o item que esta na posicao 'pos'.
+// Requer espaco reservado previamente com indiceReservar.
+// Complexidade: O(1) esperado.
+void indiceInserir(IndiceHash* ih, const Item* itens, int pos) {
+    indiceColocar(ih, pos, hashNome(itens[pos].nome));
+}
+
+// Busca a posicao de um item pelo nome.
+// Conta o numero de sondagens (slots visitados) em *sondagens.
+// Retorna a posicao se encontrado, -1 caso contrario.
+// Complexidade: O(1) esperado.
+int indiceBuscar(const IndiceHash* ih, const Item* itens, const char* nome, int* sondagens) {
+    *sondagens = 0;
+    if (ih->capacidade == 0) {
+        return -1;
+    }
+    unsigned int mascara = (unsigned int)ih->capacidade - 1;
+    unsigned int h = hashNome(nome);
+    unsigned int i = h & mascara;
+    while (ih->slots[i].posicao != -1) {
+        (*sondagens)++;
+        if (ih->slots[i].hash == h && strcmp(itens[ih->slots[i].posicao].nome, nome) == 0) {
+            return ih->slots[i].posicao;
+        }
+        i = (i + 1) & mascara;
+    }
+    (*sondagens)++; // Slot vazio que encerra a busca
+    return -1;
+}
+
+// Localiza o slot que aponta para a posicao 'pos' de um item com o nome dado.
+static unsigned int indiceSlotDe(const IndiceHash* ih, const char* nome, int pos) {
+    unsigned int mascara = (unsigned int)ih->capacidade - 1;
+    unsigned int i = hashNome(nome) & mascara;
+    while (ih->slots[i].posicao != pos) {
+        i = (i + 1) & mascara;
+    }
+    return i;
+}
+
+// Remove do indice a entrada do item que esta na posicao 'pos'.
+// Usa remocao com deslocamento para tras (sem lapides): os slots seguintes
+// da mesma sequencia de sondagem sao puxados para preencher o buraco.
+// Complexidade: O(1) esperado.
+void indiceRemover(IndiceHash* ih, const Item* itens, int pos) {
+    unsigned int mascara = (unsigned int)ih->capacidade - 1;
+    unsigned int i = indiceSlotDe(ih, itens[pos].nome, pos);
+    unsigned int j = i;
+    while (1) {
+        j = (j + 1) & mascara;
+        if (ih->slots[j].posicao == -1) {
+            break;
+        }
+        unsigned int k = ih->slots[j].hash & mascara; // Slot ideal da entrada j
+        // A entrada j pode ocupar o buraco i se i estiver entre k e j (circularmente).
+        if (((j - k) & mascara) >= ((j - i) & mascara)) {
+            ih->slots[i] = ih->slots[j];
+            i = j;
+        }
+    }
+    ih->slots[i].posicao = -1;
+    ih->ocupados--;
+}
+
+// Atualiza a entrada de um item que mudou da posicao 'de' para 'para' no vetor.
+// Complexidade: O(1) esperado.
+void indiceMover(IndiceHash* ih, const char* nome, int de, int para) {
+    ih->slots[indiceSlotDe(ih, nome, de)].posicao = para;
+}
+
+// Soma 'delta' a todas as posicoes >= 'inicio' (usado quando o vetor desloca um trecho).
+// Complexidade: O(capacidade) - so e chamado junto de um deslocamento O(n) do vetor.
+void indiceDeslocar(IndiceHash* ih, int inicio, int delta) {
+    for (int i = 0; i < ih->capacidade; i++) {
+        if (ih->slots[i].posicao >= inicio) {
+            ih->slots[i].posicao += delta;
+        }
+    }
+}
+
+// Funcoes para TriePrefixos
+
+// Inicializa a trie vazia e desligada.
+void initTrie(TriePrefixos* t) {
+    t->nos = NULL;
+    t->quantidade = 0;
+    t->capacidade = 0;
+    t->livres = -1;
+    t->ativa = 0;
+}
+
+// Libera os nos da trie (volta ao estado inicial, desligada).
+void liberarTrie(TriePrefixos* t) {
+    free(t->nos);
+    initTrie(t);
+}
+
+// Esvazia a trie mantendo a memoria e o estado ligado/desligado.
+void limparTrie(TriePrefixos* t) {
+    t->quantidade = 0;
+    t->livres = -1;
+}
+
+// Cria um no com o rotulo dado. Pode realocar o array: indices continuam validos,
+// ponteiros para nos nao.
+// Retorna o indice do no, ou -1 se falha na alocacao.
+static int novoNoTrie(TriePrefixos* t, const char* rotulo, int tamanho) {
+    int no = t->livres;
+    if (no != -1) {
+        t->livres = t->nos[no].irmao;
+    } else {
+        if (t->quantidade == t->capacidade) {
+            int nova = capacidadeDobrada(t->capacidade > 0 ? t->capacidade : 64, t->capacidade + 1);
+            if (nova < 0) {
+                return -1;
+            }
+            ESTAT_SOMAR(alocacoes, 1);
+            NoTrie* nos = (NoTrie*)realloc(t->nos, (size_t)nova * sizeof(NoTrie));
+            if (!nos) {
+                return -1;
+            }
+            t->nos = nos;
+            t->capacidade = nova;
+        }
+        no = t->quantidade++;
+    }
+    memcpy(t->nos[no].rotulo, rotulo, (size_t)tamanho);
+    t->nos[no].tamanho = (uint8_t)tamanho;
+    t->nos[no].filho = -1;
+    t->nos[no].irmao = -1;
+    t->nos[no].contagem = 0;
+    t->nos[no].total = 0;
+    return no;
+}
+
+// Faz 'novo' ocupar o elo de onde saiu o filho: o primeiro filho de 'pai'
+// (anterior == -1) ou o irmao seguinte de 'anterior'.
+static void ligarNoTrie(TriePrefixos* t, int pai, int anterior, int novo) {
+    if (anterior == -1) {
+        t->nos[pai].filho = novo;
+    } else {
+        t->nos[anterior].irmao = novo;
+    }
+}
+
+// Filho de 'no' cujo rotulo comeca com o byte c, ou -1. Em 'anterior' devolve o irmao
+// que vem antes da posicao dele na lista (ou de onde ele entraria).
+static int filhoTrie(const TriePrefixos* t, int no, unsigned char c, int* anterior) {
+    *anterior = -1;
+    int filho = t->nos[no].filho;
+    while (filho != -1 && (unsigned char)t->nos[filho].rotulo[0] < c) {
+        *anterior = filho;
+        filho = t->nos[filho].irmao;
+    }
+    return filho != -1 && (unsigned char)t->nos[filho].rotulo[0] == c ? filho : -1;
+}
+
+// Insere um nome na trie (nomes repetidos so aumentam a contagem do no final).
+// Retorna 1 se sucesso, 0 se falha na alocacao (a trie continua valida).
+// Complexidade: O(tamanho do nome * filhos por no).
+int trieInserir(TriePrefixos* t, const char* nome) {
+    if (t->quantidade == 0 && novoNoTrie(t, "", 0) != 0) {
+        return 0;
+    }
+    int caminho[31]; // Nos do caminho, para somar 1 no total de cada um ao final
+    int profundidade = 0;
+    int no = 0;
+    const char* resto = nome;
+    while (*resto) {
+        caminho[profundidade++] = no;
+        int anterior;
+        int filho = filhoTrie(t, no, (unsigned char)*resto, &anterior);
+        if (filho == -1) {
+            int tamanho = (int)strnlen(resto, ROTULO_TRIE);
+            int novo = novoNoTrie(t, resto, tamanho);
+            if (novo == -1) {
+                return 0;
+            }
+            t->nos[novo].irmao = anterior == -1 ? t->nos[no].filho : t->nos[anterior].irmao;
+            ligarNoTrie(t, no, anterior, novo);
+            no = novo;
+            resto += tamanho;
+            continue;
+        }
+        int comum = 1;
+        while (comum < t->nos[filho].tamanho && resto[comum] == t->nos[filho].rotulo[comum]) {
+            comum++;
+        }
+        if (comum < t->nos[filho].tamanho) {
+            // Divide a aresta: 'meio' fica com o trecho em comum e adota o filho.
+            char rotulo[ROTULO_TRIE];
+            memcpy(rotulo, t->nos[filho].rotulo, (size_t)comum);
+            int meio = novoNoTrie(t, rotulo, comum);
+            if (meio == -1) {
+                return 0;
+            }
+            NoTrie* f = &t->nos[filho];
+            memmove(f->rotulo, f->rotulo + comum, (size_t)(f->tamanho - comum));
+            f->tamanho = (uint8_t)(f->tamanho - comum);
+            t->nos[meio].filho = filho;
+            t->nos[meio].irmao = f->irmao;
+            t->nos[meio].total = f->total;
+            f->irmao = -1;
+            ligarNoTrie(t, no, anterior, meio);
+            filho = meio;
+        }
+        no = filho;
+        resto += comum;
+    }
+    t->nos[no].contagem++;
+    t->nos[no].total++;
+    for (int d = 0; d < profundidade; d++) {
+        t->nos[caminho[d]].total++;
+    }
+    return 1;
+}
+
+// Remove uma ocorrencia do nome. Nos que ficam sem nomes e sem filhos sao liberados,
+// e um no sem nomes com um unico filho e fundido com ele quando o rotulo cabe,
+// para a trie continuar compacta.
+// Retorna 1 se removido, 0 se o nome nao estava na trie.
+// Complexidade: O(tamanho do nome * filhos por no).
+int trieRemover(TriePrefixos* t, const char* nome) {
+    if (t->quantidade == 0) {
+        return 0;
+    }
+    int caminho[30];    // Nos visitados (um nome tem no maximo 29 bytes)
+    int anteriores[30]; // Irmao anterior de cada um, para desliga-lo do pai
+    int profundidade = 0;
+    int no = 0;
+    const char* resto = nome;
+    while (*resto) {
+        int anterior;
+        int filho = filhoTrie(t, no, (unsigned char)*resto, &anterior);
+        if (filho == -1 || profundidade == 30 || strncmp(resto, t->nos[filho].rotulo, t->nos[filho].tamanho) != 0) {
+            return 0;
+        }
+        caminho[profundidade] = filho;
+        anteriores[profundidade] = anterior;
+        profundidade++;
+        resto += t->nos[filho].tamanho;
+        no = filho;
+    }
+    if (no == 0 || t->nos[no].contagem == 0) {
+        return 0;
+    }
+    t->nos[no].contagem--;
+    t->nos[0].total--;
+    for (int d = 0; d < profundidade; d++) {
+        t->nos[caminho[d]].total--;
+    }
+    for (int d = profundidade - 1; d >= 0; d--) {
+        int atual = caminho[d];
+        int pai = d > 0 ? caminho[d - 1] : 0;
+        if (t->nos[atual].contagem > 0) {
+            break;
+        }
+        if (t->nos[atual].filho == -1) {
+            ligarNoTrie(t, pai, anteriores[d], t->nos[atual].irmao);
+            t->nos[atual].irmao = t->livres;
+            t->livres = atual;
+            continue; // O pai pode ter ficado vazio tambem
+        }
+        int unico = t->nos[atual].filho;
+        if (t->nos[unico].irmao == -1 && t->nos[atual].tamanho + t->nos[unico].tamanho <= ROTULO_TRIE) {
+            NoTrie* a = &t->nos[atual];
+            NoTrie* f = &t->nos[unico];
+            memmove(f->rotulo + a->tamanho, f->rotulo, f->tamanho);
+            memcpy(f->rotulo, a->rotulo, a->tamanho);
+            f->tamanho = (uint8_t)(f->tamanho + a->tamanho);
+            f->irmao = a->irmao;
+            ligarNoTrie(t, pai, anteriores[d], unico);
+            a->irmao = t->livres;
+            t->livres = atual;
+        }
+        break;
+    }
+    return 1;
+}
+
+// Funcoes para ResumoMochila
+
+// Inicializa os agregados vazios, sem memoria alocada.
+void initResumo(ResumoMochila* r) {
+    r->porTipo = NULL;
+    r->numTipos = 0;
+    r->itens = 0;
+    r->quantidade = 0;
+}
+
+// Libera o array por tipo.
+void liberarResumo(ResumoMochila* r) {
+    free(r->porTipo);
+    initResumo(r);
+}
+
+// Zera os agregados mantendo a memoria.
+void limparResumo(ResumoMochila* r) {
+    if (r->numTipos > 0) {
+        memset(r->porTipo, 0, (size_t)r->numTipos * sizeof(TotalTipo));
+    }
+    r->itens = 0;
+    r->quantidade = 0;
+}
+
+// Garante espaco no array por tipo para o id 'tipo' (dobrando, ate MAX_TIPOS).
+// Deve ser chamada antes de alterar a mochila, para que uma falha nao deixe os
+// agregados fora de sincronia.
+// Retorna 1 se sucesso, 0 se falha na alocacao.
+static int resumoReservar(ResumoMochila* r, int tipo) {
+    if (tipo < r->numTipos) {
+        return 1;
+    }
+    int novo = r->numTipos > 0 ? r->numTipos : 8;
+    while (novo <= tipo) {
+        novo *= 2;
+    }
+    if (novo > MAX_TIPOS) {
+        novo = MAX_TIPOS;
+    }
+    ESTAT_SOMAR(alocacoes, 1);
+    TotalTipo* porTipo = (TotalTipo*)realloc(r->porTipo, (size_t)novo * sizeof(TotalTipo));
+    if (!porTipo) {
+        return 0;
+    }
+    memset(&porTipo[r->numTipos], 0, (size_t)(novo - r->numTipos) * sizeof(TotalTipo));
+    r->porTipo = porTipo;
+    r->numTipos = novo;
+    return 1;
+}
+
+// Soma (delta = 1) ou retira (delta = -1) um item dos agregados.
+// O id do tipo ja deve ter espaco reservado. Complexidade: O(1).
+static void resumoAjustar(ResumoMochila* r, uint8_t tipo, int quantidade, int delta) {
+    r->porTipo[tipo].itens += delta;
+    r->porTipo[tipo].quantidade += (long long)delta * quantidade;
+    r->itens += delta;
+    r->quantidade += (long long)delta * quantidade;
+}
+
+// Recalcula os agregados a partir de um array de itens (carga de arquivo).
+// Retorna 1 se sucesso, 0 se falha na alocacao (agregados zerados).
+// Complexidade: O(n).
+int reconstruirResumo(ResumoMochila* r, const Item* itens, int n) {
+    limparResumo(r);
+    if (!resumoReservar(r, tiposItens.quantidade > 0 ? tiposItens.quantidade - 1 : 0)) {
+        return 0;
+    }
+    for (int i = 0; i < n; i++) {
+        if (!itens[i].apagado) {
+            resumoAjustar(r, itens[i].tipo, itens[i].quantidade, 1);
+        }
     }
-    mv->itens[mv->tamanho++] = it;
     return 1;
 }
 
-// Remove um item pelo nome.
-// Percorre o vetor sequencialmente, remove e desloca os itens subsequentes.
-// Retorna 1 se removido, 0 se nao encontrado.
-// Complexidade: O(n) - pior caso percorre todo o vetor e desloca.
-int removerItemVetor(MochilaVetor* mv, char* nome) {
-    for (int i = 0; i < mv->tamanho; i++) {
-        if (strcmp(mv->itens[i].nome, nome) == 0) {
-            for (int j = i; j < mv->tamanho - 1; j++) {
-                mv->itens[j] = mv->itens[j + 1];
+// Totais de um tipo: numero de itens (retorno) e soma das quantidades.
+// Complexidade: O(t) para achar o id no dicionario + O(1).
+int totaisDoTipo(const ResumoMochila* r, const char* tipo, long long* quantidade) {
+    int id = buscarTipo(&tiposItens, tipo);
+    if (id == -1 || id >= r->numTipos) {
+        *quantidade = 0;
+        return 0;
+    }
+    *quantidade = r->porTipo[id].quantidade;
+    return r->porTipo[id].itens;
+}
+
+// Mostra os agregados: totais gerais e uma linha por tipo presente na mochila.
+// Complexidade: O(t), independente do numero de itens.
+void mostrarResumo(const ResumoMochila* r) {
+    printf("Itens: %d, quantidade total: %lld\n", r->itens, r->quantidade);
+    for (int id = 0; id < r->numTipos; id++) {
+        if (r->porTipo[id].itens > 0) {
+            printf("  %-20s %d item(ns), quantidade %lld\n", nomeDoTipo(&tiposItens, id), r->porTipo[id].itens, r->porTipo[id].quantidade);
+        }
+    }
+}
+
+// Funcoes para MochilaVetor
+
+// Inicializa a mochila vetor vazia, sem memoria alocada.
+void initVetor(MochilaVetor* mv) {
+    mv->itens = NULL;
+    mv->tamanho = 0;
+    mv->apagados = 0;
+    mv->capacidade = 0;
+    mv->realocacoes = 0;
+    mv->ordenado = 0;
+    mv->manterOrdenado = 0;
+    mv->comparacoes = 0;
+    mv->movimentos = 0;
+    initIndice(&mv->indice);
+    initTrie(&mv->prefixos);
+    initResumo(&mv->resumo);
+    mv->modificacoes = 0;
+    mv->eytzinger.prefixos = NULL;
+    mv->eytzinger.posicoes = NULL;
+    mv->eytzinger.tamanho = 0;
+    mv->eytzinger.capacidade = 0;
+    mv->eytzinger.modificacoes = -1;
+    mv->mapa = NULL;
+    mv->tamanhoMapa = 0;
+}
+
+// Libera a memoria do vetor e volta ao estado inicial.
+void liberarVetor(MochilaVetor* mv) {
+    if (mv->mapa) {
+        munmap(mv->mapa, mv->tamanhoMapa); // Itens e indice moram no mapeamento
+    } else {
+        free(mv->itens);
+        liberarIndice(&mv->indice);
+    }
+    liberarTrie(&mv->prefixos);
+    liberarResumo(&mv->resumo);
+    free(mv->eytzinger.prefixos);
+    free(mv->eytzinger.posicoes);
+    initVetor(mv);
+}
+
+// Um vetor carregado de arquivo usa os itens e o indice direto no mapeamento
+// (MAP_PRIVATE: alterar no lugar nao toca o arquivo). Antes de realocar qualquer
+// um dos dois, copia ambos para o heap e desfaz o mapeamento.
+// Retorna 1 se sucesso, 0 se falha na alocacao (o vetor continua mapeado).
+// Complexidade: O(n + capacidade do indice), uma unica vez por carga.
+static int desmapearVetor(MochilaVetor* mv) {
+    if (!mv->mapa) {
+        return 1;
+    }
+    ESTAT_SOMAR(alocacoes, 1);
+    Item* itens = (Item*)malloc((size_t)(mv->tamanho > 0 ? mv->tamanho : 1) * sizeof(Item));
+    ESTAT_SOMAR(alocacoes, 1);
+    SlotHash* slots = (SlotHash*)malloc((size_t)(mv->indice.capacidade > 0 ? mv->indice.capacidade : 1) * sizeof(SlotHash));
+    if (!itens || !slots) {
+        free(itens);
+        free(slots);
+        return 0;
+    }
+    if (mv->tamanho > 0) {
+        memcpy(itens, mv->itens, (size_t)mv->tamanho * sizeof(Item));
+    }
+    if (mv->indice.capacidade > 0) {
+        memcpy(slots, mv->indice.slots, (size_t)mv->indice.capacidade * sizeof(SlotHash));
+    }
+    munmap(mv->mapa, mv->tamanhoMapa);
+    mv->mapa = NULL;
+    mv->tamanhoMapa = 0;
+    mv->itens = itens;
+    mv->capacidade = mv->tamanho;
+    if (mv->indice.capacidade > 0) {
+        mv->indice.slots = slots;
+    } else {
+        free(slots);
+        mv->indice.slots = NULL;
+    }
+    return 1;
+}
+
+// Esvazia o vetor mantendo a memoria alocada (para reaproveitar a capacidade).
+void limparVetor(MochilaVetor* mv) {
+    mv->modificacoes++;
+    mv->tamanho = 0;
+    mv->apagados = 0;
+    mv->ordenado = 0;
+    if (mv->indice.capacidade > 0) {
+        indiceReconstruir(&mv->indice, mv->itens, 0);
+    }
+    limparTrie(&mv->prefixos);
+    limparResumo(&mv->resumo);
+}
+
+// Garante espaco para pelo menos 'capacidade' itens sem novas realocacoes.
+// Retorna 1 se sucesso, 0 se falha na alocacao (o vetor original fica intacto).
+// Complexidade: O(n) quando realoca, O(1) caso contrario.
+int reservarVetor(MochilaVetor* mv, int capacidade) {
+    if (capacidade <= mv->capacidade) {
+        return 1;
+    }
+    if (!desmapearVetor(mv)) {
+        return 0;
+    }
+    ESTAT_SOMAR(alocacoes, 1);
+    Item* novos = (Item*)realloc(mv->itens, (size_t)capacidade * sizeof(Item));
+    if (!novos) {
+        return 0; // Falha na alocacao
+    }
+    mv->itens = novos;
+    mv->capacidade = capacidade;
+    mv->realocacoes++;
+    return 1;
+}
+
+// Reduz a capacidade ao tamanho atual, devolvendo a memoria excedente.
+// Retorna 1 se sucesso, 0 se falha na alocacao (o vetor original fica intacto).
+// Complexidade: O(n) no pior caso (realloc pode copiar).
+int encolherVetor(MochilaVetor* mv) {
+    if (mv->tamanho == mv->capacidade) {
+        return 1;
+    }
+    if (!desmapearVetor(mv)) {
+        return 0;
+    }
+    if (mv->tamanho == 0) {
+        free(mv->itens);
+        mv->itens = NULL;
+        mv->capacidade = 0;
+        return 1;
+    }
+    ESTAT_SOMAR(alocacoes, 1);
+    Item* novos = (Item*)realloc(mv->itens, (size_t)mv->tamanho * sizeof(Item));
+    if (!novos) {
+        return 0;
+    }
+    mv->itens = novos;
+    mv->capacidade = mv->tamanho;
+    mv->realocacoes++;
+    return 1;
+}
+
+// Garante espaco para mais 'extra' itens, dobrando a capacidade se necessario.
+// O crescimento geometrico faz com que n insercoes custem O(n) copias no total.
+static int crescerVetor(MochilaVetor* mv, int extra) {
+    if (!desmapearVetor(mv)) { // O indice tambem pode crescer logo em seguida
+        return 0;
+    }
+    if (extra > INT_MAX - mv->tamanho) {
+        return 0;
+    }
+    int necessario = mv->tamanho + extra;
+    if (necessario <= mv->capacidade) {
+        return 1;
+    }
+    int nova = capacidadeDobrada(mv->capacidade > 0 ? mv->capacidade : CAPACIDADE_INICIAL, necessario);
+    return nova > 0 && reservarVetor(mv, nova);
+}
+
+void ordenarVetor(MochilaVetor* mv); // Definida mais abaixo, junto da busca binaria
+
+// Posicao onde um item com este nome deve entrar num vetor ordenado: depois de
+// todos os nomes <= nome (assim itens de mesmo nome ficam em ordem de chegada).
+// Busca binaria; soma as comparacoes no contador do vetor.
+static int posicaoOrdenada(MochilaVetor* mv, const Item* it) {
+    int low = 0, high = mv->tamanho;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        mv->comparacoes++;
+        if (compararNomes(&mv->itens[mid], it) <= 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Insere um novo item no vetor.
+// Normalmente no final; no modo "manter ordenado", na posicao dada pela busca
+// binaria, abrindo espaco com um unico memmove (o vetor continua ordenado).
+// Retorna 1 se sucesso, 0 se falha na alocacao.
+// Complexidade: O(1) amortizado no final; O(log n) comparacoes + O(n) movimentos ordenado.
+int inserirItemVetor(MochilaVetor* mv, Item it) {
+    if (!crescerVetor(mv, 1) || !indiceReservar(&mv->indice, mv->itens, mv->tamanho, mv->tamanho + 1)
+        || !resumoReservar(&mv->resumo, it.tipo)) {
+        return 0; // Falha na alocacao
+    }
+    mv->modificacoes++;
+    if (mv->prefixos.ativa && !trieInserir(&mv->prefixos, it.nome)) {
+        return 0;
+    }
+    normalizarItem(&it);
+    int pos = mv->tamanho;
+    if (mv->manterOrdenado) {
+        pos = posicaoOrdenada(mv, &it);
+        if (pos > 0 && mv->itens[pos - 1].apagado) {
+            // A lapide logo antes tem nome <= o novo: o item ocupa o lugar dela sem deslocar nada.
+            mv->itens[pos - 1] = it;
+            mv->apagados--;
+            mv->movimentos++;
+            indiceInserir(&mv->indice, mv->itens, pos - 1);
+            resumoAjustar(&mv->resumo, it.tipo, it.quantidade, 1);
+            registrarInsercao(ESTRUTURA_VETOR, &it);
+            return 1;
+        }
+        memmove(&mv->itens[pos + 1], &mv->itens[pos], (size_t)(mv->tamanho - pos) * sizeof(Item));
+        mv->movimentos += mv->tamanho - pos + 1;
+        if (pos < mv->tamanho) {
+            indiceDeslocar(&mv->indice, pos, 1);
+        }
+    } else {
+        mv->ordenado = 0;
+    }
+    mv->itens[pos] = it;
+    indiceInserir(&mv->indice, mv->itens, pos);
+    resumoAjustar(&mv->resumo, it.tipo, it.quantidade, 1);
+    mv->tamanho++;
+    registrarInsercao(ESTRUTURA_VETOR, &it);
+    return 1;
+}
+
+// Insere n itens de uma vez no final do vetor.
+// Reserva o espaco uma unica vez e copia o lote inteiro com um memcpy.
+// Retorna 1 se sucesso, 0 se falha na alocacao (nenhum item e inserido).
+// Complexidade: O(n) amortizado para o lote.
+int inserirItensVetor(MochilaVetor* mv, const Item* itens, int n) {
+    if (n <= 0) {
+        return 1;
+    }
+    int maiorTipo = 0;
+    for (int i = 0; i < n; i++) {
+        maiorTipo = itens[i].tipo > maiorTipo ? itens[i].tipo : maiorTipo;
+    }
+    if (!crescerVetor(mv, n) || !indiceReservar(&mv->indice, mv->itens, mv->tamanho, mv->tamanho + n)
+        || !resumoReservar(&mv->resumo, maiorTipo)) {
+        return 0;
+    }
+    for (int i = 0; mv->prefixos.ativa && i < n; i++) {
+        if (!trieInserir(&mv->prefixos, itens[i].nome)) {
+            while (--i >= 0) {
+                trieRemover(&mv->prefixos, itens[i].nome); // Desfaz o lote parcial
+            }
+            return 0;
+        }
+    }
+    mv->modificacoes++;
+    memcpy(&mv->itens[mv->tamanho], itens, (size_t)n * sizeof(Item));
+    for (int i = mv->tamanho; i < mv->tamanho + n; i++) {
+        normalizarItem(&mv->itens[i]);
+        indiceInserir(&mv->indice, mv->itens, i);
+        resumoAjustar(&mv->resumo, mv->itens[i].tipo, mv->itens[i].quantidade, 1);
+        registrarInsercao(ESTRUTURA_VETOR, &mv->itens[i]);
+    }
+    mv->tamanho += n;
+    mv->ordenado = 0;
+    if (mv->manterOrdenado) {
+        ordenarVetor(mv); // Um lote grande sai mais barato reordenando de uma vez
+    }
+    return 1;
+}
+
+// Compacta o vetor numa unica passada: os itens vivos sao copiados para a frente, na
+// mesma ordem (um vetor ordenado continua ordenado), e o indice hash e refeito.
+// Complexidade: O(n + capacidade do indice).
+void compactarVetor(MochilaVetor* mv) {
+    if (mv->apagados == 0) {
+        return;
+    }
+    mv->modificacoes++;
+    int vivos = 0;
+    for (int i = 0; i < mv->tamanho; i++) {
+        if (mv->itens[i].apagado) {
+            continue;
+        }
+        if (i != vivos) {
+            mv->itens[vivos] = mv->itens[i];
+            mv->movimentos++;
+        }
+        vivos++;
+    }
+    mv->tamanho = vivos;
+    mv->apagados = 0;
+    if (mv->indice.capacidade > 0) {
+        indiceReconstruir(&mv->indice, mv->itens, mv->tamanho);
+    }
+}
+
+// Tira o item itens[pos] do diario, da trie, do indice hash e do resumo e o marca
+// como lapide. O array nao e alterado. Complexidade: O(1) esperado.
+static void apagarPosicaoVetor(MochilaVetor* mv, int pos) {
+    Item* it = &mv->itens[pos];
+    mv->modificacoes++;
+    registrarRemocao(ESTRUTURA_VETOR, it->nome);
+    if (mv->prefixos.ativa) {
+        trieRemover(&mv->prefixos, it->nome);
+    }
+    indiceRemover(&mv->indice, mv->itens, pos);
+    resumoAjustar(&mv->resumo, it->tipo, it->quantidade, -1);
+    it->apagado = 1;
+    mv->apagados++;
+}
+
+// Remove um item pelo nome, localizando-o pelo indice hash.
+// Se o vetor esta ordenado (ou ja tem lapides), deixa uma lapide no lugar do item e so
+// compacta quando as lapides passam de 1/PROPORCAO_LAPIDES das posicoes: a ordem se
+// mantem sem deslocar o resto do array a cada remocao.
+// Caso contrario, move o ultimo item para o lugar do removido.
+// Retorna 1 se removido, 0 se nao encontrado.
+// Complexidade: O(1) esperado, O(n) amortizado por compactacao a cada n/4 remocoes.
+int removerItemVetor(MochilaVetor* mv, char* nome) {
+    int sondagens;
+    int pos = indiceBuscar(&mv->indice, mv->itens, nome, &sondagens);
+    if (pos == -1) {
+        return 0;
+    }
+    apagarPosicaoVetor(mv, pos);
+    int ultimo = mv->tamanho - 1;
+    if (mv->ordenado || mv->apagados > 1) {
+        if ((long long)mv->apagados * PROPORCAO_LAPIDES > mv->tamanho) {
+            compactarVetor(mv);
+        }
+        return 1;
+    }
+    if (pos != ultimo) {
+        mv->itens[pos] = mv->itens[ultimo];
+        indiceMover(&mv->indice, mv->itens[pos].nome, ultimo, pos);
+    }
+    mv->tamanho--;
+    mv->apagados = 0;
+    return 1;
+}
+
+// Remove de uma vez um item para cada nome da lista (como chamar removerItemVetor para
+// cada um): marca as lapides pelo indice hash e compacta uma unica vez no final.
+// Retorna quantos itens foram removidos (nomes nao encontrados sao ignorados).
+// Complexidade: O(k + n) para k nomes, em vez de O(k * n) deslocando a cada remocao.
+int removerItensVetor(MochilaVetor* mv, char* nomes[], int k) {
+    int removidos = 0;
+    for (int i = 0; i < k; i++) {
+        int sondagens;
+        int pos = indiceBuscar(&mv->indice, mv->itens, nomes[i], &sondagens);
+        if (pos != -1) {
+            apagarPosicaoVetor(mv, pos);
+            removidos++;
+        }
+    }
+    compactarVetor(mv);
+    return removidos;
+}
+
+// Lista todos os itens no vetor.
+// Percorre e imprime cada item.
+// Complexidade: O(n).
+void listarVetor(MochilaVetor* mv) {
+    for (int i = 0; i < mv->tamanho; i++) {
+        if (mv->itens[i].apagado) {
+            continue;
+        }
+        printf("Nome: %s, Tipo: %s, Quantidade: %d\n", mv->itens[i].nome, nomeDoTipo(&tiposItens, mv->itens[i].tipo), mv->itens[i].quantidade);
+    }
+}
+
+// Busca sequencial por nome no vetor.
+// Conta o numero de comparacoes realizadas.
+// Retorna o indice se encontrado, -1 caso contrario.
+// Complexidade: O(n) - percorre ate encontrar ou fim.
+int buscarSequencialVetor(MochilaVetor* mv, char* nome, int* comparacoes) {
+    *comparacoes = 0;
+    for (int i = 0; i < mv->tamanho; i++) {
+        (*comparacoes)++;
+        if (strcmp(mv->itens[i].nome, nome) == 0 && !mv->itens[i].apagado) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Entrada compacta para ordenar o vetor por indices: os 8 primeiros bytes do nome
+// em big-endian (comparar inteiros = comparar strings) e a posicao do item.
+// Ocupa 16 bytes, contra os 48 de um Item, entao o Merge Sort move bem menos memoria.
+typedef struct {
+    uint64_t prefixo;
+    uint32_t indice;
+} ChaveIndice;
+
+// Compara duas entradas pelo prefixo e, so em caso de empate, pelo nome completo.
+static int compararChaves(const ChaveIndice* a, const ChaveIndice* b, const Item itens[], long long* comparacoes) {
+    (*comparacoes)++;
+    if (a->prefixo != b->prefixo) {
+        return a->prefixo < b->prefixo ? -1 : 1;
+    }
+    return compararNomesFixos(itens[a->indice].nome, itens[b->indice].nome);
+}
+
+// Merge Sort recursivo das entradas em chaves[ini..fim), usando 'aux' como area temporaria.
+// Copia so a metade esquerda e pula a intercalacao se as metades ja estao em ordem.
+static void mergeSortChaves(ChaveIndice chaves[], ChaveIndice aux[], int ini, int fim, const Item itens[], long long* comparacoes) {
+    if (fim - ini < 2) {
+        return;
+    }
+    int meio = ini + (fim - ini) / 2;
+    mergeSortChaves(chaves, aux, ini, meio, itens, comparacoes);
+    mergeSortChaves(chaves, aux, meio, fim, itens, comparacoes);
+    if (compararChaves(&chaves[meio - 1], &chaves[meio], itens, comparacoes) <= 0) {
+        return;
+    }
+    memcpy(&aux[ini], &chaves[ini], (size_t)(meio - ini) * sizeof(ChaveIndice));
+    int i = ini, j = meio, k = ini;
+    while (i < meio && j < fim) {
+        if (compararChaves(&chaves[j], &aux[i], itens, comparacoes) < 0) {
+            chaves[k++] = chaves[j++];
+        } else {
+            chaves[k++] = aux[i++]; // Empate: esquerda primeiro (estavel)
+        }
+    }
+    while (i < meio) {
+        chaves[k++] = aux[i++];
+    }
+}
+
+// Ordena o vetor por nome (estavel).
+// Ordena entradas compactas (prefixo, indice) com Merge Sort e depois aplica a
+// permutacao aos itens seguindo cada ciclo uma vez: cada Item e copiado no maximo
+// uma vez (mais uma copia por ciclo), em vez de O(n log n) copias de 48 bytes.
+// Se nao houver memoria para as entradas, usa Insertion Sort direto nos itens.
+// Soma comparacoes e itens movidos nos contadores do vetor.
+// As lapides sao descartadas antes (compactarVetor).
+// Complexidade: O(n log n) - O(n^2) apenas no caminho sem memoria.
+void ordenarVetor(MochilaVetor* mv) {
+    compactarVetor(mv);
+    mv->modificacoes++;
+    int n = mv->tamanho;
+    ESTAT_SOMAR(alocacoes, 1);
+    ChaveIndice* chaves = (ChaveIndice*)malloc((size_t)(n > 0 ? n : 1) * 2 * sizeof(ChaveIndice));
+    if (chaves) {
+        for (int i = 0; i < n; i++) {
+            chaves[i].prefixo = mv->itens[i].prefixoNome; // Ja calculado na insercao
+            chaves[i].indice = (uint32_t)i;
+        }
+        mergeSortChaves(chaves, chaves + n, 0, n, mv->itens, &mv->comparacoes);
+
+        // Aplica a permutacao: itens[i] passa a ser o antigo itens[chaves[i].indice].
+        // Cada posicao ja resolvida e marcada apontando para si mesma.
+        for (int i = 0; i < n; i++) {
+            if (chaves[i].indice == (uint32_t)i) {
+                continue;
+            }
+            Item temp = mv->itens[i];
+            int j = i;
+            while (chaves[j].indice != (uint32_t)i) {
+                int origem = (int)chaves[j].indice;
+                mv->itens[j] = mv->itens[origem];
+                chaves[j].indice = (uint32_t)j;
+                j = origem;
+                mv->movimentos++;
+            }
+            mv->itens[j] = temp;
+            chaves[j].indice = (uint32_t)j;
+            mv->movimentos += 2;
+        }
+        free(chaves);
+    } else {
+        for (int i = 1; i < n; i++) {
+            Item key = mv->itens[i];
+            int j = i - 1;
+            while (j >= 0 && (mv->comparacoes++, compararNomes(&mv->itens[j], &key) > 0)) {
+                mv->itens[j + 1] = mv->itens[j];
+                mv->movimentos++;
+                j--;
+            }
+            mv->itens[j + 1] = key;
+            mv->movimentos += 2;
+        }
+    }
+    mv->ordenado = 1;
+    if (mv->indice.capacidade > 0) {
+        indiceReconstruir(&mv->indice, mv->itens, mv->tamanho);
+    }
+}
+
+// Liga ou desliga o modo "manter ordenado".
+// Ao ligar, ordena o vetor uma vez; dali em diante insercoes e remocoes preservam a ordem
+// e a busca binaria pode ser usada a qualquer momento, sem reordenar.
+void definirManterOrdenado(MochilaVetor* mv, int ativo) {
+    if (ativo && !mv->ordenado) {
+        ordenarVetor(mv);
+    }
+    mv->manterOrdenado = ativo;
+}
+
+// Busca binaria por nome no vetor (requer ordenacao previa).
+// Conta o numero de comparacoes.
+// Retorna o indice se encontrado, -1 caso contrario.
+// Complexidade: O(log n) - muito mais eficiente que sequencial para vetores ordenados.
+int buscarBinariaVetor(MochilaVetor* mv, char* nome, int* comparacoes) {
+    Item chave;
+    montarChaveNome(&chave, nome);
+    *comparacoes = 0;
+    int low = 0;
+    int high = mv->tamanho - 1;
+    while (low <= high) {
+        (*comparacoes)++;
+        int mid = (low + high) / 2;
+        int cmp = compararNomes(&mv->itens[mid], &chave);
+        if (cmp == 0) {
+            // Pode ser uma lapide: procura um item vivo entre os de mesmo nome ao redor.
+            for (int i = mid; i >= 0 && compararNomes(&mv->itens[i], &chave) == 0; i--) {
+                if (!mv->itens[i].apagado) {
+                    return i;
+                }
+            }
+            for (int i = mid + 1; i < mv->tamanho && compararNomes(&mv->itens[i], &chave) == 0; i++) {
+                if (!mv->itens[i].apagado) {
+                    return i;
+                }
+            }
+            return -1;
+        } else if (cmp < 0) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return -1;
+}
+
+// Preenche a subarvore de raiz k do layout com os proximos itens vivos do vetor
+// ordenado, em ordem (subarvore esquerda, raiz, subarvore direita).
+// Complexidade: O(tamanho da subarvore), recursao de profundidade O(log n).
+static void preencherEytzinger(LayoutEytzinger* ez, const Item* itens, int* proximo, int k) {
+    if (k > ez->tamanho) {
+        return;
+    }
+    preencherEytzinger(ez, itens, proximo, 2 * k);
+    while (itens[*proximo].apagado) {
+        (*proximo)++;
+    }
+    ez->prefixos[k] = itens[*proximo].prefixoNome;
+    ez->posicoes[k] = (*proximo)++;
+    preencherEytzinger(ez, itens, proximo, 2 * k + 1);
+}
+
+// Monta o layout de Eytzinger a partir do vetor (que deve estar ordenado).
+// Retorna 1 se sucesso, 0 se falha na alocacao (o layout fica vazio e invalido).
+// Complexidade: O(n).
+static int montarEytzinger(LayoutEytzinger* ez, const MochilaVetor* mv) {
+    int n = mv->tamanho - mv->apagados;
+    if (n + 1 > ez->capacidade) {
+        // Potencia de 2 >= 16: o tamanho em bytes e multiplo de 64
+        int capacidade = capacidadeDobrada(ez->capacidade > 0 ? ez->capacidade : CAPACIDADE_INICIAL, n + 1);
+        free(ez->prefixos);
+        free(ez->posicoes);
+        ez->prefixos = NULL;
+        ez->posicoes = NULL;
+        if (capacidade > 0) {
+            ESTAT_SOMAR(alocacoes, 2);
+            ez->prefixos = (uint64_t*)aligned_alloc(64, (size_t)capacidade * sizeof(uint64_t));
+            ez->posicoes = (int*)malloc((size_t)capacidade * sizeof(int));
+        }
+        if (!ez->prefixos || !ez->posicoes) {
+            free(ez->prefixos);
+            free(ez->posicoes);
+            ez->prefixos = NULL;
+            ez->posicoes = NULL;
+            ez->tamanho = 0;
+            ez->capacidade = 0;
+            ez->modificacoes = -1;
+            return 0;
+        }
+        ez->capacidade = capacidade;
+    }
+    ez->tamanho = n;
+    int proximo = 0;
+    preencherEytzinger(ez, mv->itens, &proximo, 1);
+    ez->modificacoes = mv->modificacoes;
+    return 1;
+}
+
+// Busca por nome no layout de Eytzinger do vetor (requer ordenacao previa, como a binaria).
+// O layout e montado na primeira busca depois de cada alteracao do vetor e reaproveitado
+// pelas seguintes. A descida so compara prefixos de 8 bytes e nao tem desvio que dependa
+// deles (o proximo no e 2k + (prefixo < chave)), e a cada passo pede a linha de cache dos
+// descendentes tres niveis abaixo. No fim, k volta ao primeiro prefixo >= chave e os itens
+// do vetor com esse prefixo (quase sempre um) sao conferidos pelo nome inteiro.
+// Conta o numero de comparacoes.
+// Retorna o indice se encontrado, -1 caso contrario (ou se faltar memoria para o layout).
+// Complexidade: O(log n), mais O(n) para montar o layout depois de uma alteracao.
+int buscarEytzingerVetor(MochilaVetor* mv, char* nome, int* comparacoes) {
+    *comparacoes = 0;
+    LayoutEytzinger* ez = &mv->eytzinger;
+    if (ez->modificacoes != mv->modificacoes && !montarEytzinger(ez, mv)) {
+        return -1;
+    }
+    Item chave;
+    montarChaveNome(&chave, nome);
+    unsigned int k = 1;
+    while (k <= (unsigned int)ez->tamanho) {
+        __builtin_prefetch(ez->prefixos + 8 * (size_t)k);
+        (*comparacoes)++;
+        k = 2 * k + (ez->prefixos[k] < chave.prefixoNome);
+    }
+    k >>= __builtin_ffs((int)~k); // Desfaz as descidas a direita depois da ultima a esquerda
+    if (k == 0) {
+        return -1; // Todos os prefixos sao menores que o da chave
+    }
+    for (int i = ez->posicoes[k]; i < mv->tamanho && mv->itens[i].prefixoNome == chave.prefixoNome; i++) {
+        (*comparacoes)++;
+        if (!mv->itens[i].apagado && compararNomes(&mv->itens[i], &chave) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Busca por nome no vetor usando o indice hash (nao requer ordenacao).
+// Conta o numero de sondagens na tabela como comparacoes.
+// Retorna o indice se encontrado, -1 caso contrario.
+// Complexidade: O(1) esperado.
+int buscarHashVetor(MochilaVetor* mv, char* nome, int* comparacoes) {
+    return indiceBuscar(&mv->indice, mv->itens, nome, comparacoes);
+}
+
+// Liga ou desliga o indice de prefixos do vetor.
+// Ao ligar, monta a trie com os nomes atuais; dali em diante insercoes e remocoes a mantem.
+// Retorna 1 se sucesso, 0 se falha na alocacao (o indice fica desligado).
+// Complexidade: O(n * tamanho do nome) ao ligar.
+int definirIndicePrefixos(MochilaVetor* mv, int ativo) {
+    liberarTrie(&mv->prefixos);
+    if (!ativo) {
+        return 1;
+    }
+    for (int i = 0; i < mv->tamanho; i++) {
+        if (!mv->itens[i].apagado && !trieInserir(&mv->prefixos, mv->itens[i].nome)) {
+            liberarTrie(&mv->prefixos);
+            return 0;
+        }
+    }
+    mv->prefixos.ativa = 1;
+    return 1;
+}
+
+// Acrescenta em posicoes[] (ate 'maximo') as posicoes dos itens com exatamente este nome,
+// percorrendo a sequencia de sondagem do indice hash. Retorna o novo total de encontrados.
+static int coletarPosicoesNome(const MochilaVetor* mv, const char* nome, int posicoes[], int maximo, int encontrados) {
+    const IndiceHash* ih = &mv->indice;
+    unsigned int mascara = (unsigned int)ih->capacidade - 1;
+    unsigned int h = hashNome(nome);
+    for (unsigned int i = h & mascara; ih->slots[i].posicao != -1; i = (i + 1) & mascara) {
+        if (ih->slots[i].hash == h && strcmp(mv->itens[ih->slots[i].posicao].nome, nome) == 0) {
+            if (encontrados < maximo) {
+                posicoes[encontrados] = ih->slots[i].posicao;
+            }
+            encontrados++;
+        }
+    }
+    return encontrados;
+}
+
+// Percorre a subarvore de 'no' em ordem alfabetica; 'nome' ja contem os 'tamanho' bytes ate ele.
+// Depois de 'maximo' posicoes so soma os totais das subarvores restantes, sem desce-las.
+static int coletarSubarvore(const MochilaVetor* mv, int no, char nome[], int tamanho, int posicoes[], int maximo, int encontrados) {
+    const TriePrefixos* t = &mv->prefixos;
+    if (encontrados >= maximo) {
+        return encontrados + t->nos[no].total;
+    }
+    if (t->nos[no].contagem > 0) {
+        nome[tamanho] = '\0';
+        encontrados = coletarPosicoesNome(mv, nome, posicoes, maximo, encontrados);
+    }
+    for (int f = t->nos[no].filho; f != -1; f = t->nos[f].irmao) {
+        memcpy(nome + tamanho, t->nos[f].rotulo, t->nos[f].tamanho);
+        encontrados = coletarSubarvore(mv, f, nome, tamanho + t->nos[f].tamanho, posicoes, maximo, encontrados);
+    }
+    return encontrados;
+}
+
+// Busca por prefixo: posicoes dos itens cujo nome comeca com 'prefixo'.
+// Com o indice de prefixos ligado, desce a trie pelo prefixo e percorre so a subarvore
+// encontrada (resultados em ordem alfabetica); desligado, compara item a item.
+// Preenche ate 'maximo' posicoes e retorna o total de itens encontrados (pode passar de maximo).
+// Complexidade: O(tamanho do prefixo + min(resultados, maximo)) com a trie; O(n) sem ela.
+int buscarPrefixoVetor(MochilaVetor* mv, const char* prefixo, int posicoes[], int maximo) {
+    size_t tamPrefixo = strlen(prefixo);
+    int encontrados = 0;
+    if (!mv->prefixos.ativa) {
+        for (int i = 0; i < mv->tamanho; i++) {
+            if (strncmp(mv->itens[i].nome, prefixo, tamPrefixo) == 0 && !mv->itens[i].apagado) {
+                if (encontrados < maximo) {
+                    posicoes[encontrados] = i;
+                }
+                encontrados++;
+            }
+        }
+        return encontrados;
+    }
+    const TriePrefixos* t = &mv->prefixos;
+    if (t->quantidade == 0 || tamPrefixo >= sizeof(mv->itens[0].nome)) {
+        return 0;
+    }
+    char nome[sizeof(mv->itens[0].nome) + ROTULO_TRIE];
+    int tamanho = 0;
+    int no = 0;
+    const char* resto = prefixo;
+    while (*resto) {
+        int anterior;
+        int filho = filhoTrie(t, no, (unsigned char)*resto, &anterior);
+        if (filho == -1) {
+            return 0;
+        }
+        size_t restante = strlen(resto);
+        size_t comparar = restante < t->nos[filho].tamanho ? restante : t->nos[filho].tamanho;
+        if (memcmp(resto, t->nos[filho].rotulo, comparar) != 0) {
+            return 0;
+        }
+        memcpy(nome + tamanho, t->nos[filho].rotulo, t->nos[filho].tamanho);
+        tamanho += t->nos[filho].tamanho;
+        resto += comparar;
+        no = filho;
+    }
+    return coletarSubarvore(mv, no, nome, tamanho, posicoes, maximo, 0);
+}
+
+// Funcoes de arquivo (snapshot binario da mochila em vetor)
+//
+// Layout do arquivo, na ordem nativa da maquina (o cabecalho confere tamanhos e versao):
+//   CabecalhoArquivo | itens (n * Item) | tipos (t * 20 bytes) | indice (capacidade * SlotHash)
+// Cada secao comeca alinhada a 64 bytes. Os itens e o indice sao gravados exatamente
+// como estao na memoria, entao carregar e so mapear o arquivo e apontar para eles.
+#define MAGICA_ARQUIVO "MOCHILA"
+#define VERSAO_ARQUIVO 2 // 2: Item com o byte de lapide
+#define VERSAO_SEM_LAPIDE 1 // Ainda lida: mesmo layout, mas o byte da lapide era preenchimento
+#define ALINHAMENTO_SECAO 64
+
+typedef struct {
+    char magica[8];
+    uint32_t versao;
+    uint32_t tamanhoCabecalho;
+    uint32_t tamanhoItem;
+    uint32_t tamanhoSlot;
+    uint32_t quantidade;       // Itens no arquivo
+    uint32_t quantidadeTipos;  // Entradas do dicionario de tipos
+    uint32_t capacidadeIndice; // Slots do indice hash (potencia de 2, ou 0)
+    uint32_t ordenado;         // 1 se os itens estao ordenados por nome
+    uint64_t inicioItens;
+    uint64_t inicioTipos;
+    uint64_t inicioIndice;
+    uint64_t tamanhoTotal;
+    uint64_t soma;             // Soma de verificacao das tres secoes
+} CabecalhoArquivo;
+
+// Soma de verificacao estilo Fletcher sobre palavras de 64 bits (dois acumuladores:
+// detecta bytes trocados, zerados ou fora de ordem). Pode ser continuada secao a secao.
+typedef struct {
+    uint64_t a;
+    uint64_t b;
+} SomaVerificacao;
+
+static void acumularSoma(SomaVerificacao* soma, const void* dados, size_t tamanho) {
+    const unsigned char* p = (const unsigned char*)dados;
+    uint64_t a = soma->a, b = soma->b;
+    size_t i = 0;
+    for (; i + 8 <= tamanho; i += 8) {
+        uint64_t palavra;
+        memcpy(&palavra, p + i, 8);
+        a += palavra;
+        b += a;
+    }
+    for (; i < tamanho; i++) {
+        a += p[i];
+        b += a;
+    }
+    soma->a = a;
+    soma->b = b;
+}
+
+static uint64_t alinharSecao(uint64_t deslocamento) {
+    return (deslocamento + ALINHAMENTO_SECAO - 1) & ~(uint64_t)(ALINHAMENTO_SECAO - 1);
+}
+
+// A secao [inicio, inicio + bytes) termina ate 'limite'? Compara por subtracao:
+// um cabecalho adulterado nao consegue dar a volta na soma de 64 bits.
+static int secaoCabe(uint64_t inicio, uint64_t bytes, uint64_t limite) {
+    return inicio <= limite && bytes <= limite - inicio;
+}
+
+// Grava 'tamanho' bytes em 'arquivo' na posicao 'deslocamento', completando com zeros
+// a partir da posicao atual. Retorna 1 se sucesso, 0 se falha de escrita.
+static int gravarSecao(FILE* arquivo, long* posicao, uint64_t deslocamento, const void* dados, size_t tamanho) {
+    static const char zeros[ALINHAMENTO_SECAO] = { 0 };
+    while ((uint64_t)*posicao < deslocamento) {
+        size_t falta = (size_t)(deslocamento - (uint64_t)*posicao);
+        size_t parte = falta < sizeof(zeros) ? falta : sizeof(zeros);
+        if (fwrite(zeros, 1, parte, arquivo) != parte) {
+            return 0;
+        }
+        *posicao += (long)parte;
+    }
+    if (tamanho > 0 && fwrite(dados, 1, tamanho, arquivo) != tamanho) {
+        return 0;
+    }
+    *posicao += (long)tamanho;
+    return 1;
+}
+
+// Salva o vetor (itens, dicionario de tipos e indice hash) em 'caminho'.
+// Grava primeiro em "<caminho>.tmp", faz fsync e so entao renomeia por cima do
+// arquivo antigo: uma queda no meio da gravacao nunca deixa um snapshot pela metade.
+// Retorna 1 se sucesso, 0 se falha de escrita.
+// Complexidade: O(n + t + capacidade do indice).
+int salvarVetor(const MochilaVetor* mv, const char* caminho) {
+    CabecalhoArquivo cab;
+    memset(&cab, 0, sizeof(cab));
+    memcpy(cab.magica, MAGICA_ARQUIVO, sizeof(MAGICA_ARQUIVO));
+    cab.versao = VERSAO_ARQUIVO;
+    cab.tamanhoCabecalho = sizeof(CabecalhoArquivo);
+    cab.tamanhoItem = sizeof(Item);
+    cab.tamanhoSlot = sizeof(SlotHash);
+    cab.quantidade = (uint32_t)mv->tamanho;
+    cab.quantidadeTipos = (uint32_t)tiposItens.quantidade;
+    cab.capacidadeIndice = (uint32_t)mv->indice.capacidade;
+    cab.ordenado = (uint32_t)mv->ordenado;
+    size_t bytesItens = (size_t)mv->tamanho * sizeof(Item);
+    size_t bytesTipos = (size_t)tiposItens.quantidade * sizeof(tiposItens.nomes[0]);
+    size_t bytesIndice = (size_t)mv->indice.capacidade * sizeof(SlotHash);
+    cab.inicioItens = alinharSecao(sizeof(CabecalhoArquivo));
+    cab.inicioTipos = alinharSecao(cab.inicioItens + bytesItens);
+    cab.inicioIndice = alinharSecao(cab.inicioTipos + bytesTipos);
+    cab.tamanhoTotal = cab.inicioIndice + bytesIndice;
+    SomaVerificacao soma = { 0, 0 };
+    acumularSoma(&soma, mv->itens, bytesItens);
+    acumularSoma(&soma, tiposItens.nomes, bytesTipos);
+    acumularSoma(&soma, mv->indice.slots, bytesIndice);
+    cab.soma = soma.a ^ (soma.b * 0x9E3779B97F4A7C15ull);
+
+    char temporario[512];
+    if (snprintf(temporario, sizeof(temporario), "%s.tmp", caminho) >= (int)sizeof(temporario)) {
+        return 0;
+    }
+    FILE* arquivo = fopen(temporario, "wb");
+    if (!arquivo) {
+        return 0;
+    }
+    long posicao = 0;
+    int ok = gravarSecao(arquivo, &posicao, 0, &cab, sizeof(cab))
+          && gravarSecao(arquivo, &posicao, cab.inicioItens, mv->itens, bytesItens)
+          && gravarSecao(arquivo, &posicao, cab.inicioTipos, tiposItens.nomes, bytesTipos)
+          && gravarSecao(arquivo, &posicao, cab.inicioIndice, mv->indice.slots, bytesIndice)
+          && fflush(arquivo) == 0
+          && fsync(fileno(arquivo)) == 0;
+    if (fclose(arquivo) != 0) {
+        ok = 0;
+    }
+    if (!ok || rename(temporario, caminho) != 0) {
+        remove(temporario);
+        return 0;
+    }
+    return 1;
+}
+
+// Carrega em 'mv' o snapshot gravado por salvarVetor, substituindo o conteudo atual.
+// O arquivo e mapeado com mmap e os itens e o indice sao usados no proprio mapeamento:
+// nao ha leitura nem conversao item a item, so a conferencia da soma de verificacao.
+// Os tipos do arquivo entram no dicionario do programa; se algum receber outro id,
+// os itens sao renumerados (unico caso com trabalho por item).
+// Arquivos da versao 1 (antes das lapides) tambem sao aceitos: os itens entram com
+// apagado = 0 e o proximo salvarVetor ja grava a versao atual.
+// Retorna 1 se sucesso, 0 se o arquivo nao existe, e de outra versao/maquina ou esta corrompido
+// (nesses casos nem 'mv' nem o dicionario sao alterados).
+// Complexidade: O(n) para a soma de verificacao, sem copias.
+int carregarVetor(MochilaVetor* mv, const char* caminho) {
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(CabecalhoArquivo)) {
+        close(fd);
+        return 0;
+    }
+    size_t tamanhoMapa = (size_t)info.st_size;
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE; // Le o arquivo de uma vez em vez de uma falta de pagina por vez
+#endif
+    // Mapeia so para leitura: com MAP_POPULATE e escrita, o kernel copiaria cada pagina
+    // ja na carga. A escrita e liberada depois (cada pagina so e copiada se for alterada).
+    void* mapa = mmap(NULL, tamanhoMapa, PROT_READ, flags, fd, 0);
+    close(fd); // O mapeamento continua valido sem o descritor
+    if (mapa == MAP_FAILED) {
+        return 0;
+    }
+    if (mprotect(mapa, tamanhoMapa, PROT_READ | PROT_WRITE) != 0) {
+        munmap(mapa, tamanhoMapa);
+        return 0;
+    }
+
+    const unsigned char* base = (const unsigned char*)mapa;
+    const CabecalhoArquivo* cab = (const CabecalhoArquivo*)mapa;
+    size_t bytesItens = (size_t)cab->quantidade * sizeof(Item);
+    size_t bytesTipos = (size_t)cab->quantidadeTipos * sizeof(tiposItens.nomes[0]);
+    size_t bytesIndice = (size_t)cab->capacidadeIndice * sizeof(SlotHash);
+    int valido = memcmp(cab->magica, MAGICA_ARQUIVO, sizeof(MAGICA_ARQUIVO)) == 0
+              && (cab->versao == VERSAO_ARQUIVO || cab->versao == VERSAO_SEM_LAPIDE)
+              && cab->tamanhoCabecalho == sizeof(CabecalhoArquivo)
+              && cab->tamanhoItem == sizeof(Item)
+              && cab->tamanhoSlot == sizeof(SlotHash)
+              && cab->tamanhoTotal == tamanhoMapa
+              && cab->quantidade <= (uint32_t)INT32_MAX / 2
+              && cab->quantidadeTipos <= MAX_TIPOS
+              && (cab->capacidadeIndice & (cab->capacidadeIndice - 1)) == 0
+              && cab->capacidadeIndice >= 2 * cab->quantidade
+              && cab->inicioItens % ALINHAMENTO_SECAO == 0 && cab->inicioIndice % ALINHAMENTO_SECAO == 0
+              && cab->inicioItens >= sizeof(CabecalhoArquivo)
+              && secaoCabe(cab->inicioItens, bytesItens, cab->inicioTipos)
+              && secaoCabe(cab->inicioTipos, bytesTipos, cab->inicioIndice)
+              && secaoCabe(cab->inicioIndice, bytesIndice, tamanhoMapa)
+              && bytesIndice == tamanhoMapa - cab->inicioIndice;
+    if (valido) {
+        SomaVerificacao soma = { 0, 0 };
+        acumularSoma(&soma, base + cab->inicioItens, bytesItens);
+        acumularSoma(&soma, base + cab->inicioTipos, bytesTipos);
+        acumularSoma(&soma, base + cab->inicioIndice, bytesIndice);
+        valido = cab->soma == (soma.a ^ (soma.b * 0x9E3779B97F4A7C15ull));
+    }
+
+    // Traduz os ids de tipo do arquivo para os do dicionario do programa. Os tipos novos
+    // entram em uma copia do dicionario, que so substitui tiposItens se o arquivo for aceito.
+    DicionarioTipos tipos;
+    initDicionario(&tipos);
+    valido = valido && copiarDicionario(&tipos, &tiposItens);
+    uint8_t novoId[MAX_TIPOS];
+    int identidade = 1;
+    const char (*tiposArquivo)[20] = (const char (*)[20])(base + cab->inicioTipos);
+    for (uint32_t i = 0; valido && i < cab->quantidadeTipos; i++) {
+        char tipo[20];
+        memcpy(tipo, tiposArquivo[i], sizeof(tipo));
+        tipo[sizeof(tipo) - 1] = '\0';
+        int id = internarTipo(&tipos, tipo);
+        valido = id != -1;
+        novoId[i] = (uint8_t)id;
+        identidade = identidade && id == (int)i;
+    }
+    Item* itens = (Item*)(base + cab->inicioItens);
+    int apagados = 0;
+    int semLapide = cab->versao == VERSAO_SEM_LAPIDE;
+    for (uint32_t i = 0; valido && i < cab->quantidade; i++) {
+        if (semLapide) {
+            itens[i].apagado = 0; // Na versao 1 o byte pode conter lixo de preenchimento
+        }
+        apagados += itens[i].apagado != 0;
+        if (itens[i].tipo >= cab->quantidadeTipos) {
+            valido = 0;
+        } else if (!identidade) {
+            itens[i].tipo = novoId[itens[i].tipo];
+        }
+    }
+    const SlotHash* slots = (const SlotHash*)(base + cab->inicioIndice);
+    for (uint32_t i = 0; valido && i < cab->capacidadeIndice; i++) {
+        valido = slots[i].posicao >= -1 && slots[i].posicao < (int)cab->quantidade;
+    }
+    ResumoMochila resumo;
+    initResumo(&resumo);
+    if (!valido || !reconstruirResumo(&resumo, itens, (int)cab->quantidade)) {
+        liberarDicionario(&tipos);
+        munmap(mapa, tamanhoMapa);
+        return 0;
+    }
+    liberarDicionario(&tiposItens);
+    tiposItens = tipos;
+    int comPrefixos = mv->prefixos.ativa;
+    liberarVetor(mv);
+    mv->resumo = resumo;
+    mv->itens = itens;
+    mv->tamanho = (int)cab->quantidade;
+    mv->apagados = apagados;
+    mv->capacidade = (int)cab->quantidade;
+    mv->ordenado = (int)cab->ordenado;
+    mv->indice.slots = cab->capacidadeIndice > 0 ? (SlotHash*)(base + cab->inicioIndice) : NULL;
+    mv->indice.capacidade = (int)cab->capacidadeIndice;
+    mv->indice.ocupados = (int)cab->quantidade - apagados;
+    mv->mapa = mapa;
+    mv->tamanhoMapa = tamanhoMapa;
+    if (comPrefixos) {
+        definirIndicePrefixos(mv, 1); // Se faltar memoria o vetor segue valido, so sem o indice
+    }
+    return 1;
+}
+
+// Funcoes para PoolNos
+
+// Inicializa o pool vazio.
+void initPool(PoolNos* pool) {
+    pool->blocos = NULL;
+    pool->usadosNoBloco = NOS_POR_BLOCO; // Forca a alocacao de um bloco no primeiro pedido
+    pool->livres = NULL;
+    pool->chamadasMalloc = 0;
+    pool->nosEntregues = 0;
+    pool->nosReciclados = 0;
+}
+
+// Entrega um no: primeiro da lista de livres, depois do bloco atual,
+// e so entao aloca um bloco novo.
+// Retorna NULL se falha na alocacao.
+// Complexidade: O(1).
+No* alocarNo(PoolNos* pool) {
+    No* no;
+    if (pool->livres) {
+        no = pool->livres;
+        pool->livres = no->proximo;
+        pool->nosReciclados++;
+    } else {
+        if (pool->usadosNoBloco == NOS_POR_BLOCO) {
+            ESTAT_SOMAR(alocacoes, 1);
+            BlocoNos* bloco = (BlocoNos*)malloc(sizeof(BlocoNos));
+            if (!bloco) {
+                return NULL;
+            }
+            pool->chamadasMalloc++;
+            bloco->proximo = pool->blocos;
+            pool->blocos = bloco;
+            pool->usadosNoBloco = 0;
+        }
+        no = &pool->blocos->nos[pool->usadosNoBloco++];
+    }
+    pool->nosEntregues++;
+    return no;
+}
+
+// Devolve um no ao pool para ser reaproveitado.
+// Complexidade: O(1).
+void liberarNo(PoolNos* pool, No* no) {
+    no->proximo = pool->livres;
+    pool->livres = no;
+}
+
+// Libera todos os blocos do pool de uma vez.
+// Complexidade: O(blocos) - nao percorre os nos individualmente.
+void liberarPool(PoolNos* pool) {
+    BlocoNos* bloco = pool->blocos;
+    while (bloco) {
+        BlocoNos* temp = bloco;
+        bloco = bloco->proximo;
+        free(temp);
+    }
+    initPool(pool);
+}
+
+// Funcoes para MochilaLista
+
+// Inicializa a mochila lista, definindo inicio como NULL.
+void initLista(MochilaLista* ml) {
+    ml->inicio = NULL;
+    initPool(&ml->pool);
+    initResumo(&ml->resumo);
+}
+
+// Libera todos os nos da lista devolvendo os blocos do pool.
+// Complexidade: O(blocos).
+void liberarLista(MochilaLista* ml) {
+    liberarPool(&ml->pool);
+    liberarResumo(&ml->resumo);
+    ml->inicio = NULL;
+}
+
+// Insere um novo item no inicio da lista (para simplicidade e eficiencia).
+// Obtem o novo no do pool (reaproveitando nos removidos quando possivel).
+// Retorna 1 se sucesso, 0 se falha na alocacao.
+// Complexidade: O(1) - insercao constante, vantagem sobre vetor em casos de redimensionamento.
+int inserirItemLista(MochilaLista* ml, Item it) {
+    if (!resumoReservar(&ml->resumo, it.tipo)) {
+        return 0;
+    }
+    No* novo = alocarNo(&ml->pool);
+    if (!novo) {
+        return 0; // Falha na alocacao
+    }
+    novo->dados = it;
+    novo->proximo = ml->inicio;
+    ml->inicio = novo;
+    resumoAjustar(&ml->resumo, it.tipo, it.quantidade, 1);
+    registrarInsercao(ESTRUTURA_LISTA, &it);
+    return 1;
+}
+
+// Remove um item pelo nome.
+// Percorre a lista, ajusta ponteiros e devolve o no ao pool.
+// Retorna 1 se removido, 0 se nao encontrado.
+// Complexidade: O(n) - similar ao vetor, mas sem deslocamento de elementos.
+int removerItemLista(MochilaLista* ml, char* nome) {
+    No* atual = ml->inicio;
+    No* prev = NULL;
+    while (atual) {
+        if (strcmp(atual->dados.nome, nome) == 0) {
+            if (prev) {
+                prev->proximo = atual->proximo;
+            } else {
+                ml->inicio = atual->proximo;
+            }
+            registrarRemocao(ESTRUTURA_LISTA, nome);
+            resumoAjustar(&ml->resumo, atual->dados.tipo, atual->dados.quantidade, -1);
+            liberarNo(&ml->pool, atual);
+            return 1;
+        }
+        prev = atual;
+        atual = atual->proximo;
+    }
+    return 0;
+}
+
+// Lista todos os itens na lista.
+// Percorre e imprime cada item.
+// Complexidade: O(n).
+void listarLista(MochilaLista* ml) {
+    No* atual = ml->inicio;
+    while (atual) {
+        printf("Nome: %s, Tipo: %s, Quantidade: %d\n", atual->dados.nome, nomeDoTipo(&tiposItens, atual->dados.tipo), atual->dados.quantidade);
+        atual = atual->proximo;
+    }
+}
+
+// Busca sequencial por nome na lista.
+// Conta o numero de comparacoes.
+// Retorna a posicao (comecando de 0) se encontrado, -1 caso contrario.
+// Complexidade: O(n) - percorre ate encontrar ou fim.
+int buscarSequencialLista(MochilaLista* ml, char* nome, int* comparacoes) {
+    *comparacoes = 0;
+    No* atual = ml->inicio;
+    int pos = 0;
+    while (atual) {
+        (*comparacoes)++;
+        if (strcmp(atual->dados.nome, nome) == 0) {
+            return pos;
+        }
+        pos++;
+        atual = atual->proximo;
+    }
+    return -1;
+}
+
+// Funcoes de repeticao e compactacao do diario
+
+// O arquivo 'caminho' realmente nao existe? (e nao so falhou ao abrir por outro motivo)
+static int arquivoAusente(const char* caminho) {
+    struct stat info;
+    return stat(caminho, &info) != 0 && errno == ENOENT;
+}
+
+// Renomeia 'caminho' para "<caminho>.corrompido", tirando-o do caminho da recuperacao
+// sem perder o conteudo. Retorna 1 se renomeou ou se o arquivo nao existe, 0 se falhou.
+int separarCorrompido(const char* caminho) {
+    char destino[300];
+    snprintf(destino, sizeof(destino), "%s.corrompido", caminho);
+    if (rename(caminho, destino) == 0) {
+        printf("%s guardado como %s.\n", caminho, destino);
+        return 1;
+    }
+    return errno == ENOENT;
+}
+
+// Soma de verificacao gravada no cabecalho do snapshot em 'caminho'.
+// Retorna 0 se o arquivo nao existe ou nao e um snapshot.
+uint64_t somaSnapshot(const char* caminho) {
+    FILE* arquivo = fopen(caminho, "rb");
+    if (!arquivo) {
+        return 0;
+    }
+    CabecalhoArquivo cab;
+    int ok = fread(&cab, sizeof(cab), 1, arquivo) == 1 && memcmp(cab.magica, MAGICA_ARQUIVO, sizeof(MAGICA_ARQUIVO)) == 0;
+    fclose(arquivo);
+    return ok ? cab.soma : 0;
+}
+
+// Repete o diario 'caminho' sobre mv e ml (mv ja carregado do snapshot). Deve ser
+// chamada com o diario global fechado, para nao registrar de novo o que repete.
+// Registros do vetor so sao aplicados se o cabecalho aponta para o snapshot carregado
+// ('somaSnapshot'): se a queda aconteceu entre gravar o snapshot novo e trocar o diario,
+// essas operacoes ja estao no snapshot. Os da lista sempre sao aplicados, pois o diario
+// e o unico lugar onde a lista e guardada.
+// Para no primeiro registro cortado ou corrompido (a cauda de uma gravacao interrompida).
+// Retorna o numero de registros aplicados, 0 se o diario nao existe, -1 se e invalido.
+// Complexidade: O(r) registros, cada um com o custo da insercao/remocao correspondente.
+long long repetirDiario(const char* caminho, uint64_t somaSnapshot, MochilaVetor* mv, MochilaLista* ml) {
+    FILE* arquivo = fopen(caminho, "rb");
+    if (!arquivo) {
+        return 0;
+    }
+    unsigned char* dados = NULL;
+    long tamanho = -1;
+    if (fseek(arquivo, 0, SEEK_END) == 0 && (tamanho = ftell(arquivo)) >= (long)sizeof(CabecalhoDiario)) {
+        dados = (unsigned char*)malloc((size_t)tamanho);
+        rewind(arquivo);
+        if (dados && fread(dados, 1, (size_t)tamanho, arquivo) != (size_t)tamanho) {
+            free(dados);
+            dados = NULL;
+        }
+    }
+    fclose(arquivo);
+    if (!dados) {
+        return -1;
+    }
+    CabecalhoDiario cab;
+    memcpy(&cab, dados, sizeof(cab));
+    if (memcmp(cab.magica, MAGICA_DIARIO, sizeof(MAGICA_DIARIO)) != 0 || cab.versao != VERSAO_DIARIO) {
+        free(dados);
+        return -1;
+    }
+    int aplicarVetor = cab.somaSnapshot == somaSnapshot;
+
+    long long aplicados = 0;
+    size_t pos = sizeof(CabecalhoDiario);
+    while (pos < (size_t)tamanho) {
+        const unsigned char* p = dados + pos;
+        size_t resta = (size_t)tamanho - pos;
+        size_t tamReg = p[0];
+        if (tamReg < 13 || tamReg > resta) {
+            break;
+        }
+        uint32_t soma;
+        memcpy(&soma, p + tamReg - 4, 4);
+        size_t tamNome = p[7];
+        if (soma != somaRegistro(p, tamReg - 4) || tamNome > 29 || 13 + tamNome > tamReg || 13 + tamNome + p[8 + tamNome] != tamReg) {
+            break;
+        }
+        size_t tamTipo = p[8 + tamNome];
+        Item it;
+        memset(&it, 0, sizeof(it));
+        memcpy(it.nome, p + 8, tamNome);
+        memcpy(&it.quantidade, p + 3, 4);
+        char tipo[20] = { 0 };
+        memcpy(tipo, p + 9 + tamNome, tamTipo);
+        pos += tamReg;
+
+        if (p[2] == ESTRUTURA_VETOR && !aplicarVetor) {
+            continue;
+        }
+        if (p[1] == OPERACAO_INSERIR) {
+            int id = internarTipo(&tiposItens, tipo);
+            if (id == -1) {
+                continue;
+            }
+            it.tipo = (uint8_t)id;
+            if (p[2] == ESTRUTURA_VETOR) {
+                inserirItemVetor(mv, it);
+            } else if (p[2] == ESTRUTURA_LISTA) {
+                inserirItemLista(ml, it);
+            }
+        } else if (p[1] == OPERACAO_REMOVER) {
+            if (p[2] == ESTRUTURA_VETOR) {
+                removerItemVetor(mv, it.nome);
+            } else if (p[2] == ESTRUTURA_LISTA) {
+                removerItemLista(ml, it.nome);
+            }
+        }
+        aplicados++;
+    }
+    free(dados);
+    return aplicados;
+}
+
+// Compacta o diario d: grava o vetor em 'snapshot' e troca o diario por um novo, que
+// aponta para esse snapshot e contem so a lista atual (como insercoes, do ultimo no para
+// o primeiro, para a repeticao recriar a mesma ordem).
+// Os dois arquivos novos sao gravados ao lado dos antigos e so entao renomeados, snapshot
+// primeiro: uma queda entre os dois renames deixa o snapshot novo com o diario antigo, que
+// a repeticao reconhece pela soma (pula o vetor e refaz so a lista).
+// Retorna 1 se sucesso, 0 se falha (snapshot e diario antigos continuam valendo).
+// Complexidade: O(n + m) para n itens no vetor e m na lista.
+int compactarDiario(Diario* d, const char* snapshot, const MochilaVetor* mv, const MochilaLista* ml) {
+    char snapshotNovo[300];
+    char diarioNovo[300];
+    snprintf(snapshotNovo, sizeof(snapshotNovo), "%s.novo", snapshot);
+    snprintf(diarioNovo, sizeof(diarioNovo), "%s.novo", d->caminho);
+    confirmarDiario(d);
+    if (!salvarVetor(mv, snapshotNovo)) {
+        return 0;
+    }
+    uint64_t soma = somaSnapshot(snapshotNovo);
+
+    int m = 0;
+    for (const No* no = ml->inicio; no; no = no->proximo) {
+        m++;
+    }
+    const Item** itensLista = (const Item**)malloc((size_t)(m > 0 ? m : 1) * sizeof(const Item*));
+    remove(diarioNovo);
+    Diario novo = { .fd = -1 };
+    int ok = itensLista && abrirDiario(&novo, diarioNovo, TAMANHO_BUFFER_DIARIO, soma);
+    if (ok) {
+        m = 0;
+        for (const No* no = ml->inicio; no; no = no->proximo) {
+            itensLista[m++] = &no->dados;
+        }
+        for (int i = m - 1; i >= 0; i--) {
+            acrescentarRegistro(&novo, OPERACAO_INSERIR, ESTRUTURA_LISTA, itensLista[i]->nome, nomeDoTipo(&tiposItens, itensLista[i]->tipo), itensLista[i]->quantidade);
+        }
+        fecharDiario(&novo);
+        ok = novo.falhas == 0;
+    }
+    free(itensLista);
+    if (!ok || rename(snapshotNovo, snapshot) != 0 || rename(diarioNovo, d->caminho) != 0) {
+        remove(snapshotNovo);
+        remove(diarioNovo);
+        return 0;
+    }
+
+    // O descritor antigo aponta para o arquivo substituido: reabre o novo.
+    char caminho[256];
+    memcpy(caminho, d->caminho, sizeof(caminho));
+    if (d->fd >= 0) {
+        close(d->fd);
+    }
+    d->compactacoes++;
+    return abrirDiario(d, caminho, d->intervalo, soma);
+}
+
+// Funcoes para MochilaDesenrolada
+
+// Inicializa a mochila desenrolada vazia.
+void initDesenrolada(MochilaDesenrolada* md) {
+    md->inicio = NULL;
+    md->tamanho = 0;
+    initResumo(&md->resumo);
+}
+
+// Libera todos os blocos da lista desenrolada.
+// Complexidade: O(n / ITENS_POR_BLOCO).
+void liberarDesenrolada(MochilaDesenrolada* md) {
+    NoDesenrolado* atual = md->inicio;
+    while (atual) {
+        NoDesenrolado* temp = atual;
+        atual = atual->proximo;
+        free(temp);
+    }
+    liberarResumo(&md->resumo);
+    initDesenrolada(md);
+}
+
+// Insere um item na posicao 'pos' (0 = inicio, tamanho = fim).
+// Localiza o bloco pulando blocos inteiros. Se o bloco estiver cheio, uma insercao
+// numa das pontas abre um bloco novo ao lado (mantendo os blocos cheios) e uma
+// insercao no meio divide o bloco ao meio. So desloca itens dentro de um bloco.
+// Retorna 1 se sucesso, 0 se falha na alocacao ou posicao invalida.
+// Complexidade: O(n / ITENS_POR_BLOCO + ITENS_POR_BLOCO).
+int inserirItemDesenroladaPos(MochilaDesenrolada* md, int pos, Item it) {
+    if (pos < 0 || pos > md->tamanho || !resumoReservar(&md->resumo, it.tipo)) {
+        return 0;
+    }
+    // Encontra o bloco que contem a posicao (ou o ultimo, se pos == tamanho).
+    NoDesenrolado* anterior = NULL;
+    NoDesenrolado* bloco = md->inicio;
+    while (bloco && pos > bloco->usados && bloco->proximo) {
+        pos -= bloco->usados;
+        anterior = bloco;
+        bloco = bloco->proximo;
+    }
+
+    if (!bloco || bloco->usados == ITENS_POR_BLOCO) {
+        ESTAT_SOMAR(alocacoes, 1);
+        NoDesenrolado* novo = (NoDesenrolado*)malloc(sizeof(NoDesenrolado));
+        if (!novo) {
+            return 0; // Falha na alocacao
+        }
+        novo->usados = 0;
+        if (!bloco || pos == 0) {
+            // Bloco novo antes do atual (ou primeiro bloco da lista).
+            novo->proximo = bloco;
+            if (anterior) {
+                anterior->proximo = novo;
+            } else {
+                md->inicio = novo;
+            }
+            bloco = novo;
+        } else if (pos == ITENS_POR_BLOCO) {
+            // Bloco novo depois do atual.
+            novo->proximo = bloco->proximo;
+            bloco->proximo = novo;
+            bloco = novo;
+            pos = 0;
+        } else {
+            int metade = ITENS_POR_BLOCO / 2;
+            novo->usados = ITENS_POR_BLOCO - metade;
+            memcpy(novo->itens, &bloco->itens[metade], (size_t)novo->usados * sizeof(Item));
+            bloco->usados = metade;
+            novo->proximo = bloco->proximo;
+            bloco->proximo = novo;
+            if (pos > metade) {
+                pos -= metade;
+                bloco = novo;
+            }
+        }
+    }
+
+    memmove(&bloco->itens[pos + 1], &bloco->itens[pos], (size_t)(bloco->usados - pos) * sizeof(Item));
+    bloco->itens[pos] = it;
+    bloco->usados++;
+    md->tamanho++;
+    resumoAjustar(&md->resumo, it.tipo, it.quantidade, 1);
+    return 1;
+}
+
+// Insere um novo item no inicio da lista desenrolada (mesma ordem da lista encadeada).
+// Retorna 1 se sucesso, 0 se falha na alocacao.
+// Complexidade: O(ITENS_POR_BLOCO).
+int inserirItemDesenrolada(MochilaDesenrolada* md, Item it) {
+    return inserirItemDesenroladaPos(md, 0, it);
+}
+
+// Remove um item pelo nome.
+// Fecha o buraco dentro do bloco; blocos vazios sao liberados e um bloco que
+// fica com menos da metade e fundido ao seguinte quando os dois cabem em um.
+// Retorna 1 se removido, 0 se nao encontrado.
+// Complexidade: O(n) - percorre ate encontrar, desloca no maximo um bloco.
+int removerItemDesenrolada(MochilaDesenrolada* md, char* nome) {
+    NoDesenrolado* anterior = NULL;
+    NoDesenrolado* bloco = md->inicio;
+    while (bloco) {
+        for (int i = 0; i < bloco->usados; i++) {
+            if (strcmp(bloco->itens[i].nome, nome) == 0) {
+                resumoAjustar(&md->resumo, bloco->itens[i].tipo, bloco->itens[i].quantidade, -1);
+                memmove(&bloco->itens[i], &bloco->itens[i + 1], (size_t)(bloco->usados - i - 1) * sizeof(Item));
+                bloco->usados--;
+                md->tamanho--;
+
+                if (bloco->usados == 0) {
+                    if (anterior) {
+                        anterior->proximo = bloco->proximo;
+                    } else {
+                        md->inicio = bloco->proximo;
+                    }
+                    free(bloco);
+                } else if (bloco->usados < ITENS_POR_BLOCO / 2 && bloco->proximo &&
+                           bloco->usados + bloco->proximo->usados <= ITENS_POR_BLOCO) {
+                    NoDesenrolado* seguinte = bloco->proximo;
+                    memcpy(&bloco->itens[bloco->usados], seguinte->itens, (size_t)seguinte->usados * sizeof(Item));
+                    bloco->usados += seguinte->usados;
+                    bloco->proximo = seguinte->proximo;
+                    free(seguinte);
+                }
+                return 1;
+            }
+        }
+        anterior = bloco;
+        bloco = bloco->proximo;
+    }
+    return 0;
+}
+
+// Lista todos os itens da lista desenrolada.
+// Complexidade: O(n).
+void listarDesenrolada(MochilaDesenrolada* md) {
+    for (NoDesenrolado* bloco = md->inicio; bloco; bloco = bloco->proximo) {
+        for (int i = 0; i < bloco->usados; i++) {
+            printf("Nome: %s, Tipo: %s, Quantidade: %d\n", bloco->itens[i].nome, nomeDoTipo(&tiposItens, bloco->itens[i].tipo), bloco->itens[i].quantidade);
+        }
+    }
+}
+
+// Busca sequencial por nome na lista desenrolada.
+// Conta o numero de comparacoes.
+// Retorna a posicao (comecando de 0) se encontrado, -1 caso contrario.
+// Complexidade: O(n) - mas com um salto de ponteiro a cada ITENS_POR_BLOCO itens.
+int buscarSequencialDesenrolada(MochilaDesenrolada* md, char* nome, int* comparacoes) {
+    *comparacoes = 0;
+    int pos = 0;
+    for (NoDesenrolado* bloco = md->inicio; bloco; bloco = bloco->proximo) {
+        for (int i = 0; i < bloco->usados; i++) {
+            (*comparacoes)++;
+            if (strcmp(bloco->itens[i].nome, nome) == 0) {
+                return pos + i;
+            }
+        }
+        pos += bloco->usados;
+    }
+    return -1;
+}
+
+// Funcoes para MochilaSkip
+
+// Inicializa a skip list vazia, sem memoria alocada.
+void initSkip(MochilaSkip* mk) {
+    for (int k = 0; k < NIVEL_MAXIMO_SKIP; k++) {
+        mk->cabeca[k] = NULL;
+    }
+    mk->nivel = 1;
+    mk->tamanho = 0;
+    mk->semente = 2463534242u;
+    mk->comparacoes = 0;
+    initResumo(&mk->resumo);
+}
+
+// Libera todos os nos percorrendo o nivel 0.
+// Complexidade: O(n).
+void liberarSkip(MochilaSkip* mk) {
+    NoSkip* atual = mk->cabeca[0];
+    while (atual) {
+        NoSkip* temp = atual;
+        atual = atual->proximo[0];
+        free(temp);
+    }
+    liberarResumo(&mk->resumo);
+    initSkip(mk);
+}
+
+// Sorteia o numero de niveis de um no novo: 1, e mais um enquanto sair 1 em 4.
+static int sortearNivelSkip(MochilaSkip* mk) {
+    unsigned int x = mk->semente; // xorshift32
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    mk->semente = x;
+    int nivel = 1;
+    while (nivel < NIVEL_MAXIMO_SKIP && (x & 3) == 0) {
+        nivel++;
+        x >>= 2;
+    }
+    return nivel;
+}
+
+// Desce os niveis a partir do topo procurando o primeiro no com nome >= chave
+// (estrito = 0) ou > chave (estrito = 1). anteriores[k] recebe o endereco do ponteiro
+// do nivel k que aponta para esse no (na cabeca ou no ultimo no menor do nivel).
+// Conta as comparacoes em *comparacoes.
+static void localizarSkip(MochilaSkip* mk, const Item* chave, int estrito, NoSkip** anteriores[], long long* comparacoes) {
+    NoSkip** proximos = mk->cabeca;
+    for (int k = mk->nivel - 1; k >= 0; k--) {
+        while (proximos[k]) {
+            (*comparacoes)++;
+            int cmp = compararNomes(&proximos[k]->dados, chave);
+            if (cmp > 0 || (!estrito && cmp == 0)) {
+                break;
+            }
+            proximos = proximos[k]->proximo;
+        }
+        anteriores[k] = &proximos[k];
+    }
+}
+
+// Insere um item na posicao dada pelo nome (depois dos itens de mesmo nome,
+// que assim ficam em ordem de chegada). Nenhum item existente e movido.
+// Retorna 1 se sucesso, 0 se falha na alocacao.
+// Complexidade: O(log n) esperado.
+int inserirItemSkip(MochilaSkip* mk, Item it) {
+    int nivel = sortearNivelSkip(mk);
+    ESTAT_SOMAR(alocacoes, 1);
+    NoSkip* novo = (NoSkip*)malloc(sizeof(NoSkip) + (size_t)nivel * sizeof(NoSkip*));
+    if (!novo || !resumoReservar(&mk->resumo, it.tipo)) {
+        free(novo);
+        return 0; // Falha na alocacao
+    }
+    normalizarItem(&it);
+    novo->dados = it;
+    novo->nivel = nivel;
+
+    NoSkip** anteriores[NIVEL_MAXIMO_SKIP];
+    localizarSkip(mk, &novo->dados, 1, anteriores, &mk->comparacoes);
+    for (int k = mk->nivel; k < nivel; k++) {
+        anteriores[k] = &mk->cabeca[k]; // Niveis novos comecam na cabeca
+    }
+    if (nivel > mk->nivel) {
+        mk->nivel = nivel;
+    }
+    for (int k = 0; k < nivel; k++) {
+        novo->proximo[k] = *anteriores[k];
+        *anteriores[k] = novo;
+    }
+    mk->tamanho++;
+    resumoAjustar(&mk->resumo, it.tipo, it.quantidade, 1);
+    return 1;
+}
+
+// Remove o primeiro item com o nome dado, religando os ponteiros de cada nivel do no.
+// Retorna 1 se removido, 0 se nao encontrado.
+// Complexidade: O(log n) esperado.
+int removerItemSkip(MochilaSkip* mk, char* nome) {
+    Item chave;
+    montarChaveNome(&chave, nome);
+    NoSkip** anteriores[NIVEL_MAXIMO_SKIP];
+    localizarSkip(mk, &chave, 0, anteriores, &mk->comparacoes);
+    NoSkip* alvo = *anteriores[0];
+    if (!alvo) {
+        return 0;
+    }
+    mk->comparacoes++;
+    if (compararNomes(&alvo->dados, &chave) != 0) {
+        return 0;
+    }
+    // O alvo e o primeiro no >= chave em todos os niveis que ele ocupa.
+    for (int k = 0; k < alvo->nivel; k++) {
+        *anteriores[k] = alvo->proximo[k];
+    }
+    while (mk->nivel > 1 && !mk->cabeca[mk->nivel - 1]) {
+        mk->nivel--;
+    }
+    resumoAjustar(&mk->resumo, alvo->dados.tipo, alvo->dados.quantidade, -1);
+    free(alvo);
+    mk->tamanho--;
+    return 1;
+}
+
+// Busca por nome descendo os niveis.
+// Conta o numero de comparacoes.
+// Retorna o item encontrado, ou NULL se nao existe.
+// Complexidade: O(log n) esperado.
+const Item* buscarItemSkip(MochilaSkip* mk, char* nome, int* comparacoes) {
+    Item chave;
+    montarChaveNome(&chave, nome);
+    NoSkip** anteriores[NIVEL_MAXIMO_SKIP];
+    long long contador = 0;
+    localizarSkip(mk, &chave, 0, anteriores, &contador);
+    NoSkip* achado = *anteriores[0];
+    if (achado) {
+        contador++;
+        if (compararNomes(&achado->dados, &chave) != 0) {
+            achado = NULL;
+        }
+    }
+    *comparacoes = (int)contador;
+    return achado ? &achado->dados : NULL;
+}
+
+// Busca sequencial por nome no nivel 0 (para comparacao com as demais estruturas).
+// Conta o numero de comparacoes.
+// Retorna a posicao (comecando de 0) se encontrado, -1 caso contrario.
+// Complexidade: O(n).
+int buscarSequencialSkip(MochilaSkip* mk, char* nome, int* comparacoes) {
+    *comparacoes = 0;
+    int pos = 0;
+    for (NoSkip* atual = mk->cabeca[0]; atual; atual = atual->proximo[0], pos++) {
+        (*comparacoes)++;
+        if (strcmp(atual->dados.nome, nome) == 0) {
+            return pos;
+        }
+    }
+    return -1;
+}
+
+// Lista todos os itens em ordem alfabetica (nivel 0).
+// Complexidade: O(n).
+void listarSkip(MochilaSkip* mk) {
+    for (NoSkip* atual = mk->cabeca[0]; atual; atual = atual->proximo[0]) {
+        printf("Nome: %s, Tipo: %s, Quantidade: %d\n", atual->dados.nome, nomeDoTipo(&tiposItens, atual->dados.tipo), atual->dados.quantidade);
+    }
+}
+
+// Funcoes para MochilaSoA
+
+// Inicializa a mochila colunar vazia.
+void initSoA(MochilaSoA* ms) {
+    ms->nomes = NULL;
+    ms->tipos = NULL;
+    ms->quantidades = NULL;
+    ms->tamanho = 0;
+    ms->capacidade = 0;
+    initResumo(&ms->resumo);
+}
+
+// Libera todos os arrays da mochila colunar.
+void liberarSoA(MochilaSoA* ms) {
+    free(ms->nomes);
+    free(ms->tipos);
+    free(ms->quantidades);
+    liberarResumo(&ms->resumo);
+    initSoA(ms);
+}
+
+// Garante espaco para mais um item em todas as colunas (capacidade dobra).
+// Cada coluna e realocada separadamente; a capacidade so muda quando todas conseguem.
+// Retorna 1 se sucesso, 0 se falha na alocacao.
+static int crescerSoA(MochilaSoA* ms) {
+    if (ms->tamanho < ms->capacidade) {
+        return 1;
+    }
+    int nova = capacidadeDobrada(ms->capacidade > 0 ? ms->capacidade : CAPACIDADE_INICIAL, ms->capacidade + 1);
+    if (nova < 0) {
+        return 0;
+    }
+    ESTAT_SOMAR(alocacoes, 1);
+    char (*nomes)[30] = realloc(ms->nomes, (size_t)nova * sizeof(*nomes));
+    if (!nomes) {
+        return 0;
+    }
+    ms->nomes = nomes;
+    ESTAT_SOMAR(alocacoes, 1);
+    uint8_t* tipos = (uint8_t*)realloc(ms->tipos, (size_t)nova * sizeof(uint8_t));
+    if (!tipos) {
+        return 0;
+    }
+    ms->tipos = tipos;
+    ESTAT_SOMAR(alocacoes, 1);
+    int* quantidades = (int*)realloc(ms->quantidades, (size_t)nova * sizeof(int));
+    if (!quantidades) {
+        return 0;
+    }
+    ms->quantidades = quantidades;
+    ms->capacidade = nova;
+    return 1;
+}
+
+// Insere um item no final das colunas.
+// Retorna 1 se sucesso, 0 se falha na alocacao.
+// Complexidade: O(1) amortizado.
+int inserirItemSoA(MochilaSoA* ms, Item it) {
+    if (!crescerSoA(ms) || !resumoReservar(&ms->resumo, it.tipo)) {
+        return 0;
+    }
+    memcpy(ms->nomes[ms->tamanho], it.nome, sizeof(ms->nomes[0]));
+    ms->tipos[ms->tamanho] = it.tipo;
+    ms->quantidades[ms->tamanho] = it.quantidade;
+    ms->tamanho++;
+    resumoAjustar(&ms->resumo, it.tipo, it.quantidade, 1);
+    return 1;
+}
+
+// Busca sequencial por nome; so a coluna de nomes e percorrida.
+// Conta o numero de comparacoes.
+// Retorna o indice se encontrado, -1 caso contrario.
+// Complexidade: O(n).
+int buscarSequencialSoA(MochilaSoA* ms, char* nome, int* comparacoes) {
+    *comparacoes = 0;
+    for (int i = 0; i < ms->tamanho; i++) {
+        (*comparacoes)++;
+        if (strcmp(ms->nomes[i], nome) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Remove um item pelo nome, movendo o ultimo para o lugar dele em cada coluna.
+// Retorna 1 se removido, 0 se nao encontrado.
+// Complexidade: O(n) para achar o item, O(1) para remover.
+int removerItemSoA(MochilaSoA* ms, char* nome) {
+    int comparacoes;
+    int pos = buscarSequencialSoA(ms, nome, &comparacoes);
+    if (pos == -1) {
+        return 0;
+    }
+    resumoAjustar(&ms->resumo, ms->tipos[pos], ms->quantidades[pos], -1);
+    int ultimo = ms->tamanho - 1;
+    memcpy(ms->nomes[pos], ms->nomes[ultimo], sizeof(ms->nomes[0]));
+    ms->tipos[pos] = ms->tipos[ultimo];
+    ms->quantidades[pos] = ms->quantidades[ultimo];
+    ms->tamanho--;
+    return 1;
+}
+
+// Lista todos os itens, remontando cada linha a partir das colunas.
+void listarSoA(MochilaSoA* ms) {
+    for (int i = 0; i < ms->tamanho; i++) {
+        printf("Nome: %s, Tipo: %s, Quantidade: %d\n", ms->nomes[i], nomeDoTipo(&tiposItens, ms->tipos[i]), ms->quantidades[i]);
+    }
+}
+
+// Consultas de filtro/agregacao. As versoes colunares sao lacos sem desvios sobre
+// arrays contiguos de inteiros, que o compilador vetoriza (SSE2/AVX2 com -O2/-O3);
+// as versoes do vetor fazem o mesmo calculo sobre o array de Item para comparacao.
+
+// Soma de todas as quantidades (ex.: total de municao na mochila).
+// Complexidade: O(n), lendo 4 bytes por item.
+long long somarQuantidadesSoA(const MochilaSoA* ms) {
+    long long soma = 0;
+    for (int i = 0; i < ms->tamanho; i++) {
+        soma += ms->quantidades[i];
+    }
+    return soma;
+}
+
+// Soma das quantidades dos itens de um tipo; o filtro e so a igualdade de um id de 1 byte.
+// Complexidade: O(t) para achar o id + O(n), lendo 5 bytes por item.
+long long somarQuantidadesTipoSoA(const MochilaSoA* ms, const char* tipo) {
+    int id = buscarTipo(&tiposItens, tipo);
+    if (id == -1) {
+        return 0;
+    }
+    long long soma = 0;
+    for (int i = 0; i < ms->tamanho; i++) {
+        soma += (ms->tipos[i] == id) ? ms->quantidades[i] : 0;
+    }
+    return soma;
+}
+
+// Quantos itens tem quantidade >= minimo.
+// Complexidade: O(n), lendo 4 bytes por item.
+int contarQuantidadeMinimaSoA(const MochilaSoA* ms, int minimo) {
+    int total = 0;
+    for (int i = 0; i < ms->tamanho; i++) {
+        total += ms->quantidades[i] >= minimo;
+    }
+    return total;
+}
+
+// Escreve em 'posicoes' os indices dos itens com quantidade >= minimo (sem desvios:
+// toda posicao e escrita e o contador so avanca quando o item passa no filtro).
+// 'posicoes' precisa ter espaco para o tamanho da mochila.
+// Retorna quantos itens passaram. Complexidade: O(n).
+int filtrarQuantidadeMinimaSoA(const MochilaSoA* ms, int minimo, int posicoes[]) {
+    int k = 0;
+    for (int i = 0; i < ms->tamanho; i++) {
+        posicoes[k] = i;
+        k += ms->quantidades[i] >= minimo;
+    }
+    return k;
+}
+
+// Soma de todas as quantidades no vetor de Item (lapides nao contam).
+long long somarQuantidadesVetor(const MochilaVetor* mv) {
+    long long soma = 0;
+    for (int i = 0; i < mv->tamanho; i++) {
+        soma += mv->itens[i].apagado ? 0 : mv->itens[i].quantidade;
+    }
+    return soma;
+}
+
+// Soma das quantidades de um tipo no vetor de Item (mesmo filtro por id, lendo o Item inteiro).
+long long somarQuantidadesTipoVetor(const MochilaVetor* mv, const char* tipo) {
+    int id = buscarTipo(&tiposItens, tipo);
+    if (id == -1) {
+        return 0;
+    }
+    long long soma = 0;
+    for (int i = 0; i < mv->tamanho; i++) {
+        soma += (mv->itens[i].tipo == id && !mv->itens[i].apagado) ? mv->itens[i].quantidade : 0;
+    }
+    return soma;
+}
+
+// Quantos itens do vetor tem quantidade >= minimo.
+int contarQuantidadeMinimaVetor(const MochilaVetor* mv, int minimo) {
+    int total = 0;
+    for (int i = 0; i < mv->tamanho; i++) {
+        total += mv->itens[i].quantidade >= minimo && !mv->itens[i].apagado;
+    }
+    return total;
+}
+
+// Loja de mochilas por jogador (acesso concorrente)
+//
+// Uma MochilaVetor por jogador, encontrada pelo id. Os jogadores sao repartidos em
+// NUM_SHARDS shards pelo hash do id; cada shard tem sua tabela (encadeada) e sua
+// trava leitor-escritor. Buscas de jogadores em shards diferentes nunca se esperam, e
+// buscas no mesmo shard rodam juntas (trava de leitura); so insercoes e remocoes
+// travam o shard para escrita.
+// O dicionario de tipos e global e nao tem trava: os tipos usados pelas threads devem
+// ser internados antes. As mochilas da loja nunca vao para o diario (ele so e aberto
+// no modo interativo, que nao usa a loja).
+#define NUM_SHARDS 64 // Potencia de 2
+#define BALDES_INICIAIS 16
+
+typedef struct JogadorMochila {
+    int id;
+    MochilaVetor mochila;
+    struct JogadorMochila* proximo;
+} JogadorMochila;
+
+// Alinhado a 64 bytes para que as travas de shards vizinhos nao dividam linha de cache.
+typedef struct {
+    _Alignas(64) pthread_rwlock_t trava;
+    JogadorMochila** baldes;
+    int numBaldes; // Potencia de 2
+    int quantidade;
+} ShardLoja;
+
+typedef struct {
+    ShardLoja shards[NUM_SHARDS];
+} LojaMochilas;
+
+// Espalha os bits do id (ids sequenciais cairiam em shards e baldes vizinhos).
+static unsigned int hashJogador(int id) {
+    unsigned int h = (unsigned int)id * 2654435761u;
+    return h ^ (h >> 16);
+}
+
+static ShardLoja* shardDe(LojaMochilas* loja, int id, unsigned int* h) {
+    *h = hashJogador(id);
+    return &loja->shards[*h & (NUM_SHARDS - 1)];
+}
+
+// Jogador 'id' no shard s, ou NULL. Chamada com a trava do shard (leitura ou escrita).
+static JogadorMochila* procurarJogador(const ShardLoja* s, int id, unsigned int h) {
+    JogadorMochila* j = s->baldes[(h / NUM_SHARDS) & (unsigned int)(s->numBaldes - 1)];
+    while (j && j->id != id) {
+        j = j->proximo;
+    }
+    return j;
+}
+
+// Inicializa a loja vazia.
+// Retorna 1 se sucesso, 0 se falha na alocacao ou ao criar uma trava
+// (nesse caso desfaz os shards ja prontos e a loja nao precisa ser liberada).
+int initLoja(LojaMochilas* loja) {
+    for (int i = 0; i < NUM_SHARDS; i++) {
+        ShardLoja* s = &loja->shards[i];
+        s->numBaldes = BALDES_INICIAIS;
+        s->quantidade = 0;
+        s->baldes = (JogadorMochila**)calloc(BALDES_INICIAIS, sizeof(JogadorMochila*));
+        if (!s->baldes || pthread_rwlock_init(&s->trava, NULL) != 0) {
+            free(s->baldes);
+            s->baldes = NULL;
+            while (--i >= 0) {
+                free(loja->shards[i].baldes);
+                loja->shards[i].baldes = NULL;
+                pthread_rwlock_destroy(&loja->shards[i].trava);
+            }
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Libera todas as mochilas e a loja (sem threads usando a loja).
+void liberarLoja(LojaMochilas* loja) {
+    for (int i = 0; i < NUM_SHARDS; i++) {
+        ShardLoja* s = &loja->shards[i];
+        for (int b = 0; s->baldes && b < s->numBaldes; b++) {
+            JogadorMochila* j = s->baldes[b];
+            while (j) {
+                JogadorMochila* proximo = j->proximo;
+                liberarVetor(&j->mochila);
+                free(j);
+                j = proximo;
+            }
+        }
+        free(s->baldes);
+        s->baldes = NULL;
+        pthread_rwlock_destroy(&s->trava);
+    }
+}
+
+// Dobra a tabela do shard quando passa de 1 jogador por balde. Chamada com a trava de escrita.
+static void crescerShard(ShardLoja* s) {
+    int novo = s->numBaldes * 2;
+    JogadorMochila** baldes = (JogadorMochila**)calloc((size_t)novo, sizeof(JogadorMochila*));
+    if (!baldes) {
+        return; // Segue com cadeias mais longas
+    }
+    for (int b = 0; b < s->numBaldes; b++) {
+        JogadorMochila* j = s->baldes[b];
+        while (j) {
+            JogadorMochila* proximo = j->proximo;
+            unsigned int pos = (hashJogador(j->id) / NUM_SHARDS) & (unsigned int)(novo - 1);
+            j->proximo = baldes[pos];
+            baldes[pos] = j;
+            j = proximo;
+        }
+    }
+    free(s->baldes);
+    s->baldes = baldes;
+    s->numBaldes = novo;
+}
+
+// Insere um item na mochila do jogador, criando a mochila se o jogador e novo.
+// Retorna 1 se sucesso, 0 se falha na alocacao.
+// Complexidade: O(1) esperado (mais a insercao no vetor); trava o shard para escrita.
+int lojaInserirItem(LojaMochilas* loja, int jogador, Item it) {
+    unsigned int h;
+    ShardLoja* s = shardDe(loja, jogador, &h);
+    pthread_rwlock_wrlock(&s->trava);
+    JogadorMochila* j = procurarJogador(s, jogador, h);
+    if (!j) {
+        ESTAT_SOMAR(alocacoes, 1);
+        j = (JogadorMochila*)malloc(sizeof(JogadorMochila));
+        if (!j) {
+            pthread_rwlock_unlock(&s->trava);
+            return 0;
+        }
+        j->id = jogador;
+        initVetor(&j->mochila);
+        unsigned int pos = (h / NUM_SHARDS) & (unsigned int)(s->numBaldes - 1);
+        j->proximo = s->baldes[pos];
+        s->baldes[pos] = j;
+        if (++s->quantidade > s->numBaldes) {
+            crescerShard(s);
+        }
+    }
+    int ok = inserirItemVetor(&j->mochila, it);
+    pthread_rwlock_unlock(&s->trava);
+    return ok;
+}
+
+// Remove um item da mochila do jogador.
+// Retorna 1 se removido, 0 se o jogador ou o item nao existe.
+int lojaRemoverItem(LojaMochilas* loja, int jogador, char* nome) {
+    unsigned int h;
+    ShardLoja* s = shardDe(loja, jogador, &h);
+    pthread_rwlock_wrlock(&s->trava);
+    JogadorMochila* j = procurarJogador(s, jogador, h);
+    int ok = j && removerItemVetor(&j->mochila, nome);
+    pthread_rwlock_unlock(&s->trava);
+    return ok;
+}
+
+// Busca um item na mochila do jogador pelo indice hash e copia-o para 'saida'
+// (um ponteiro para dentro da mochila nao valeria depois de soltar a trava).
+// Retorna 1 se encontrado, 0 caso contrario.
+// Complexidade: O(1) esperado; trava o shard so para leitura.
+int lojaBuscarItem(LojaMochilas* loja, int jogador, char* nome, Item* saida) {
+    unsigned int h;
+    ShardLoja* s = shardDe(loja, jogador, &h);
+    pthread_rwlock_rdlock(&s->trava);
+    JogadorMochila* j = procurarJogador(s, jogador, h);
+    int sondagens;
+    int pos = j ? buscarHashVetor(&j->mochila, nome, &sondagens) : -1;
+    if (pos != -1) {
+        *saida = j->mochila.itens[pos];
+    }
+    pthread_rwlock_unlock(&s->trava);
+    return pos != -1;
+}
+
+// Quantidade de itens na mochila do jogador (0 se o jogador nao existe).
+int lojaTamanhoMochila(LojaMochilas* loja, int jogador) {
+    unsigned int h;
+    ShardLoja* s = shardDe(loja, jogador, &h);
+    pthread_rwlock_rdlock(&s->trava);
+    JogadorMochila* j = procurarJogador(s, jogador, h);
+    int tamanho = j ? j->mochila.tamanho - j->mochila.apagados : 0;
+    pthread_rwlock_unlock(&s->trava);
+    return tamanho;
+}
+
+// Remove o jogador e libera a sua mochila.
+// Retorna 1 se removido, 0 se o jogador nao existe.
+int lojaRemoverJogador(LojaMochilas* loja, int jogador) {
+    unsigned int h;
+    ShardLoja* s = shardDe(loja, jogador, &h);
+    pthread_rwlock_wrlock(&s->trava);
+    JogadorMochila** p = &s->baldes[(h / NUM_SHARDS) & (unsigned int)(s->numBaldes - 1)];
+    while (*p && (*p)->id != jogador) {
+        p = &(*p)->proximo;
+    }
+    JogadorMochila* j = *p;
+    if (j) {
+        *p = j->proximo;
+        s->quantidade--;
+    }
+    pthread_rwlock_unlock(&s->trava);
+    if (!j) {
+        return 0;
+    }
+    liberarVetor(&j->mochila);
+    free(j);
+    return 1;
+}
+
+// Funcao auxiliar para ler um item do usuario.
+// O tipo digitado e convertido no id do dicionario de tipos; 'tipoNovo' diz se ele
+// acabou de entrar no dicionario (e deve ser descartado se a insercao falhar).
+// Retorna 1 se sucesso, 0 se o tipo nao coube no dicionario.
+int lerItem(Item* it, int* tipoNovo) {
+    char tipo[20];
+    printf("Digite o nome do item: ");
+    scanf("%29s", it->nome);
+    printf("Digite o tipo do item: ");
+    scanf("%19s", tipo);
+    printf("Digite a quantidade: ");
+    scanf("%d", &it->quantidade);
+    *tipoNovo = buscarTipo(&tiposItens, tipo) == -1;
+    int id = internarTipo(&tiposItens, tipo);
+    if (id == -1) {
+        return 0;
+    }
+    it->tipo = (uint8_t)id;
+    return 1;
+}
+
+// Funcao auxiliar para ler um nome.
+void lerNome(char* nome) {
+    printf("Digite o nome do item: ");
+    scanf("%s", nome);
+}
+
+#define MAX_RESULTADOS_PREFIXO 50 // Itens mostrados na busca por prefixo do menu
+
+// Menu principal para operacoes em uma estrutura especifica.
+// Parametro estrutura: vetor, lista encadeada, lista desenrolada ou colunar.
+void menuOperacoes(MochilaVetor* mv, MochilaLista* ml, MochilaDesenrolada* md, MochilaSoA* ms, MochilaSkip* mk, Estrutura estrutura) {
+    int opcao;
+    do {
+        printf("\nMenu de Operacoes:\n");
+        printf("1. Inserir item\n");
+        printf("2. Remover item\n");
+        printf("3. Listar itens\n");
+        printf("4. Buscar sequencial\n");
+        if (estrutura == ESTRUTURA_VETOR) {
+            printf("5. Ordenar vetor\n");
+            printf("6. Buscar binaria (requer ordenacao%s)\n", mv->manterOrdenado ? " - sempre ordenado" : "");
+            printf("7. Buscar por hash (indice de nomes)\n");
+            printf("9. %s modo manter ordenado\n", mv->manterOrdenado ? "Desativar" : "Ativar");
+            printf("10. Contadores de manutencao da ordem\n");
+            printf("12. Salvar mochila em arquivo\n");
+            printf("13. Carregar mochila de arquivo\n");
+            printf("15. Buscar por prefixo do nome (autocompletar)\n");
+            printf("16. Remover varios itens de uma vez\n");
+            printf("17. Buscar no layout de Eytzinger (requer ordenacao)\n");
+        } else if (estrutura == ESTRUTURA_LISTA) {
+            printf("8. Estatisticas de alocacao\n");
+        } else if (estrutura == ESTRUTURA_SKIP) {
+            printf("6. Buscar na skip list (O(log n), sempre ordenada)\n");
+            printf("10. Contadores de manutencao da ordem\n");
+        }
+        if (estrutura == ESTRUTURA_VETOR || estrutura == ESTRUTURA_LISTA) {
+            printf("14. Compactar diario de operacoes (grava o snapshot %s)\n", ARQUIVO_SNAPSHOT);
+        }
+        printf("11. Totais de quantidade (geral, por tipo, acima de um minimo)\n");
+        printf("0. Voltar\n");
+        printf("Escolha: ");
+        scanf("%d", &opcao);
+
+        Item it;
+        char nome[30];
+        int comparacoes;
+        int resultado;
+        int sucesso;
+        int tipoNovo;
+        int minimo;
+        char caminho[256];
+        int posicoes[MAX_RESULTADOS_PREFIXO];
+        uint64_t inicioOp;
+        // O vetor e a skip list ja acumulam comparacoes e movimentos da manutencao
+        // da ordem; as estatisticas recebem o quanto eles avancaram nesta opcao.
+        long long comparacoesAntes = mv->comparacoes + mk->comparacoes;
+        long long movimentosAntes = mv->movimentos;
+
+        switch (opcao) {
+            case 1:
+                if (!lerItem(&it, &tipoNovo)) {
+                    printf("Limite de %d tipos atingido.\n", MAX_TIPOS);
+                    break;
+                }
+                ESTAT_INICIAR(inicioOp);
+                if (estrutura == ESTRUTURA_VETOR) {
+                    sucesso = inserirItemVetor(mv, it);
+                } else if (estrutura == ESTRUTURA_LISTA) {
+                    sucesso = inserirItemLista(ml, it);
+                } else if (estrutura == ESTRUTURA_SOA) {
+                    sucesso = inserirItemSoA(ms, it);
+                } else if (estrutura == ESTRUTURA_SKIP) {
+                    sucesso = inserirItemSkip(mk, it);
+                } else {
+                    sucesso = inserirItemDesenrolada(md, it);
+                }
+                ESTAT_REGISTRAR(OP_INSERIR, inicioOp);
+                if (sucesso) {
+                    printf("Item inserido com sucesso.\n");
+                } else {
+                    if (tipoNovo) {
+                        descartarTipo(&tiposItens, it.tipo); // O tipo so fica se o item entrou
+                    }
+                    printf("Falha na alocacao.\n");
+                }
+                break;
+            case 2:
+                lerNome(nome);
+                ESTAT_INICIAR(inicioOp);
+                if (estrutura == ESTRUTURA_VETOR) {
+                    sucesso = removerItemVetor(mv, nome);
+                } else if (estrutura == ESTRUTURA_LISTA) {
+                    sucesso = removerItemLista(ml, nome);
+                } else if (estrutura == ESTRUTURA_SOA) {
+                    sucesso = removerItemSoA(ms, nome);
+                } else if (estrutura == ESTRUTURA_SKIP) {
+                    sucesso = removerItemSkip(mk, nome);
+                } else {
+                    sucesso = removerItemDesenrolada(md, nome);
+                }
+                ESTAT_REGISTRAR(OP_REMOVER, inicioOp);
+                if (sucesso) {
+                    printf("Item removido.\n");
+                } else {
+                    printf("Item nao encontrado.\n");
+                }
+                break;
+            case 3:
+                if (estrutura == ESTRUTURA_VETOR) {
+                    listarVetor(mv);
+                } else if (estrutura == ESTRUTURA_LISTA) {
+                    listarLista(ml);
+                } else if (estrutura == ESTRUTURA_SOA) {
+                    listarSoA(ms);
+                } else if (estrutura == ESTRUTURA_SKIP) {
+                    listarSkip(mk);
+                } else {
+                    listarDesenrolada(md);
+                }
+                break;
+            case 4:
+                lerNome(nome);
+                ESTAT_INICIAR(inicioOp);
+                if (estrutura == ESTRUTURA_VETOR) {
+                    resultado = buscarSequencialVetor(mv, nome, &comparacoes);
+                } else if (estrutura == ESTRUTURA_LISTA) {
+                    resultado = buscarSequencialLista(ml, nome, &comparacoes);
+                } else if (estrutura == ESTRUTURA_SOA) {
+                    resultado = buscarSequencialSoA(ms, nome, &comparacoes);
+                } else if (estrutura == ESTRUTURA_SKIP) {
+                    resultado = buscarSequencialSkip(mk, nome, &comparacoes);
+                } else {
+                    resultado = buscarSequencialDesenrolada(md, nome, &comparacoes);
+                }
+                ESTAT_REGISTRAR(OP_BUSCAR, inicioOp);
+                ESTAT_SOMAR(comparacoes, comparacoes);
+                if (resultado != -1) {
+                    printf("Item encontrado na posicao %d.\n", resultado);
+                } else {
+                    printf("Item nao encontrado.\n");
+                }
+                printf("Numero de comparacoes: %d\n", comparacoes);
+                break;
+            case 5:
+                if (estrutura == ESTRUTURA_VETOR) {
+                    ESTAT_INICIAR(inicioOp);
+                    ordenarVetor(mv);
+                    ESTAT_REGISTRAR(OP_ORDENAR, inicioOp);
+                    printf("Vetor ordenado por nome.\n");
+                }
+                break;
+            case 6:
+                if (estrutura == ESTRUTURA_VETOR) {
+                    lerNome(nome);
+                    ESTAT_INICIAR(inicioOp);
+                    resultado = buscarBinariaVetor(mv, nome, &comparacoes);
+                    ESTAT_REGISTRAR(OP_BUSCAR, inicioOp);
+                    ESTAT_SOMAR(comparacoes, comparacoes);
+                    if (resultado != -1) {
+                        printf("Item encontrado na posicao %d.\n", resultado);
+                    } else {
+                        printf("Item nao encontrado.\n");
+                    }
+                    printf("Numero de comparacoes: %d\n", comparacoes);
+                } else if (estrutura == ESTRUTURA_SKIP) {
+                    lerNome(nome);
+                    ESTAT_INICIAR(inicioOp);
+                    const Item* achado = buscarItemSkip(mk, nome, &comparacoes);
+                    ESTAT_REGISTRAR(OP_BUSCAR, inicioOp);
+                    ESTAT_SOMAR(comparacoes, comparacoes);
+                    if (achado) {
+                        printf("Item encontrado: %s, Tipo: %s, Quantidade: %d\n", achado->nome, nomeDoTipo(&tiposItens, achado->tipo), achado->quantidade);
+                    } else {
+                        printf("Item nao encontrado.\n");
+                    }
+                    printf("Numero de comparacoes: %d\n", comparacoes);
+                }
+                break;
+            case 7:
+                if (estrutura == ESTRUTURA_VETOR) {
+                    lerNome(nome);
+                    ESTAT_INICIAR(inicioOp);
+                    resultado = buscarHashVetor(mv, nome, &comparacoes);
+                    ESTAT_REGISTRAR(OP_BUSCAR, inicioOp);
+                    ESTAT_SOMAR(comparacoes, comparacoes);
+                    if (resultado != -1) {
+                        printf("Item encontrado na posicao %d.\n", resultado);
+                    } else {
+                        printf("Item nao encontrado.\n");
+                    }
+                    printf("Numero de comparacoes (sondagens): %d\n", comparacoes);
+                }
+                break;
+            case 17:
+                if (estrutura == ESTRUTURA_VETOR) {
+                    lerNome(nome);
+                    ESTAT_INICIAR(inicioOp);
+                    resultado = buscarEytzingerVetor(mv, nome, &comparacoes);
+                    ESTAT_REGISTRAR(OP_BUSCAR, inicioOp);
+                    ESTAT_SOMAR(comparacoes, comparacoes);
+                    if (resultado != -1) {
+                        printf("Item encontrado na posicao %d.\n", resultado);
+                    } else {
+                        printf("Item nao encontrado.\n");
+                    }
+                    printf("Numero de comparacoes: %d\n", comparacoes);
+                }
+                break;
+            case 8:
+                if (estrutura == ESTRUTURA_LISTA) {
+                    printf("Nos entregues: %ld (cada um seria um malloc sem o pool)\n", ml->pool.nosEntregues);
+                    printf("Chamadas de malloc do pool: %ld\n", ml->pool.chamadasMalloc);
+                    printf("Nos reaproveitados: %ld\n", ml->pool.nosReciclados);
+                }
+                break;
+            case 9:
+                if (estrutura == ESTRUTURA_VETOR) {
+                    definirManterOrdenado(mv, !mv->manterOrdenado);
+                    printf("Modo manter ordenado %s.\n", mv->manterOrdenado ? "ativado (vetor ordenado por nome)" : "desativado");
+                }
+                break;
+            case 10:
+                if (estrutura == ESTRUTURA_VETOR) {
+                    printf("Comparacoes acumuladas: %lld\n", mv->comparacoes);
+                    printf("Itens movidos acumulados: %lld\n", mv->movimentos);
+                    printf("Lapides aguardando compactacao: %d de %d posicoes\n", mv->apagados, mv->tamanho);
+                } else if (estrutura == ESTRUTURA_SKIP) {
+                    printf("Comparacoes acumuladas: %lld\n", mk->comparacoes);
+                    printf("Itens movidos acumulados: 0 (so ponteiros sao religados)\n");
+                    printf("Niveis em uso: %d\n", mk->nivel);
+                }
+                break;
+            case 12:
+            case 13:
+                if (estrutura == ESTRUTURA_VETOR) {
+                    printf("Digite o nome do arquivo: ");
+                    scanf("%255s", caminho);
+                    if (opcao == 12) {
+                        printf(salvarVetor(mv, caminho) ? "Mochila salva em %s.\n" : "Falha ao gravar %s.\n", caminho);
+                    } else if (carregarVetor(mv, caminho)) {
+                        printf("%d itens carregados de %s.\n", mv->tamanho - mv->apagados, caminho);
+                        // O diario descreve operacoes sobre o conteudo anterior: recomeca a partir deste.
+                        if (diario.fd >= 0 && !compactarDiario(&diario, ARQUIVO_SNAPSHOT, mv, ml)) {
+                            printf("Aviso: falha ao compactar o diario.\n");
+                        }
+                    } else {
+                        printf("Nao foi possivel carregar %s (ausente, corrompido ou de outra versao).\n", caminho);
+                    }
+                }
+                break;
+            case 14:
+                if (estrutura == ESTRUTURA_VETOR || estrutura == ESTRUTURA_LISTA) {
+                    printf("Registros no diario: %lld em %lld commits (intervalo %d)\n", diario.registros, diario.commits, diario.intervalo);
+                    printf("Falhas de gravacao: %lld\n", diario.falhas);
+                    if (diario.fd >= 0 && compactarDiario(&diario, ARQUIVO_SNAPSHOT, mv, ml)) {
+                        printf("Diario compactado em %s (%lld compactacoes).\n", ARQUIVO_SNAPSHOT, diario.compactacoes);
+                    } else {
+                        printf("Falha ao compactar o diario.\n");
+                    }
+                }
+                break;
+            case 15:
+                if (estrutura == ESTRUTURA_VETOR) {
+                    printf("Digite o comeco do nome: ");
+                    scanf("%29s", nome);
+                    ESTAT_INICIAR(inicioOp);
+                    resultado = buscarPrefixoVetor(mv, nome, posicoes, MAX_RESULTADOS_PREFIXO);
+                    ESTAT_REGISTRAR(OP_BUSCAR, inicioOp);
+                    for (int i = 0; i < resultado && i < MAX_RESULTADOS_PREFIXO; i++) {
+                        Item* achado = &mv->itens[posicoes[i]];
+                        printf("Nome: %s, Tipo: %s, Quantidade: %d (posicao %d)\n", achado->nome, nomeDoTipo(&tiposItens, achado->tipo), achado->quantidade, posicoes[i]);
+                    }
+                    if (resultado > MAX_RESULTADOS_PREFIXO) {
+                        printf("... e mais %d itens.\n", resultado - MAX_RESULTADOS_PREFIXO);
+                    }
+                    printf("%d item(ns) com esse prefixo.\n", resultado);
+                }
+                break;
+            case 11:
+                // Totais gerais e por tipo vem dos agregados (sem percorrer os itens);
+                // so o filtro por quantidade minima precisa varrer a mochila.
+                mostrarResumo(estrutura == ESTRUTURA_VETOR ? &mv->resumo : estrutura == ESTRUTURA_LISTA ? &ml->resumo
+                              : estrutura == ESTRUTURA_DESENROLADA ? &md->resumo : estrutura == ESTRUTURA_SOA ? &ms->resumo : &mk->resumo);
+                if (estrutura == ESTRUTURA_VETOR || estrutura == ESTRUTURA_SOA) {
+                    printf("Quantidade minima: ");
+                    scanf("%d", &minimo);
+                    resultado = estrutura == ESTRUTURA_VETOR ? contarQuantidadeMinimaVetor(mv, minimo) : contarQuantidadeMinimaSoA(ms, minimo);
+                    printf("Itens com quantidade >= %d: %d\n", minimo, resultado);
+                }
+                break;
+            case 16:
+                if (estrutura == ESTRUTURA_VETOR) {
+                    printf("Quantos itens? ");
+                    scanf("%d", &resultado);
+                    if (resultado < 1) {
+                        break;
+                    }
+                    char (*lidos)[30] = malloc((size_t)resultado * sizeof(*lidos));
+                    char** nomes = (char**)malloc((size_t)resultado * sizeof(char*));
+                    if (!lidos || !nomes) {
+                        printf("Falha na alocacao.\n");
+                    } else {
+                        for (int i = 0; i < resultado; i++) {
+                            lerNome(lidos[i]);
+                            nomes[i] = lidos[i];
+                        }
+                        ESTAT_INICIAR(inicioOp);
+                        resultado = removerItensVetor(mv, nomes, resultado);
+                        ESTAT_REGISTRAR(OP_REMOVER, inicioOp);
+                        printf("%d item(ns) removido(s).\n", resultado);
+                    }
+                    free(lidos);
+                    free(nomes);
+                }
+                break;
+            case 0:
+                break;
+            default:
+                printf("Opcao invalida.\n");
+        }
+        // Carregar um arquivo zera os contadores do vetor: nesse caso nao ha avanco a somar.
+        if (mv->comparacoes + mk->comparacoes >= comparacoesAntes && mv->movimentos >= movimentosAntes) {
+            ESTAT_SOMAR(comparacoes, mv->comparacoes + mk->comparacoes - comparacoesAntes);
+            ESTAT_SOMAR(movimentos, mv->movimentos - movimentosAntes);
+        }
+        avisarFalhasDiario(&diario);
+    } while (opcao != 0);
+}
+
+// Tempo de relogio monotono em segundos (nao afetado por ajustes do relogio do sistema).
+double tempoAtual() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Tipos usados pelos itens sinteticos (repetidos, como num inventario real).
+static const char* TIPOS_BENCH[] = { "arma", "municao", "cura", "ferramenta" };
+
+// Preenche um item sintetico para os benchmarks, com nome unico: i em base 26
+// com 6 letras seguido de "-item" (ex.: "aaabcd-item"), que como nomes reais se
+// diferencia logo nos primeiros caracteres. A ordem alfabetica e a ordem de i.
+// Escreve as letras diretamente para nao medir o custo de snprintf.
+void gerarItem(Item* it, int i) {
+    for (int d = 5, v = i; d >= 0; d--, v /= 26) {
+        it->nome[d] = (char)('a' + v % 26);
+    }
+    memcpy(&it->nome[6], "-item", 6);
+    it->tipo = (uint8_t)internarTipo(&tiposItens, TIPOS_BENCH[i % 4]); // Sempre cabe: sao 4 tipos
+    it->quantidade = i % 100;
+}
+
+// Posicao embaralhada de i em [0, n): multiplicar por um primo que nao divide n
+// e uma permutacao, o que gera ordens "aleatorias" reprodutiveis sem repeticao.
+int embaralhar(int i, int n) {
+    return (int)(((unsigned long long)i * 2654435761u) % (unsigned int)n);
+}
+
+// Benchmark de insercao no vetor crescente.
+// Compara n insercoes individuais com a insercao em lotes, para n de 10^3 ate nMax.
+// O tempo por item deve ficar aproximadamente constante (O(1) amortizado).
+void benchmarkInsercaoVetor(int nMax) {
+    const int lote = 1024;
+    Item* buffer = (Item*)malloc(lote * sizeof(Item));
+    if (!buffer) {
+        printf("Falha na alocacao.\n");
+        return;
+    }
+    printf("%12s %18s %14s %18s %14s\n", "n", "individual ns/item", "realocacoes", "lote ns/item", "realocacoes");
+    for (int n = 1000; n <= nMax; n *= 10) {
+        MochilaVetor mv;
+        initVetor(&mv);
+        Item it;
+        double inicio = tempoAtual();
+        for (int i = 0; i < n; i++) {
+            gerarItem(&it, i);
+            if (!inserirItemVetor(&mv, it)) {
+                printf("Falha na alocacao.\n");
+                break;
+            }
+        }
+        double individual = (tempoAtual() - inicio) * 1e9 / n;
+        int realocIndividual = mv.realocacoes;
+        liberarVetor(&mv);
+
+        inicio = tempoAtual();
+        for (int i = 0; i < n; i += lote) {
+            int k = n - i < lote ? n - i : lote;
+            for (int j = 0; j < k; j++) {
+                gerarItem(&buffer[j], i + j);
+            }
+            if (!inserirItensVetor(&mv, buffer, k)) {
+                printf("Falha na alocacao.\n");
+                break;
+            }
+        }
+        double emLote = (tempoAtual() - inicio) * 1e9 / n;
+        int realocLote = mv.realocacoes;
+        liberarVetor(&mv);
+
+        printf("%12d %18.2f %14d %18.2f %14d\n", n, individual, realocIndividual, emLote, realocLote);
+    }
+    free(buffer);
+}
+
+// Benchmark de busca no vetor: media de comparacoes e tempo por busca
+// para a busca sequencial, a binaria (apos ordenar) e a do indice hash.
+void benchmarkBuscasVetor(int n) {
+    const int consultas = 1000;
+    MochilaVetor mv;
+    initVetor(&mv);
+    Item it;
+    for (int i = 0; i < n; i++) {
+        gerarItem(&it, embaralhar(i, n));
+        if (!inserirItemVetor(&mv, it)) {
+            printf("Falha na alocacao.\n");
+            liberarVetor(&mv);
+            return;
+        }
+    }
+
+    int (*buscas[])(MochilaVetor*, char*, int*) = { buscarSequencialVetor, buscarHashVetor, buscarBinariaVetor };
+    const char* nomes[] = { "sequencial", "hash", "binaria" };
+    printf("\nBuscas em %d itens (%d consultas):\n", n, consultas);
+    printf("%12s %20s %14s\n", "busca", "comparacoes/busca", "ns/busca");
+    for (int b = 0; b < 3; b++) {
+        if (buscas[b] == buscarBinariaVetor) {
+            ordenarVetor(&mv);
+        }
+        long total = 0;
+        int comparacoes;
+        double inicio = tempoAtual();
+        for (int q = 0; q < consultas; q++) {
+            gerarItem(&it, embaralhar(q * 7919, n));
+            if (buscas[b](&mv, it.nome, &comparacoes) == -1) {
+                printf("Item %s nao encontrado.\n", it.nome);
+            }
+            total += comparacoes;
+        }
+        double ns = (tempoAtual() - inicio) * 1e9 / consultas;
+        printf("%12s %20.2f %14.2f\n", nomes[b], (double)total / consultas, ns);
+    }
+    liberarVetor(&mv);
+}
+
+// Benchmark de rotatividade na lista: insere n itens e depois faz n ciclos de
+// remover o primeiro e inserir um novo. Compara com malloc/free por no.
+void benchmarkPoolLista(int n) {
+    MochilaLista ml;
+    initLista(&ml);
+    Item it;
+    double inicio = tempoAtual();
+    for (int i = 0; i < 2 * n; i++) {
+        if (i >= n) {
+            removerItemLista(&ml, ml.inicio->dados.nome); // Remove o primeiro: O(1)
+        }
+        gerarItem(&it, i);
+        if (!inserirItemLista(&ml, it)) {
+            printf("Falha na alocacao.\n");
+            break;
+        }
+    }
+    double comPool = (tempoAtual() - inicio) * 1e9 / (2.0 * n);
+    long mallocs = ml.pool.chamadasMalloc;
+    long nos = ml.pool.nosEntregues;
+    liberarLista(&ml);
+
+    // Mesma sequencia de operacoes com um malloc/free por no.
+    No* lista = NULL;
+    inicio = tempoAtual();
+    for (int i = 0; i < 2 * n; i++) {
+        if (i >= n) {
+            No* primeiro = lista;
+            lista = lista->proximo;
+            free(primeiro);
+        }
+        No* novo = (No*)malloc(sizeof(No));
+        if (!novo) {
+            printf("Falha na alocacao.\n");
+            break;
+        }
+        gerarItem(&novo->dados, i);
+        novo->proximo = lista;
+        lista = novo;
+    }
+    double semPool = (tempoAtual() - inicio) * 1e9 / (2.0 * n);
+    while (lista) {
+        No* temp = lista;
+        lista = lista->proximo;
+        free(temp);
+    }
+
+    printf("\nRotatividade na lista (%d itens, %d ciclos):\n", n, n);
+    printf("  com pool: %.2f ns/op, %ld malloc para %ld nos\n", comPool, mallocs, nos);
+    printf("  sem pool: %.2f ns/op, %ld malloc\n", semPool, nos);
+}
+
+// Benchmark de percurso: busca sequencial de um nome ausente (percorre tudo)
+// no vetor, na lista encadeada e na lista desenrolada com n itens.
+void benchmarkPercursos(int n) {
+    const int repeticoes = 20;
+    MochilaVetor mv;
+    MochilaLista ml;
+    MochilaDesenrolada md;
+    initVetor(&mv);
+    initLista(&ml);
+    initDesenrolada(&md);
+    Item it;
+    for (int i = 0; i < n; i++) {
+        gerarItem(&it, i);
+        if (!inserirItemVetor(&mv, it) || !inserirItemLista(&ml, it) || !inserirItemDesenrolada(&md, it)) {
+            printf("Falha na alocacao.\n");
+            break;
+        }
+    }
+
+    printf("\nPercurso completo em %d itens (busca sem sucesso):\n", n);
+    char ausente[] = "inexistente";
+    const char* nomes[] = { "vetor", "lista encadeada", "lista desenrolada" };
+    for (int e = 0; e < 3; e++) {
+        volatile int resultado; // Gravar cada resultado impede o compilador de descartar as buscas
+        long totalComparacoes = 0;
+        int comparacoes;
+        double inicio = tempoAtual();
+        for (int r = 0; r < repeticoes; r++) {
+            if (e == 0) {
+                resultado = buscarSequencialVetor(&mv, ausente, &comparacoes);
+            } else if (e == 1) {
+                resultado = buscarSequencialLista(&ml, ausente, &comparacoes);
+            } else {
+                resultado = buscarSequencialDesenrolada(&md, ausente, &comparacoes);
+            }
+            totalComparacoes += comparacoes;
+        }
+        (void)resultado;
+        double ns = (tempoAtual() - inicio) * 1e9 / ((double)repeticoes * n);
+        printf("  %-18s %.2f ns/item (%ld comparacoes por busca)\n", nomes[e], ns, totalComparacoes / repeticoes);
+    }
+
+    liberarVetor(&mv);
+    liberarLista(&ml);
+    liberarDesenrolada(&md);
+}
+
+// Benchmark de consultas que so olham quantidade/tipo: o vetor de Item (AoS)
+// contra a mochila colunar (SoA) com os mesmos n itens.
+void benchmarkColunas(int n) {
+    const int repeticoes = 20;
+    MochilaVetor mv;
+    MochilaSoA ms;
+    initVetor(&mv);
+    initSoA(&ms);
+    int* posicoes = (int*)malloc((size_t)n * sizeof(int));
+    Item it;
+    for (int i = 0; i < n && posicoes; i++) {
+        gerarItem(&it, i);
+        if (!inserirItemVetor(&mv, it) || !inserirItemSoA(&ms, it)) {
+            break;
+        }
+    }
+    if (!posicoes || mv.tamanho != n || ms.tamanho != n) {
+        printf("Falha na alocacao.\n");
+        free(posicoes);
+        liberarVetor(&mv);
+        liberarSoA(&ms);
+        return;
+    }
+
+    printf("\nConsultas por coluna em %d itens (ns/item):\n", n);
+    printf("%30s %10s %10s\n", "consulta", "vetor", "colunar");
+    const char* consultas[] = { "soma das quantidades", "soma do tipo \"municao\"", "conta quantidade >= 80", "filtra quantidade >= 80" };
+    for (int c = 0; c < 4; c++) {
+        double ns[2];
+        long long verificacao[2] = { 0, 0 }; // Usa os resultados e confere que os dois layouts concordam
+        for (int layout = 0; layout < 2; layout++) {
+            double inicio = tempoAtual();
+            for (int r = 0; r < repeticoes; r++) {
+                long long v;
+                if (c == 0) {
+                    v = layout == 0 ? somarQuantidadesVetor(&mv) : somarQuantidadesSoA(&ms);
+                } else if (c == 1) {
+                    v = layout == 0 ? somarQuantidadesTipoVetor(&mv, "municao") : somarQuantidadesTipoSoA(&ms, "municao");
+                } else if (c == 2) {
+                    v = layout == 0 ? contarQuantidadeMinimaVetor(&mv, 80) : contarQuantidadeMinimaSoA(&ms, 80);
+                } else if (layout == 0) {
+                    v = 0; // No vetor, o filtro e o mesmo laco da contagem gravando as posicoes
+                    for (int i = 0; i < mv.tamanho; i++) {
+                        posicoes[v] = i;
+                        v += mv.itens[i].quantidade >= 80;
+                    }
+                } else {
+                    v = filtrarQuantidadeMinimaSoA(&ms, 80, posicoes);
+                }
+                verificacao[layout] += v;
+            }
+            ns[layout] = (tempoAtual() - inicio) * 1e9 / ((double)repeticoes * n);
+        }
+        printf("%30s %10.3f %10.3f%s\n", consultas[c], ns[0], ns[1], verificacao[0] != verificacao[1] ? " (ERRO: resultados diferentes)" : "");
+    }
+    // As duas primeiras consultas tambem saem dos agregados mantidos nas insercoes, sem varrer.
+    long long quantidadeTipo;
+    totaisDoTipo(&ms.resumo, "municao", &quantidadeTipo);
+    int concordam = mv.resumo.quantidade == somarQuantidadesVetor(&mv) && ms.resumo.quantidade == mv.resumo.quantidade
+                    && quantidadeTipo == somarQuantidadesTipoSoA(&ms, "municao");
+    printf("%30s %lld e %lld (O(1))%s\n", "agregados (soma, municao):", ms.resumo.quantidade, quantidadeTipo,
+           concordam ? "" : " (ERRO: agregados fora de sincronia)");
+
+    free(posicoes);
+    liberarVetor(&mv);
+    liberarSoA(&ms);
+}
+
+// Benchmark do snapshot binario: grava n itens e mede a carga com mmap
+// (incluindo a soma de verificacao) e a primeira busca no vetor carregado.
+void benchmarkArquivo(int n) {
+    const char* caminho = "bench_mochila.bin";
+    MochilaVetor mv;
+    initVetor(&mv);
+    Item it;
+    for (int i = 0; i < n; i++) {
+        gerarItem(&it, embaralhar(i, n));
+        if (!inserirItemVetor(&mv, it)) {
+            printf("Falha na alocacao.\n");
+            liberarVetor(&mv);
+            return;
+        }
+    }
+    printf("\nSnapshot binario com %d itens:\n", n);
+    double inicio = tempoAtual();
+    int ok = salvarVetor(&mv, caminho);
+    double gravacao = tempoAtual() - inicio;
+    liberarVetor(&mv);
+    if (!ok) {
+        printf("Falha ao gravar %s.\n", caminho);
+        return;
+    }
+
+    MochilaVetor carregado;
+    initVetor(&carregado);
+    inicio = tempoAtual();
+    ok = carregarVetor(&carregado, caminho);
+    double carga = tempoAtual() - inicio;
+    int sondagens = 0;
+    gerarItem(&it, n / 2);
+    int pos = ok ? buscarHashVetor(&carregado, it.nome, &sondagens) : -1;
+    printf("  gravacao: %.2f ms\n", gravacao * 1e3);
+    printf("  carga (mmap + verificacao): %.2f ms%s\n", carga * 1e3, ok ? "" : " (FALHOU)");
+    printf("  busca por hash apos carga: %s em %d sondagens\n", pos != -1 ? "encontrado" : "NAO encontrado", sondagens);
+    liberarVetor(&carregado);
+    remove(caminho);
+}
+
+// Benchmark do diario: k insercoes no vetor com o diario aberto, variando o intervalo
+// do commit em grupo (registros por fsync), e a repeticao do ultimo diario gravado.
+void benchmarkDiario(int n) {
+    const char* caminho = "bench_mochila.diario";
+    const int intervalos[] = { 1, 16, 256 };
+    int k = n < 5000 ? n : 5000; // fsync por operacao e caro demais para n grande
+    printf("\nDiario de operacoes (%d insercoes no vetor):\n", k);
+    printf("%12s %14s %10s\n", "intervalo", "us/insercao", "fsyncs");
+    Item it;
+    for (int c = 0; c < 3; c++) {
+        remove(caminho);
+        diario = (Diario){ .fd = -1 };
+        if (!abrirDiario(&diario, caminho, intervalos[c], 0)) {
+            printf("Falha ao criar %s.\n", caminho);
+            return;
+        }
+        MochilaVetor mv;
+        initVetor(&mv);
+        double inicio = tempoAtual();
+        for (int i = 0; i < k; i++) {
+            gerarItem(&it, i);
+            inserirItemVetor(&mv, it);
+        }
+        fecharDiario(&diario);
+        double tempo = tempoAtual() - inicio;
+        printf("%12d %14.2f %10lld\n", intervalos[c], tempo * 1e6 / k, diario.commits);
+        liberarVetor(&mv);
+    }
+
+    MochilaVetor mv;
+    MochilaLista ml;
+    initVetor(&mv);
+    initLista(&ml);
+    double inicio = tempoAtual();
+    long long repetidos = repetirDiario(caminho, 0, &mv, &ml);
+    double tempo = tempoAtual() - inicio;
+    printf("  repeticao: %lld registros em %.2f ms (%s)\n", repetidos, tempo * 1e3, mv.tamanho == k ? "ok" : "DIVERGENTE");
+    liberarVetor(&mv);
+    liberarLista(&ml);
+    diario = (Diario){ .fd = -1 };
+    remove(caminho);
+}
+
+// Benchmark da busca por prefixo: custo de manter a trie nas insercoes e tempo por
+// consulta com a trie (so os MAX_RESULTADOS_PREFIXO primeiros, como no menu, e todos)
+// e com a comparacao item a item, para prefixos de 2 a 5 letras
+// (nomes gerados tem 6 letras, entao cada letra a mais divide os resultados por 26).
+void benchmarkPrefixos(int n) {
+    MochilaVetor semTrie, comTrie;
+    initVetor(&semTrie);
+    initVetor(&comTrie);
+    definirIndicePrefixos(&comTrie, 1);
+    Item it;
+    double tempos[2];
+    MochilaVetor* vetores[2] = { &semTrie, &comTrie };
+    for (int v = 0; v < 2; v++) {
+        double inicio = tempoAtual();
+        for (int i = 0; i < n; i++) {
+            gerarItem(&it, embaralhar(i, n));
+            if (!inserirItemVetor(vetores[v], it)) {
+                printf("Falha na alocacao.\n");
+                liberarVetor(&semTrie);
+                liberarVetor(&comTrie);
+                return;
+            }
+        }
+        tempos[v] = tempoAtual() - inicio;
+    }
+    printf("\nBusca por prefixo (%d itens):\n", n);
+    printf("  insercao: %.3f us/item sem trie, %.3f us/item com trie (%d nos)\n",
+           tempos[0] * 1e6 / n, tempos[1] * 1e6 / n, comTrie.prefixos.quantidade);
+    printf("%8s %12s %14s %14s %14s\n", "prefixo", "resultados", "us trie top50", "us trie todos", "us seq");
+    int* posicoes = (int*)malloc((size_t)n * sizeof(int));
+    if (!posicoes) {
+        liberarVetor(&semTrie);
+        liberarVetor(&comTrie);
+        return;
+    }
+    for (int letras = 2; letras <= 5; letras++) {
+        int consultas = 200;
+        int consultasSeq = n > 100000 ? 5 : 50;
+        long long totalTrie = 0;
+        double tempoTrie[2];
+        for (int modo = 0; modo < 2; modo++) {
+            int maximo = modo == 0 ? MAX_RESULTADOS_PREFIXO : n;
+            totalTrie = 0;
+            double inicio = tempoAtual();
+            for (int q = 0; q < consultas; q++) {
+                gerarItem(&it, embaralhar(q * 7919 + 1, n));
+                it.nome[letras] = '\0';
+                totalTrie += buscarPrefixoVetor(&comTrie, it.nome, posicoes, maximo);
+            }
+            tempoTrie[modo] = (tempoAtual() - inicio) / consultas;
+        }
+        double inicio = tempoAtual();
+        for (int q = 0; q < consultasSeq; q++) {
+            gerarItem(&it, embaralhar(q * 7919 + 1, n));
+            it.nome[letras] = '\0';
+            buscarPrefixoVetor(&semTrie, it.nome, posicoes, n);
+        }
+        double tempoSeq = (tempoAtual() - inicio) / consultasSeq;
+        printf("%8d %12.1f %14.2f %14.2f %14.2f\n", letras, (double)totalTrie / consultas, tempoTrie[0] * 1e6, tempoTrie[1] * 1e6, tempoSeq * 1e6);
+    }
+    free(posicoes);
+    liberarVetor(&semTrie);
+    liberarVetor(&comTrie);
+}
+
+// Benchmark do modo "manter ordenado": a partir de n itens ordenados, faz k vezes
+// "insere um item novo e busca por ele com busca binaria". Compara a insercao
+// ordenada (busca binaria + memmove) com inserir no final e reordenar antes da busca,
+// e com a skip list (insercao e busca em O(log n), sem mover itens).
+void benchmarkManterOrdenado(int n) {
+    const int k = 1000;
+    printf("\nInsercao ordenada + busca (%d insercoes sobre %d itens):\n", k, n);
+    printf("%22s %14s %16s %16s\n", "modo", "us/insercao", "comparacoes/ins", "movimentos/ins");
+    for (int modo = 0; modo < 2; modo++) {
+        MochilaVetor mv;
+        initVetor(&mv);
+        Item it;
+        for (int i = 0; i < n; i++) {
+            gerarItem(&it, 2 * embaralhar(i, n)); // Nomes pares; os novos serao impares
+            if (!inserirItemVetor(&mv, it)) {
+                printf("Falha na alocacao.\n");
+                liberarVetor(&mv);
+                return;
+            }
+        }
+        definirManterOrdenado(&mv, modo == 0);
+        if (modo == 1) {
+            ordenarVetor(&mv);
+        }
+        mv.comparacoes = 0;
+        mv.movimentos = 0;
+
+        int comparacoes;
+        long falhas = 0;
+        double inicio = tempoAtual();
+        for (int q = 0; q < k; q++) {
+            gerarItem(&it, 2 * embaralhar(q, n) + 1);
+            inserirItemVetor(&mv, it);
+            if (!mv.ordenado) {
+                ordenarVetor(&mv);
+            }
+            falhas += buscarBinariaVetor(&mv, it.nome, &comparacoes) == -1;
+        }
+        double us = (tempoAtual() - inicio) * 1e6 / k;
+        printf("%22s %14.2f %16.1f %16.1f%s\n", modo == 0 ? "manter ordenado" : "inserir e reordenar", us,
+               (double)mv.comparacoes / k, (double)mv.movimentos / k, falhas ? " (ERRO: item nao encontrado)" : "");
+        liberarVetor(&mv);
+    }
+
+    // A mesma sequencia na skip list: fica ordenada sem mover itens.
+    MochilaSkip mk;
+    initSkip(&mk);
+    Item it;
+    for (int i = 0; i < n; i++) {
+        gerarItem(&it, 2 * embaralhar(i, n));
+        if (!inserirItemSkip(&mk, it)) {
+            printf("Falha na alocacao.\n");
+            liberarSkip(&mk);
+            return;
+        }
+    }
+    mk.comparacoes = 0;
+    int comparacoes;
+    long falhas = 0;
+    double inicio = tempoAtual();
+    for (int q = 0; q < k; q++) {
+        gerarItem(&it, 2 * embaralhar(q, n) + 1);
+        inserirItemSkip(&mk, it);
+        falhas += buscarItemSkip(&mk, it.nome, &comparacoes) == NULL;
+    }
+    double us = (tempoAtual() - inicio) * 1e6 / k;
+    printf("%22s %14.2f %16.1f %16.1f%s\n", "skip list", us, (double)mk.comparacoes / k, 0.0, falhas ? " (ERRO: item nao encontrado)" : "");
+    liberarSkip(&mk);
+}
+
+// Benchmark de remocao no vetor ordenado: remove k = n/10 itens sorteados
+// (1) um a um com lapides, (2) em lote com removerItensVetor e (3) deslocando o resto
+// do array a cada remocao, como antes das lapides (so as primeiras 1000, e o caminho lento).
+void benchmarkRemocoes(int n) {
+    int k = n / 10 > 0 ? n / 10 : 1;
+    int kDeslocando = k < 1000 ? k : 1000;
+    Item* itens = (Item*)malloc((size_t)k * sizeof(Item));
+    char** nomes = (char**)malloc((size_t)k * sizeof(char*));
+    if (!itens || !nomes) {
+        printf("Falha na alocacao.\n");
+        free(itens);
+        free(nomes);
+        return;
+    }
+    for (int i = 0; i < k; i++) {
+        gerarItem(&itens[i], embaralhar(i, n));
+        nomes[i] = itens[i].nome;
+    }
+    printf("\nRemocao no vetor ordenado (%d itens):\n", n);
+    printf("%22s %10s %14s %16s\n", "modo", "remocoes", "us/remocao", "movimentos/rem");
+    for (int modo = 0; modo < 3; modo++) {
+        MochilaVetor mv;
+        initVetor(&mv);
+        Item it;
+        for (int i = 0; i < n; i++) {
+            gerarItem(&it, i);
+            if (!inserirItemVetor(&mv, it)) {
+                printf("Falha na alocacao.\n");
+                break;
+            }
+        }
+        ordenarVetor(&mv);
+        mv.movimentos = 0;
+        int total = modo == 2 ? kDeslocando : k;
+        int removidos = 0;
+        double inicio = tempoAtual();
+        if (modo == 0) {
+            for (int i = 0; i < total; i++) {
+                removidos += removerItemVetor(&mv, nomes[i]);
+            }
+        } else if (modo == 1) {
+            removidos = removerItensVetor(&mv, nomes, total);
+        } else {
+            for (int i = 0; i < total; i++) {
+                int sondagens;
+                int pos = indiceBuscar(&mv.indice, mv.itens, nomes[i], &sondagens);
+                if (pos == -1) {
+                    continue;
+                }
+                indiceRemover(&mv.indice, mv.itens, pos);
+                memmove(&mv.itens[pos], &mv.itens[pos + 1], (size_t)(mv.tamanho - pos - 1) * sizeof(Item));
+                mv.movimentos += mv.tamanho - pos - 1;
+                indiceDeslocar(&mv.indice, pos + 1, -1);
+                mv.tamanho--;
+                removidos++;
+            }
+        }
+        double us = (tempoAtual() - inicio) * 1e6 / total;
+        const char* modos[] = { "um a um (lapides)", "em lote", "deslocando" };
+        printf("%22s %10d %14.3f %16.1f%s\n", modos[modo], removidos, us, (double)mv.movimentos / total,
+               removidos != total ? " (ERRO: item nao encontrado)" : "");
+        liberarVetor(&mv);
+    }
+    free(itens);
+    free(nomes);
+}
+
+// Benchmark de busca no vetor ordenado: busca binaria classica x layout de Eytzinger,
+// para n de 10^3 ate nMax (multiplicando por 10). As consultas sao nomes presentes
+// embaralhados, gerados antes da medicao; as duas buscas precisam achar a mesma posicao.
+// A montagem do layout (O(n), uma vez por alteracao do vetor) e medida a parte.
+void benchmarkEytzinger(int nMax) {
+    const int consultas = 500000;
+    char (*nomes)[30] = malloc((size_t)consultas * sizeof(*nomes));
+    int* esperado = (int*)malloc((size_t)consultas * sizeof(int));
+    if (!nomes || !esperado) {
+        printf("Falha na alocacao.\n");
+        free(nomes);
+        free(esperado);
+        return;
+    }
+    printf("\nBusca binaria x layout de Eytzinger (%d consultas):\n", consultas);
+    printf("%10s %14s %14s %12s %16s %14s\n", "n", "binaria ns", "eytzinger ns", "ganho", "comparacoes b/e", "montagem ms");
+    for (int n = 1000; n <= nMax; n *= 10) {
+        MochilaVetor mv;
+        initVetor(&mv);
+        Item it;
+        int ok = 1;
+        for (int i = 0; ok && i < n; i++) {
+            gerarItem(&it, i);
+            ok = inserirItemVetor(&mv, it);
+        }
+        if (!ok) {
+            printf("Falha na alocacao.\n");
+            liberarVetor(&mv);
+            break;
+        }
+        ordenarVetor(&mv);
+        for (int q = 0; q < consultas; q++) {
+            gerarItem(&it, embaralhar(q, n));
+            memcpy(nomes[q], it.nome, sizeof(it.nome));
+        }
+
+        int comparacoes;
+        long long totalBinaria = 0;
+        double inicio = tempoAtual();
+        for (int q = 0; q < consultas; q++) {
+            esperado[q] = buscarBinariaVetor(&mv, nomes[q], &comparacoes);
+            totalBinaria += comparacoes;
+        }
+        double nsBinaria = (tempoAtual() - inicio) * 1e9 / consultas;
+
+        inicio = tempoAtual();
+        ok = montarEytzinger(&mv.eytzinger, &mv);
+        double msMontagem = (tempoAtual() - inicio) * 1e3;
+        if (!ok) {
+            printf("Falha na alocacao.\n");
+            liberarVetor(&mv);
+            break;
+        }
+        long long totalEytzinger = 0;
+        int divergentes = 0;
+        inicio = tempoAtual();
+        for (int q = 0; q < consultas; q++) {
+            divergentes += buscarEytzingerVetor(&mv, nomes[q], &comparacoes) != esperado[q];
+            totalEytzinger += comparacoes;
+        }
+        double nsEytzinger = (tempoAtual() - inicio) * 1e9 / consultas;
+
+        printf("%10d %14.1f %14.1f %11.2fx %7.1f/%-8.1f %14.2f%s\n", n, nsBinaria, nsEytzinger, nsBinaria / nsEytzinger,
+               (double)totalBinaria / consultas, (double)totalEytzinger / consultas, msMontagem,
+               divergentes ? " (ERRO: resultados diferentes)" : "");
+        liberarVetor(&mv);
+        if (n > nMax / 10) {
+            break; // Evita estourar int ao multiplicar
+        }
+    }
+    free(nomes);
+    free(esperado);
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark CSV (modo --bench-csv): datasets gerados, aquecimento, repeticoes,
+// mediana e p95 do tempo de cada funcao de ordenacao e busca.
+// ---------------------------------------------------------------------------
+
+// TipoDataset, NOMES_DATASET, proximoAleatorio e calcularPercentis (e tempoAtual, acima)
+// sao a copia de referencia: Desafio-mestre-sobrevivencia.c repete os mesmos, pois cada
+// desafio compila sozinho. Mudancas comecam aqui e sao copiadas para la, para que os CSVs
+// dos dois programas continuem comparaveis.
+
+// Formas de dados gerados para o benchmark.
+typedef enum {
+    DATASET_ALEATORIO,
+    DATASET_ORDENADO,
+    DATASET_REVERSO,
+    DATASET_QUASE_ORDENADO
+} TipoDataset;
+
+const char* NOMES_DATASET[] = { "aleatorio", "ordenado", "reverso", "quase_ordenado" };
+
+// Gerador pseudoaleatorio xorshift32 (rapido e reprodutivel com a mesma semente).
+unsigned int proximoAleatorio(unsigned int* estado) {
+    unsigned int x = *estado;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *estado = x;
+    return x;
+}
+
+// Gera n itens na forma pedida (nomes unicos; "ordenado" = ordem alfabetica).
+// Quase ordenado: ordenado com 1% dos elementos trocados de lugar ao acaso.
+void gerarDataset(Item itens[], int n, TipoDataset tipo, unsigned int* semente) {
+    for (int i = 0; i < n; i++) {
+        gerarItem(&itens[i], tipo == DATASET_REVERSO ? n - 1 - i : i);
+    }
+    if (tipo == DATASET_ALEATORIO) {
+        for (int i = n - 1; i > 0; i--) { // Fisher-Yates
+            int j = (int)(proximoAleatorio(semente) % (unsigned int)(i + 1));
+            Item temp = itens[i];
+            itens[i] = itens[j];
+            itens[j] = temp;
+        }
+    } else if (tipo == DATASET_QUASE_ORDENADO) {
+        for (int k = 0; k < n / 100; k++) {
+            int i = (int)(proximoAleatorio(semente) % (unsigned int)n);
+            int j = (int)(proximoAleatorio(semente) % (unsigned int)n);
+            Item temp = itens[i];
+            itens[i] = itens[j];
+            itens[j] = temp;
+        }
+    }
+}
+
+// Funcao de comparacao de doubles para qsort (usada nos percentis).
+int compararTempos(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Ordena os tempos e devolve a mediana e o percentil 95 (metodo do posto mais proximo).
+void calcularPercentis(double tempos[], int n, double* mediana, double* p95) {
+    qsort(tempos, n, sizeof(double), compararTempos);
+    *mediana = n % 2 ? tempos[n / 2] : (tempos[n / 2 - 1] + tempos[n / 2]) / 2;
+    int posto = (95 * n + 99) / 100; // ceil(0.95 * n)
+    *p95 = tempos[posto - 1];
+}
+
+// Adaptadores para chamar as buscas das estruturas pelo mesmo ponteiro.
+static int buscaSeqVetor(void* m, char* nome, int* c) { return buscarSequencialVetor((MochilaVetor*)m, nome, c); }
+static int buscaHashVetor(void* m, char* nome, int* c) { return buscarHashVetor((MochilaVetor*)m, nome, c); }
+static int buscaBinVetor(void* m, char* nome, int* c) { return buscarBinariaVetor((MochilaVetor*)m, nome, c); }
+static int buscaEytzingerVetor(void* m, char* nome, int* c) { return buscarEytzingerVetor((MochilaVetor*)m, nome, c); }
+static int buscaSeqLista(void* m, char* nome, int* c) { return buscarSequencialLista((MochilaLista*)m, nome, c); }
+static int buscaSeqDesenrolada(void* m, char* nome, int* c) { return buscarSequencialDesenrolada((MochilaDesenrolada*)m, nome, c); }
+static int buscaSkip(void* m, char* nome, int* c) { return buscarItemSkip((MochilaSkip*)m, nome, c) ? 0 : -1; }
+
+// Mede 'consultas' buscas por nomes sorteados de [0, n) e escreve a linha CSV.
+// Os tempos sao por consulta e as comparacoes sao a media por consulta.
+static void medirBuscas(FILE* saida, const char* nomeBusca, const char* dataset, int (*busca)(void*, char*, int*),
+                        void* mochila, int n, int consultas, int repeticoes, double tempos[]) {
+    unsigned int semente = 777;
+    long long totalComparacoes = 0;
+    Item chave;
+    for (int r = -1; r < repeticoes; r++) { // r = -1: aquecimento
+        long long soma = 0;
+        double inicio = tempoAtual();
+        for (int q = 0; q < consultas; q++) {
+            gerarItem(&chave, (int)(proximoAleatorio(&semente) % (unsigned int)n));
+            int comparacoes;
+            busca(mochila, chave.nome, &comparacoes);
+            soma += comparacoes;
+        }
+        double fim = tempoAtual();
+        if (r >= 0) {
+            tempos[r] = (fim - inicio) / consultas;
+            totalComparacoes += soma;
+        }
+    }
+    double mediana, p95;
+    calcularPercentis(tempos, repeticoes, &mediana, &p95);
+    fprintf(saida, "%s,%s,%d,%d,%d,%.9f,%.9f,%.2f,\n", nomeBusca, dataset, n, repeticoes, consultas, mediana, p95,
+            (double)totalComparacoes / ((double)consultas * repeticoes));
+    fflush(saida);
+}
+
+// Executa o benchmark CSV com n itens para cada forma de dataset.
+// Colunas: algoritmo,dataset,n,repeticoes,operacoes,mediana_s,p95_s,comparacoes,movimentos
+// ordenar_vetor traz as comparacoes e os itens movidos pela ultima repeticao; as buscas
+// trazem a media de comparacoes por consulta e deixam movimentos vazio.
+// As estruturas sao montadas uma de cada vez para caber 10^7 itens na memoria.
+int executarBenchmarkCsv(int n, int repeticoes, FILE* saida) {
+    Item* dataset = (Item*)malloc((size_t)n * sizeof(Item));
+    double* tempos = (double*)malloc((size_t)repeticoes * sizeof(double));
+    if (!dataset || !tempos) {
+        free(dataset);
+        free(tempos);
+        fprintf(stderr, "Falha ao alocar memoria para %d itens.\n", n);
+        return 0;
+    }
+    // Buscas sequenciais sao O(n): limita o total a ~2*10^7 comparacoes por repeticao.
+    int consultasSeq = 20000000 / n;
+    consultasSeq = consultasSeq < 10 ? 10 : (consultasSeq > 100000 ? 100000 : consultasSeq);
+    int consultas = 100000;
+
+    unsigned int semente = 12345;
+    fprintf(saida, "algoritmo,dataset,n,repeticoes,operacoes,mediana_s,p95_s,comparacoes,movimentos\n");
+    for (int d = DATASET_ALEATORIO; d <= DATASET_QUASE_ORDENADO; d++) {
+        gerarDataset(dataset, n, (TipoDataset)d, &semente);
+        const char* nomeDataset = NOMES_DATASET[d];
+
+        MochilaVetor mv;
+        initVetor(&mv);
+        long long comparacoesOrdenar = 0, movimentosOrdenar = 0; // Da ultima repeticao
+        for (int r = -1; r < repeticoes; r++) {
+            limparVetor(&mv);
+            if (!inserirItensVetor(&mv, dataset, n)) {
+                fprintf(stderr, "Falha na alocacao.\n");
+                liberarVetor(&mv);
+                free(dataset);
+                free(tempos);
+                return 0;
+            }
+            comparacoesOrdenar = mv.comparacoes;
+            movimentosOrdenar = mv.movimentos;
+            double inicio = tempoAtual();
+            ordenarVetor(&mv);
+            double fim = tempoAtual();
+            comparacoesOrdenar = mv.comparacoes - comparacoesOrdenar;
+            movimentosOrdenar = mv.movimentos - movimentosOrdenar;
+            if (r >= 0) {
+                tempos[r] = fim - inicio;
+            }
+        }
+        double mediana, p95;
+        calcularPercentis(tempos, repeticoes, &mediana, &p95);
+        fprintf(saida, "ordenar_vetor,%s,%d,%d,1,%.9f,%.9f,%lld,%lld\n", nomeDataset, n, repeticoes, mediana, p95,
+                comparacoesOrdenar, movimentosOrdenar);
+
+        liberarVetor(&mv);
+        if (!inserirItensVetor(&mv, dataset, n)) {
+            fprintf(stderr, "Falha na alocacao.\n");
+            break;
+        }
+        medirBuscas(saida, "busca_sequencial_vetor", nomeDataset, buscaSeqVetor, &mv, n, consultasSeq, repeticoes, tempos);
+        medirBuscas(saida, "busca_hash_vetor", nomeDataset, buscaHashVetor, &mv, n, consultas, repeticoes, tempos);
+        ordenarVetor(&mv);
+        medirBuscas(saida, "busca_binaria_vetor", nomeDataset, buscaBinVetor, &mv, n, consultas, repeticoes, tempos);
+        medirBuscas(saida, "busca_eytzinger_vetor", nomeDataset, buscaEytzingerVetor, &mv, n, consultas, repeticoes, tempos);
+        liberarVetor(&mv);
+
+        MochilaLista ml;
+        initLista(&ml);
+        for (int i = n - 1; i >= 0; i--) { // Insercao no inicio: percorre de tras para manter a ordem
+            inserirItemLista(&ml, dataset[i]);
+        }
+        medirBuscas(saida, "busca_sequencial_lista", nomeDataset, buscaSeqLista, &ml, n, consultasSeq, repeticoes, tempos);
+        liberarLista(&ml);
+
+        MochilaDesenrolada md;
+        initDesenrolada(&md);
+        for (int i = n - 1; i >= 0; i--) {
+            inserirItemDesenrolada(&md, dataset[i]);
+        }
+        medirBuscas(saida, "busca_sequencial_desenrolada", nomeDataset, buscaSeqDesenrolada, &md, n, consultasSeq, repeticoes, tempos);
+        liberarDesenrolada(&md);
+
+        MochilaSkip mk;
+        initSkip(&mk);
+        for (int i = 0; i < n; i++) {
+            inserirItemSkip(&mk, dataset[i]);
+        }
+        medirBuscas(saida, "busca_skip_list", nomeDataset, buscaSkip, &mk, n, consultas, repeticoes, tempos);
+        liberarSkip(&mk);
+    }
+
+    free(dataset);
+    free(tempos);
+    return 1;
+}
+
+// Teste de carga da loja de mochilas (--stress).
+#define ITENS_STRESS 10 // Itens fixos por jogador
+
+typedef struct {
+    LojaMochilas* loja;
+    int jogadores;
+    int operacoes;
+    int indice;
+    uint8_t tipo;
+    long long buscas;
+    long long encontrados;
+    long long escritas;
+} TrabalhoStress;
+
+// Corpo de cada thread do teste de carga (sementes diferentes por thread).
+static void* threadStress(void* p) {
+    TrabalhoStress* t = (TrabalhoStress*)p;
+    unsigned int estado = 2463534242u + (unsigned int)t->indice * 7919u;
+    Item it;
+    for (int i = 0; i < t->operacoes; i++) {
+        unsigned int r = proximoAleatorio(&estado);
+        int jogador = (int)(r % (unsigned int)t->jogadores);
+        if ((r >> 24) % 10 < 9) {
+            Item achado;
+            gerarItem(&it, (int)((r >> 16) % ITENS_STRESS));
+            t->buscas++;
+            t->encontrados += lojaBuscarItem(t->loja, jogador, it.nome, &achado);
+        } else {
+            snprintf(it.nome, sizeof(it.nome), "tmp-%d-%d", t->indice, i);
+            it.tipo = t->tipo;
+            it.quantidade = 1;
+            if (lojaInserirItem(t->loja, jogador, it) && lojaRemoverItem(t->loja, jogador, it.nome)) {
+                t->escritas += 2;
+            }
+        }
+    }
+    return NULL;
+}
+
+// Teste de carga da loja: 'jogadores' mochilas com ITENS_STRESS itens cada e T threads
+// fazendo 'operacoes' operacoes cada, 90% buscas de itens existentes e 10% pares
+// insere + remove de um item temporario (escrita no shard). Roda T = 1, 2, 4, 8, 16
+// e mostra operacoes/s e o ganho sobre T = 1. No fim confere que toda busca achou
+// o item e que toda mochila voltou a ter ITENS_STRESS itens.
+// Retorna 1 se todas as conferencias passaram, 0 caso contrario.
+int executarStressLoja(int jogadores, int operacoes) {
+    LojaMochilas* loja = (LojaMochilas*)malloc(sizeof(LojaMochilas));
+    if (!loja || !initLoja(loja)) {
+        fprintf(stderr, "Falha ao alocar a loja.\n");
+        free(loja);
+        return 0;
+    }
+    Item it;
+    for (int j = 0; j < jogadores; j++) {
+        for (int i = 0; i < ITENS_STRESS; i++) {
+            gerarItem(&it, i); // Tambem interna os tipos antes de haver threads
+            lojaInserirItem(loja, j, it);
+        }
+    }
+    uint8_t tipo = (uint8_t)buscarTipo(&tiposItens, TIPOS_BENCH[0]);
+
+    printf("Loja com %d jogadores (%d shards), %d operacoes por thread, 90%% buscas:\n", jogadores, NUM_SHARDS, operacoes);
+    printf("%8s %14s %10s\n", "threads", "ops/s", "ganho");
+    const int contagens[] = { 1, 2, 4, 8, 16 };
+    TrabalhoStress trabalhos[16];
+    pthread_t threads[16];
+    double base = 0;
+    int ok = 1;
+    for (int c = 0; c < 5; c++) {
+        int numThreads = contagens[c];
+        double inicio = tempoAtual();
+        int criadas = 0;
+        for (int t = 0; t < numThreads; t++) {
+            trabalhos[t] = (TrabalhoStress){ loja, jogadores, operacoes, t, tipo, 0, 0, 0 };
+            if (pthread_create(&threads[t], NULL, threadStress, &trabalhos[t]) != 0) {
+                break;
+            }
+            criadas++;
+        }
+        for (int t = 0; t < criadas; t++) {
+            pthread_join(threads[t], NULL);
+        }
+        double tempo = tempoAtual() - inicio;
+        long long total = 0;
+        for (int t = 0; t < criadas; t++) {
+            total += trabalhos[t].buscas + trabalhos[t].escritas;
+            ok = ok && trabalhos[t].encontrados == trabalhos[t].buscas;
+        }
+        double opsPorSegundo = tempo > 0 ? (double)total / tempo : 0;
+        if (c == 0) {
+            base = opsPorSegundo;
+        }
+        printf("%8d %14.0f %9.2fx\n", criadas, opsPorSegundo, base > 0 ? opsPorSegundo / base : 0.0);
+    }
+    for (int j = 0; j < jogadores; j++) {
+        ok = ok && lojaTamanhoMochila(loja, j) == ITENS_STRESS;
+    }
+    printf("Conferencia: %s\n", ok ? "ok" : "FALHOU");
+    liberarLoja(loja);
+    free(loja);
+    return ok;
+}
+
+// Autoteste (--autoteste)
+//
+// Conferencias sem menu e sem tocar em mochila.bin: cada funcao autoteste* monta os
+// seus dados, confere um recurso e mostra ok/FALHOU por item. Os arquivos temporarios
+// ficam no diretorio atual e sao apagados no fim.
+#define ARQUIVO_AUTOTESTE "autoteste_mochila.bin"
+#define CORROMPIDO_AUTOTESTE "autoteste_corrompido.bin"
+#define DIARIO_AUTOTESTE "autoteste_mochila.diario"
+#define ITENS_AUTOTESTE 1000
+#define EXTRAS_AUTOTESTE 16 // Itens gerarItem(n..n+15) usados como novos
+
+// Mostra o resultado de uma conferencia e o devolve.
+static int conferirAutoteste(const char* descricao, int ok) {
+    printf("%-62s %s\n", descricao, ok ? "ok" : "FALHOU");
+    return ok;
+}
+
+// Confere a subarvore de 'no': total = contagem + totais dos filhos, filhos em ordem
+// pelo primeiro byte, rotulos nao vazios fora da raiz e nenhum no vazio pendurado.
+// Retorna o total da subarvore, ou -1 se alguma regra falhou.
+static int conferirTrie(const TriePrefixos* t, int no) {
+    const NoTrie* n = &t->nos[no];
+    if ((no != 0 && n->tamanho == 0) || n->contagem < 0) {
+        return -1;
+    }
+    int soma = n->contagem;
+    int anterior = -1;
+    for (int f = n->filho; f != -1; f = t->nos[f].irmao) {
+        if (f <= 0 || f >= t->quantidade || (unsigned char)t->nos[f].rotulo[0] <= anterior) {
+            return -1;
+        }
+        anterior = (unsigned char)t->nos[f].rotulo[0];
+        int total = conferirTrie(t, f);
+        if (total <= 0) {
+            return -1;
+        }
+        soma += total;
+    }
+    return soma == n->total ? soma : -1;
+}
+
+// Confere a skip list: cada nivel em ordem de nome, formado so por nos que tem aquele
+// nivel e subsequencia do nivel 0; o nivel 0 tem 'tamanho' nos e nao sobram niveis vazios.
+// Retorna 1 se tudo confere.
+static int conferirSkip(const MochilaSkip* mk) {
+    int contados = 0;
+    for (int k = 0; k < NIVEL_MAXIMO_SKIP; k++) {
+        if (k >= mk->nivel) {
+            if (mk->cabeca[k]) {
+                return 0;
             }
-            mv->tamanho--;
-            return 1;
+            continue;
+        }
+        const NoSkip* anterior = NULL;
+        const NoSkip* abaixo = mk->cabeca[0];
+        for (const NoSkip* no = mk->cabeca[k]; no; no = no->proximo[k]) {
+            if (no->nivel <= k || (anterior && compararNomes(&anterior->dados, &no->dados) > 0)) {
+                return 0;
+            }
+            while (abaixo && abaixo != no) {
+                abaixo = abaixo->proximo[0];
+            }
+            if (!abaixo) {
+                return 0;
+            }
+            contados += k == 0;
+            anterior = no;
         }
     }
-    return 0;
+    return contados == mk->tamanho && (mk->nivel == 1 || mk->cabeca[mk->nivel - 1]);
 }
 
-// Lista todos os itens no vetor.
-// Percorre e imprime cada item.
-// Complexidade: O(n).
-void listarVetor(MochilaVetor* mv) {
-    for (int i = 0; i < mv->tamanho; i++) {
-        printf("Nome: %s, Tipo: %s, Quantidade: %d\n", mv->itens[i].nome, mv->itens[i].tipo, mv->itens[i].quantidade);
+// Insere os itens gerarItem(i), i em [0, n), fora de ordem, e marca todos em presente[].
+// Retorna 1 se todas as insercoes deram certo.
+static int preencherVetorAutoteste(MochilaVetor* mv, unsigned char presente[], int n) {
+    int ok = 1;
+    Item it;
+    memset(presente, 0, (size_t)(n + EXTRAS_AUTOTESTE));
+    for (int i = 0; i < n; i++) {
+        gerarItem(&it, embaralhar(i, n));
+        ok = ok && inserirItemVetor(mv, it);
+        presente[i] = 1;
     }
+    return ok;
 }
 
-// Busca sequencial por nome no vetor.
-// Conta o numero de comparacoes realizadas.
-// Retorna o indice se encontrado, -1 caso contrario.
-// Complexidade: O(n) - percorre ate encontrar ou fim.
-int buscarSequencialVetor(MochilaVetor* mv, char* nome, int* comparacoes) {
-    *comparacoes = 0;
-    for (int i = 0; i < mv->tamanho; i++) {
-        (*comparacoes)++;
-        if (strcmp(mv->itens[i].nome, nome) == 0) {
-            return i;
+// Confere que o vetor tem exatamente os itens gerarItem(i) com presente[i] != 0,
+// i em [0, total), achando cada um pelo indice hash (e pela busca binaria, se o vetor
+// esta ordenado).
+static int conferirConteudoVetor(MochilaVetor* mv, const unsigned char presente[], int total) {
+    int esperados = 0;
+    int comparacoes;
+    Item it;
+    for (int i = 0; i < total; i++) {
+        gerarItem(&it, i);
+        esperados += presente[i] != 0;
+        int pos = buscarHashVetor(mv, it.nome, &comparacoes);
+        if ((pos != -1) != (presente[i] != 0)) {
+            return 0;
+        }
+        if (pos != -1 && (mv->itens[pos].apagado || mv->itens[pos].quantidade != it.quantidade || mv->itens[pos].tipo != it.tipo)) {
+            return 0;
+        }
+        if (mv->ordenado && (buscarBinariaVetor(mv, it.nome, &comparacoes) != -1) != (presente[i] != 0)) {
+            return 0;
         }
     }
-    return -1;
+    for (int i = 1; mv->ordenado && i < mv->tamanho; i++) {
+        if (compararNomes(&mv->itens[i - 1], &mv->itens[i]) > 0) {
+            return 0;
+        }
+    }
+    return mv->tamanho - mv->apagados == esperados;
 }
 
-// Ordena o vetor por nome usando Bubble Sort.
-// Compara strings com strcmp e troca se necessario.
-// Complexidade: O(n^2) - adequado para demonstracao, mas nao eficiente para grandes n.
-void ordenarVetor(MochilaVetor* mv) {
-    for (int i = 0; i < mv->tamanho - 1; i++) {
-        for (int j = 0; j < mv->tamanho - i - 1; j++) {
-            if (strcmp(mv->itens[j].nome, mv->itens[j + 1].nome) > 0) {
-                Item temp = mv->itens[j];
-                mv->itens[j] = mv->itens[j + 1];
-                mv->itens[j + 1] = temp;
-            }
+// Le o arquivo inteiro. Retorna o buffer (liberar com free) ou NULL se falhou.
+static unsigned char* lerArquivoInteiro(const char* caminho, size_t* tamanho) {
+    FILE* arquivo = fopen(caminho, "rb");
+    if (!arquivo) {
+        return NULL;
+    }
+    unsigned char* dados = NULL;
+    long fim = -1;
+    if (fseek(arquivo, 0, SEEK_END) == 0 && (fim = ftell(arquivo)) > 0) {
+        dados = (unsigned char*)malloc((size_t)fim);
+        rewind(arquivo);
+        if (dados && fread(dados, 1, (size_t)fim, arquivo) != (size_t)fim) {
+            free(dados);
+            dados = NULL;
         }
     }
+    fclose(arquivo);
+    *tamanho = dados ? (size_t)fim : 0;
+    return dados;
 }
 
-// Busca binaria por nome no vetor (requer ordenacao previa).
-// Conta o numero de comparacoes.
-// Retorna o indice se encontrado, -1 caso contrario.
-// Complexidade: O(log n) - muito mais eficiente que sequencial para vetores ordenados.
-int buscarBinariaVetor(MochilaVetor* mv, char* nome, int* comparacoes) {
-    *comparacoes = 0;
-    int low = 0;
-    int high = mv->tamanho - 1;
-    while (low <= high) {
-        (*comparacoes)++;
-        int mid = (low + high) / 2;
-        int cmp = strcmp(mv->itens[mid].nome, nome);
-        if (cmp == 0) {
-            return mid;
-        } else if (cmp < 0) {
-            low = mid + 1;
-        } else {
-            high = mid - 1;
-        }
+// Grava 'tamanho' bytes em 'caminho' (substituindo o arquivo). Retorna 1 se sucesso.
+static int gravarArquivoInteiro(const char* caminho, const void* dados, size_t tamanho) {
+    FILE* arquivo = fopen(caminho, "wb");
+    if (!arquivo) {
+        return 0;
     }
-    return -1;
+    int ok = fwrite(dados, 1, tamanho, arquivo) == tamanho;
+    return fclose(arquivo) == 0 && ok;
 }
 
-// Funcoes para MochilaLista
+// Recalcula a soma de verificacao de um snapshot em memoria (depois de altera-lo de
+// proposito), como salvarVetor faria.
+static void refazerSomaSnapshot(unsigned char* dados) {
+    CabecalhoArquivo* cab = (CabecalhoArquivo*)dados;
+    SomaVerificacao soma = { 0, 0 };
+    acumularSoma(&soma, dados + cab->inicioItens, (size_t)cab->quantidade * sizeof(Item));
+    acumularSoma(&soma, dados + cab->inicioTipos, (size_t)cab->quantidadeTipos * sizeof(tiposItens.nomes[0]));
+    acumularSoma(&soma, dados + cab->inicioIndice, (size_t)cab->capacidadeIndice * sizeof(SlotHash));
+    cab->soma = soma.a ^ (soma.b * 0x9E3779B97F4A7C15ull);
+}
 
-// Inicializa a mochila lista, definindo inicio como NULL.
-void initLista(MochilaLista* ml) {
-    ml->inicio = NULL;
+// Grava a copia alterada de um snapshot e tenta carrega-la em mv.
+// Retorna 1 se o arquivo foi recusado sem mexer em mv nem no dicionario de tipos.
+static int snapshotRecusado(MochilaVetor* mv, const unsigned char* dados, size_t tamanho) {
+    int tipos = tiposItens.quantidade;
+    Item* itens = mv->itens;
+    int posicoes = mv->tamanho;
+    return gravarArquivoInteiro(CORROMPIDO_AUTOTESTE, dados, tamanho)
+           && !carregarVetor(mv, CORROMPIDO_AUTOTESTE)
+           && tiposItens.quantidade == tipos && mv->itens == itens && mv->tamanho == posicoes;
 }
 
-// Insere um novo item no inicio da lista (para simplicidade e eficiencia).
-// Aloca memoria para novo no.
-// Retorna 1 se sucesso, 0 se falha na alocacao.
-// Complexidade: O(1) - insercao constante, vantagem sobre vetor em casos de redimensionamento.
-int inserirItemLista(MochilaLista* ml, Item it) {
-    No* novo = (No*)malloc(sizeof(No));
-    if (!novo) {
-        return 0; // Falha na alocacao
+// Snapshot: ida e volta e arquivos que devem ser recusados (soma, tamanho, secoes
+// que dariam a volta em 64 bits, versao desconhecida e tipo fora do dicionario).
+static int autotesteSnapshot(void) {
+    const int n = ITENS_AUTOTESTE;
+    unsigned char presente[ITENS_AUTOTESTE + EXTRAS_AUTOTESTE];
+    MochilaVetor mv, carregado;
+    initVetor(&mv);
+    initVetor(&carregado);
+    int ok = 1;
+    int passo = preencherVetorAutoteste(&mv, presente, n) && salvarVetor(&mv, ARQUIVO_AUTOTESTE)
+                && carregarVetor(&carregado, ARQUIVO_AUTOTESTE);
+    ok &= conferirAutoteste("snapshot: salvar e carregar devolvem os mesmos itens",
+                            passo && carregado.tamanho == mv.tamanho
+                            && memcmp(carregado.itens, mv.itens, (size_t)mv.tamanho * sizeof(Item)) == 0
+                            && conferirConteudoVetor(&carregado, presente, n));
+    size_t tamanho = 0;
+    unsigned char* dados = lerArquivoInteiro(ARQUIVO_AUTOTESTE, &tamanho);
+    unsigned char* copia = dados ? (unsigned char*)malloc(tamanho) : NULL;
+    if (copia) {
+        CabecalhoArquivo* cab = (CabecalhoArquivo*)copia;
+        memcpy(copia, dados, tamanho);
+        copia[cab->inicioItens + 10] ^= 1;
+        passo = snapshotRecusado(&carregado, copia, tamanho);
+        memcpy(copia, dados, tamanho);
+        passo = passo && snapshotRecusado(&carregado, copia, tamanho - 1);
+        memcpy(copia, dados, tamanho);
+        cab->inicioTipos = UINT64_MAX - ALINHAMENTO_SECAO + 1; // Soma de secoes que daria a volta
+        passo = passo && snapshotRecusado(&carregado, copia, tamanho);
+        memcpy(copia, dados, tamanho);
+        cab->versao = VERSAO_ARQUIVO + 1;
+        passo = passo && snapshotRecusado(&carregado, copia, tamanho);
+        // Soma correta, mas um item com tipo fora do dicionario do arquivo: o tipo novo
+        // do arquivo nao pode sobrar em tiposItens.
+        memcpy(copia, dados, tamanho);
+        snprintf((char*)(copia + cab->inicioTipos), sizeof(tiposItens.nomes[0]), "tipo-do-arquivo");
+        ((Item*)(copia + cab->inicioItens))[1].tipo = 200;
+        refazerSomaSnapshot(copia);
+        passo = passo && snapshotRecusado(&carregado, copia, tamanho) && buscarTipo(&tiposItens, "tipo-do-arquivo") == -1;
     }
-    novo->dados = it;
-    novo->proximo = ml->inicio;
-    ml->inicio = novo;
-    return 1;
+    ok &= conferirAutoteste("snapshot: recusa soma, tamanho, secoes, versao e tipos ruins",
+                            copia && passo && conferirConteudoVetor(&carregado, presente, n));
+    free(dados);
+    free(copia);
+    liberarVetor(&mv);
+    liberarVetor(&carregado);
+    return ok;
 }
 
-// Remove um item pelo nome.
-// Percorre a lista, ajusta ponteiros e libera memoria.
-// Retorna 1 se removido, 0 se nao encontrado.
-// Complexidade: O(n) - similar ao vetor, mas sem deslocamento de elementos.
-int removerItemLista(MochilaLista* ml, char* nome) {
-    No* atual = ml->inicio;
-    No* prev = NULL;
-    while (atual) {
-        if (strcmp(atual->dados.nome, nome) == 0) {
-            if (prev) {
-                prev->proximo = atual->proximo;
-            } else {
-                ml->inicio = atual->proximo;
-            }
-            free(atual);
-            return 1;
-        }
-        prev = atual;
-        atual = atual->proximo;
+// Diario: registros do vetor e da lista gravados sobre um snapshot, com uma queda no
+// meio do ultimo registro; um diario de outro snapshot so repete a lista.
+static int autotesteDiario(void) {
+    const int n = ITENS_AUTOTESTE;
+    unsigned char presente[ITENS_AUTOTESTE + EXTRAS_AUTOTESTE];
+    MochilaVetor mv, repetido;
+    MochilaLista ml;
+    initVetor(&mv);
+    initVetor(&repetido);
+    initLista(&ml);
+    int ok = 1;
+    int comparacoes;
+    Item it;
+    uint64_t soma = 0;
+    Diario d = { .fd = -1 };
+    remove(DIARIO_AUTOTESTE);
+    int passo = preencherVetorAutoteste(&mv, presente, n) && salvarVetor(&mv, ARQUIVO_AUTOTESTE)
+                && (soma = somaSnapshot(ARQUIVO_AUTOTESTE)) != 0 && abrirDiario(&d, DIARIO_AUTOTESTE, 4, soma);
+    int registros = 0;
+    for (int j = 0; passo && j < 10; j++) {
+        gerarItem(&it, n + j);
+        acrescentarRegistro(&d, OPERACAO_INSERIR, ESTRUTURA_VETOR, it.nome, nomeDoTipo(&tiposItens, it.tipo), it.quantidade);
+        presente[n + j] = 1;
+        registros++;
     }
-    return 0;
+    for (int i = 3; passo && i < 20; i += 5) {
+        gerarItem(&it, i);
+        acrescentarRegistro(&d, OPERACAO_REMOVER, ESTRUTURA_VETOR, it.nome, "", 0);
+        presente[i] = 0;
+        registros++;
+    }
+    for (int j = 10; passo && j < 13; j++) {
+        gerarItem(&it, n + j);
+        acrescentarRegistro(&d, OPERACAO_INSERIR, ESTRUTURA_LISTA, it.nome, nomeDoTipo(&tiposItens, it.tipo), it.quantidade);
+        registros++;
+    }
+    fecharDiario(&d);
+    const unsigned char cortado[10] = { 40, OPERACAO_INSERIR, ESTRUTURA_VETOR, 1, 0, 0, 0, 20, 'z', 'z' };
+    FILE* arquivo = passo ? fopen(DIARIO_AUTOTESTE, "ab") : NULL;
+    passo = arquivo && fwrite(cortado, 1, sizeof(cortado), arquivo) == sizeof(cortado) && d.falhas == 0;
+    if (arquivo) {
+        passo = fclose(arquivo) == 0 && passo;
+    }
+    passo = passo && carregarVetor(&repetido, ARQUIVO_AUTOTESTE)
+            && repetirDiario(DIARIO_AUTOTESTE, soma, &repetido, &ml) == registros;
+    for (int j = 10; passo && j < 13; j++) {
+        gerarItem(&it, n + j);
+        passo = buscarSequencialLista(&ml, it.nome, &comparacoes) == 12 - j; // Cada insercao vai para o inicio
+    }
+    ok &= conferirAutoteste("diario: repete ate o registro cortado pela queda",
+                            passo && conferirConteudoVetor(&repetido, presente, n + EXTRAS_AUTOTESTE));
+    liberarVetor(&repetido);
+    liberarLista(&ml);
+    initVetor(&repetido);
+    initLista(&ml);
+    passo = carregarVetor(&repetido, ARQUIVO_AUTOTESTE) && repetirDiario(DIARIO_AUTOTESTE, soma + 1, &repetido, &ml) == 3;
+    ok &= conferirAutoteste("diario: de outro snapshot so repete a lista", passo && repetido.tamanho == n);
+    liberarVetor(&mv);
+    liberarVetor(&repetido);
+    liberarLista(&ml);
+    return ok;
 }
 
-// Lista todos os itens na lista.
-// Percorre e imprime cada item.
-// Complexidade: O(n).
-void listarLista(MochilaLista* ml) {
-    No* atual = ml->inicio;
-    while (atual) {
-        printf("Nome: %s, Tipo: %s, Quantidade: %d\n", atual->dados.nome, atual->dados.tipo, atual->dados.quantidade);
-        atual = atual->proximo;
+// Lapides: remocoes no vetor ordenado, reinsercao no lugar da lapide, snapshot com
+// lapides, migracao de um snapshot da versao 1 e compactacao explicita e automatica.
+static int autotesteLapides(void) {
+    const int n = ITENS_AUTOTESTE;
+    unsigned char presente[ITENS_AUTOTESTE + EXTRAS_AUTOTESTE];
+    MochilaVetor mv, carregado, antigo;
+    initVetor(&mv);
+    initVetor(&carregado);
+    initVetor(&antigo);
+    int ok = 1;
+    Item it;
+    int passo = preencherVetorAutoteste(&mv, presente, n);
+    definirManterOrdenado(&mv, 1);
+    for (int i = 0; i < n; i += 5) {
+        gerarItem(&it, i);
+        passo = passo && removerItemVetor(&mv, it.nome);
+        presente[i] = 0;
+    }
+    ok &= conferirAutoteste("lapides: n/5 remocoes ficam marcadas, sem compactar",
+                            passo && mv.tamanho == n && mv.apagados == n / 5 && conferirConteudoVetor(&mv, presente, n));
+    gerarItem(&it, 5);
+    passo = inserirItemVetor(&mv, it);
+    presente[5] = 1;
+    ok &= conferirAutoteste("lapides: reinsercao ocupa a lapide sem deslocar",
+                            passo && mv.tamanho == n && mv.apagados == n / 5 - 1 && conferirConteudoVetor(&mv, presente, n));
+
+    passo = salvarVetor(&mv, ARQUIVO_AUTOTESTE) && carregarVetor(&carregado, ARQUIVO_AUTOTESTE);
+    ok &= conferirAutoteste("snapshot: lapides sobrevivem a ida e volta",
+                            passo && carregado.tamanho == mv.tamanho && carregado.apagados == mv.apagados
+                            && memcmp(carregado.itens, mv.itens, (size_t)mv.tamanho * sizeof(Item)) == 0
+                            && conferirConteudoVetor(&carregado, presente, n));
+
+    // Migracao: um snapshot da versao 1 (byte da lapide com lixo de preenchimento).
+    unsigned char todos[ITENS_AUTOTESTE + EXTRAS_AUTOTESTE];
+    size_t tamanho = 0;
+    unsigned char* dados = NULL;
+    passo = preencherVetorAutoteste(&antigo, todos, n);
+    if (passo && salvarVetor(&antigo, ARQUIVO_AUTOTESTE) && (dados = lerArquivoInteiro(ARQUIVO_AUTOTESTE, &tamanho))) {
+        CabecalhoArquivo* cab = (CabecalhoArquivo*)dados;
+        cab->versao = VERSAO_SEM_LAPIDE;
+        for (uint32_t i = 0; i < cab->quantidade; i++) {
+            ((Item*)(dados + cab->inicioItens))[i].apagado = 0xA5;
+        }
+        refazerSomaSnapshot(dados);
+        liberarVetor(&antigo);
+        initVetor(&antigo);
+        passo = gravarArquivoInteiro(ARQUIVO_AUTOTESTE, dados, tamanho) && carregarVetor(&antigo, ARQUIVO_AUTOTESTE)
+                && antigo.apagados == 0 && salvarVetor(&antigo, ARQUIVO_AUTOTESTE);
+        CabecalhoArquivo novo;
+        FILE* arquivo = passo ? fopen(ARQUIVO_AUTOTESTE, "rb") : NULL;
+        passo = arquivo && fread(&novo, sizeof(novo), 1, arquivo) == 1 && novo.versao == VERSAO_ARQUIVO;
+        if (arquivo) {
+            fclose(arquivo);
+        }
+    } else {
+        passo = 0;
+    }
+    ok &= conferirAutoteste("snapshot: versao 1 carrega sem lapides e regrava como 2",
+                            passo && conferirConteudoVetor(&antigo, todos, n));
+    free(dados);
+
+    // Compactacao: explicita e automatica (nunca mais de 1/PROPORCAO_LAPIDES de lapides).
+    compactarVetor(&mv);
+    ok &= conferirAutoteste("compactacao: tira as lapides e mantem a ordem",
+                            mv.apagados == 0 && mv.tamanho == n - n / 5 + 1 && mv.ordenado
+                            && conferirConteudoVetor(&mv, presente, n));
+    passo = 1;
+    for (int i = 0; i < n; i++) {
+        if (i % 5 == 1 || i % 5 == 2) {
+            gerarItem(&it, i);
+            passo = passo && removerItemVetor(&mv, it.nome);
+            passo = passo && (long long)mv.apagados * PROPORCAO_LAPIDES <= mv.tamanho;
+            presente[i] = 0;
+        }
     }
+    ok &= conferirAutoteste("compactacao automatica ao passar de 1/4 de lapides",
+                            passo && mv.tamanho < n - n / 5 && conferirConteudoVetor(&mv, presente, n));
+    liberarVetor(&mv);
+    liberarVetor(&carregado);
+    liberarVetor(&antigo);
+    return ok;
 }
 
-// Busca sequencial por nome na lista.
-// Conta o numero de comparacoes.
-// Retorna a posicao (comecando de 0) se encontrado, -1 caso contrario.
-// Complexidade: O(n) - percorre ate encontrar ou fim.
-int buscarSequencialLista(MochilaLista* ml, char* nome, int* comparacoes) {
-    *comparacoes = 0;
-    No* atual = ml->inicio;
-    int pos = 0;
-    while (atual) {
-        (*comparacoes)++;
-        if (strcmp(atual->dados.nome, nome) == 0) {
-            return pos;
+// Prefixos: a trie acompanha insercoes e remocoes num vetor fora de ordem e a busca
+// por prefixo devolve o mesmo total que uma varredura, em ordem alfabetica.
+static int autotestePrefixos(void) {
+    const int n = ITENS_AUTOTESTE;
+    unsigned char presente[ITENS_AUTOTESTE + EXTRAS_AUTOTESTE];
+    MochilaVetor mv;
+    initVetor(&mv);
+    int ok = 1;
+    Item it;
+    int passo = definirIndicePrefixos(&mv, 1) && preencherVetorAutoteste(&mv, presente, n);
+    for (int i = 0; i < n; i += 3) {
+        gerarItem(&it, i);
+        passo = passo && removerItemVetor(&mv, it.nome);
+        presente[i] = 0;
+    }
+    ok &= conferirAutoteste("trie: totais, ordem dos irmaos e nomes vivos",
+                            passo && conferirConteudoVetor(&mv, presente, n)
+                            && conferirTrie(&mv.prefixos, 0) == mv.tamanho - mv.apagados);
+    const char* prefixos[] = { "", "a", "aaab", "aaabc", "aaabmm-item", "aaabmm-itemx", "b" };
+    int posicoes[ITENS_AUTOTESTE];
+    for (int p = 0; passo && p < (int)(sizeof(prefixos) / sizeof(prefixos[0])); p++) {
+        size_t tamPrefixo = strlen(prefixos[p]);
+        int esperados = 0;
+        for (int i = 0; i < mv.tamanho; i++) {
+            esperados += !mv.itens[i].apagado && strncmp(mv.itens[i].nome, prefixos[p], tamPrefixo) == 0;
+        }
+        int maximo = p % 2 ? 8 : n; // Metade das buscas para antes de todos os resultados
+        int total = buscarPrefixoVetor(&mv, prefixos[p], posicoes, maximo);
+        passo = total == esperados;
+        for (int k = 0; passo && k < (total < maximo ? total : maximo); k++) {
+            const Item* achado = &mv.itens[posicoes[k]];
+            passo = !achado->apagado && strncmp(achado->nome, prefixos[p], tamPrefixo) == 0
+                    && (k == 0 || compararNomes(&mv.itens[posicoes[k - 1]], achado) < 0);
         }
-        pos++;
-        atual = atual->proximo;
     }
-    return -1;
+    ok &= conferirAutoteste("prefixos: mesmo total da varredura, em ordem alfabetica", passo);
+    liberarVetor(&mv);
+    return ok;
 }
 
-// Funcao auxiliar para ler um item do usuario.
-void lerItem(Item* it) {
-    printf("Digite o nome do item: ");
-    scanf("%s", it->nome);
-    printf("Digite o tipo do item: ");
-    scanf("%s", it->tipo);
-    printf("Digite a quantidade: ");
-    scanf("%d", &it->quantidade);
+// Skip list: insercoes fora de ordem, remocao de um terco e buscas de todos os nomes.
+static int autotesteSkip(void) {
+    const int n = ITENS_AUTOTESTE;
+    MochilaSkip mk;
+    initSkip(&mk);
+    int passo = 1;
+    int comparacoes;
+    Item it;
+    for (int i = 0; i < n; i++) {
+        gerarItem(&it, embaralhar(i, n));
+        passo = passo && inserirItemSkip(&mk, it);
+    }
+    for (int i = 0; i < n; i += 3) {
+        gerarItem(&it, i);
+        passo = passo && removerItemSkip(&mk, it.nome);
+    }
+    for (int i = 0; passo && i < n; i++) {
+        gerarItem(&it, i);
+        const Item* achado = buscarItemSkip(&mk, it.nome, &comparacoes);
+        passo = (achado != NULL) == (i % 3 != 0);
+    }
+    int ok = conferirAutoteste("skip list: niveis ordenados, encaixados e tamanho",
+                               passo && mk.tamanho == n - (n + 2) / 3 && conferirSkip(&mk));
+    liberarSkip(&mk);
+    return ok;
 }
 
-// Funcao auxiliar para ler um nome.
-void lerNome(char* nome) {
-    printf("Digite o nome do item: ");
-    scanf("%s", nome);
+// Executa os blocos de conferencias.
+// Retorna 1 se todas passaram, 0 caso contrario.
+int executarAutoteste(void) {
+    int ok = autotesteSnapshot();
+    ok &= autotesteDiario();
+    ok &= autotesteLapides();
+    ok &= autotestePrefixos();
+    ok &= autotesteSkip();
+    remove(ARQUIVO_AUTOTESTE);
+    remove(CORROMPIDO_AUTOTESTE);
+    remove(DIARIO_AUTOTESTE);
+    printf("Autoteste: %s\n", ok ? "ok" : "FALHOU");
+    return ok;
 }
 
-// Menu principal para operacoes em uma estrutura especifica.
-// Parametro isVetor: 1 para vetor, 0 para lista.
-void menuOperacoes(MochilaVetor* mv, MochilaLista* ml, int isVetor) {
-    int opcao;
-    do {
-        printf("\nMenu de Operacoes:\n");
-        printf("1. Inserir item\n");
-        printf("2. Remover item\n");
-        printf("3. Listar itens\n");
-        printf("4. Buscar sequencial\n");
-        if (isVetor) {
-            printf("5. Ordenar vetor\n");
-            printf("6. Buscar binaria (requer ordenacao)\n");
+// Funcao main: inicializa estruturas e apresenta menu principal para escolha de estrutura.
+// Permite alternar entre vetor, lista encadeada e lista desenrolada.
+// Comentarios destacam diferencas: vetor tem acesso rapido mas insercao/remoção custosa; lista dinamica mas acesso sequencial;
+// lista desenrolada fica no meio-termo (insercao/remocao local a um bloco, percurso quase contiguo).
+// Com o argumento --bench [nMax] executa apenas os benchmarks, sem menu.
+// Com --bench-csv [n] [repeticoes] [arquivo.csv] gera o relatorio CSV
+// (padrao: n = 100000, 5 repeticoes, CSV na saida padrao).
+// Com --stress [jogadores] [operacoes] roda o teste de carga da loja por jogador.
+// Com --autoteste roda as conferencias de executarAutoteste (sem menu).
+// Com --estatisticas [arquivo.csv] grava os contadores e latencias ao sair do menu.
+int main(int argc, char* argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--autoteste") == 0) {
+        int ok = executarAutoteste();
+        liberarDicionario(&tiposItens);
+        return ok ? 0 : 1;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "--stress") == 0) {
+        int jogadores = argc > 2 ? atoi(argv[2]) : 10000;
+        int operacoes = argc > 3 ? atoi(argv[3]) : 200000;
+        if (jogadores < 1 || operacoes < 1) {
+            fprintf(stderr, "Uso: %s --stress [jogadores] [operacoes por thread]\n", argv[0]);
+            return 1;
         }
-        printf("0. Voltar\n");
-        printf("Escolha: ");
-        scanf("%d", &opcao);
+        int ok = executarStressLoja(jogadores, operacoes);
+        liberarDicionario(&tiposItens);
+        return ok ? 0 : 1;
+    }
 
-        Item it;
-        char nome[30];
-        int comparacoes;
-        int resultado;
+    if (argc > 1 && strcmp(argv[1], "--bench-csv") == 0) {
+        int n = argc > 2 ? atoi(argv[2]) : 100000;
+        int repeticoes = argc > 3 ? atoi(argv[3]) : 5;
+        if (n < 1 || repeticoes < 1) {
+            fprintf(stderr, "Uso: %s --bench-csv [n] [repeticoes] [arquivo.csv]\n", argv[0]);
+            return 1;
+        }
+        FILE* saida = stdout;
+        if (argc > 4) {
+            saida = fopen(argv[4], "w");
+            if (!saida) {
+                fprintf(stderr, "Nao foi possivel criar %s.\n", argv[4]);
+                return 1;
+            }
+        }
+        int ok = executarBenchmarkCsv(n, repeticoes, saida);
+        if (saida != stdout) {
+            fclose(saida);
+        }
+        return ok ? 0 : 1;
+    }
 
-        switch (opcao) {
-            case 1:
-                lerItem(&it);
-                if (isVetor) {
-                    if (inserirItemVetor(mv, it)) {
-                        printf("Item inserido com sucesso.\n");
-                    } else {
-                        printf("Mochila cheia.\n");
-                    }
-                } else {
-                    if (inserirItemLista(ml, it)) {
-                        printf("Item inserido com sucesso.\n");
-                    } else {
-                        printf("Falha na alocacao.\n");
-                    }
-                }
-                break;
-            case 2:
-                lerNome(nome);
-                if (isVetor) {
-                    if (removerItemVetor(mv, nome)) {
-                        printf("Item removido.\n");
-                    } else {
-                        printf("Item nao encontrado.\n");
-                    }
-                } else {
-                    if (removerItemLista(ml, nome)) {
-                        printf("Item removido.\n");
-                    } else {
-                        printf("Item nao encontrado.\n");
-                    }
-                }
-                break;
-            case 3:
-                if (isVetor) {
-                    listarVetor(mv);
-                } else {
-                    listarLista(ml);
-                }
-                break;
-            case 4:
-                lerNome(nome);
-                if (isVetor) {
-                    resultado = buscarSequencialVetor(mv, nome, &comparacoes);
-                } else {
-                    resultado = buscarSequencialLista(ml, nome, &comparacoes);
-                }
-                if (resultado != -1) {
-                    printf("Item encontrado na posicao %d.\n", resultado);
-                } else {
-                    printf("Item nao encontrado.\n");
-                }
-                printf("Numero de comparacoes: %d\n", comparacoes);
-                break;
-            case 5:
-                if (isVetor) {
-                    ordenarVetor(mv);
-                    printf("Vetor ordenado por nome.\n");
-                }
-                break;
-            case 6:
-                if (isVetor) {
-                    lerNome(nome);
-                    resultado = buscarBinariaVetor(mv, nome, &comparacoes);
-                    if (resultado != -1) {
-                        printf("Item encontrado na posicao %d.\n", resultado);
-                    } else {
-                        printf("Item nao encontrado.\n");
-                    }
-                    printf("Numero de comparacoes: %d\n", comparacoes);
-                }
-                break;
-            case 0:
-                break;
-            default:
-                printf("Opcao invalida.\n");
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        int nMax = argc > 2 ? atoi(argv[2]) : 1000000;
+        if (nMax < 1) {
+            fprintf(stderr, "Uso: %s --bench [nMax]\n", argv[0]);
+            return 1;
         }
-    } while (opcao != 0);
-}
+        benchmarkInsercaoVetor(nMax);
+        benchmarkBuscasVetor(nMax);
+        benchmarkPoolLista(nMax);
+        benchmarkPercursos(nMax);
+        benchmarkManterOrdenado(nMax);
+        benchmarkRemocoes(nMax);
+        benchmarkEytzinger(nMax);
+        benchmarkColunas(nMax);
+        benchmarkArquivo(nMax);
+        benchmarkDiario(nMax);
+        benchmarkPrefixos(nMax);
+        return 0;
+    }
+
+    int intervaloDiario = INTERVALO_DIARIO_PADRAO;
+    const char* arquivoEstatisticas = NULL;
+    for (int i = 1; i < argc; i += 2) {
+        if (strcmp(argv[i], "--intervalo-diario") == 0 && i + 1 < argc && atoi(argv[i + 1]) >= 1) {
+            intervaloDiario = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--estatisticas") == 0 && i + 1 < argc) {
+            arquivoEstatisticas = argv[i + 1];
+        } else {
+            fprintf(stderr, "Uso: %s [--intervalo-diario registros por fsync] [--estatisticas arquivo.csv]\n", argv[0]);
+            return 1;
+        }
+    }
 
-// Funcao main: inicializa estruturas e apresenta menu principal para escolha de estrutura.
-// Permite alternar entre vetor e lista.
-// Comentarios destacam diferencas: vetor tem acesso rapido mas insercao/remoção custosa; lista dinamica mas acesso sequencial.
-int main() {
     MochilaVetor mv;
     MochilaLista ml;
+    MochilaDesenrolada md;
+    MochilaSoA ms;
+    MochilaSkip mk;
     initVetor(&mv);
     initLista(&ml);
+    initDesenrolada(&md);
+    initSoA(&ms);
+    initSkip(&mk);
+
+    // Recupera o vetor e a lista da execucao anterior: snapshot + diario, depois
+    // compacta para comecar com um diario vazio. Um snapshot que existe mas nao carrega
+    // (e o diario, cujos registros do vetor dependem dele) ou um diario invalido sao
+    // guardados como *.corrompido antes: a compactacao nunca os sobrescreve.
+    // O diario e sempre repetido: a soma do snapshot no cabecalho decide o que se aplica
+    // (sem um snapshot valido, so os registros da lista).
+    uint64_t soma = 0;
+    int snapshotRuim = 0;
+    if (carregarVetor(&mv, ARQUIVO_SNAPSHOT)) {
+        soma = somaSnapshot(ARQUIVO_SNAPSHOT);
+    } else if (!arquivoAusente(ARQUIVO_SNAPSHOT)) {
+        printf("Aviso: snapshot %s ilegivel (corrompido ou de versao desconhecida).\n", ARQUIVO_SNAPSHOT);
+        snapshotRuim = 1;
+    }
+    definirIndicePrefixos(&mv, 1); // Autocompletar no menu; os benchmarks medem sem ele
+    long long repetidos = repetirDiario(ARQUIVO_DIARIO, soma, &mv, &ml);
+    if (repetidos == -1) {
+        printf("Aviso: diario %s invalido.\n", ARQUIVO_DIARIO);
+    } else if (repetidos > 0) {
+        printf("%lld operacoes recuperadas do diario.\n", repetidos);
+    }
+    int preservado = !snapshotRuim || separarCorrompido(ARQUIVO_SNAPSHOT);
+    if (preservado && (snapshotRuim || repetidos == -1)) {
+        preservado = separarCorrompido(ARQUIVO_DIARIO);
+    }
+    if (!preservado) {
+        printf("Aviso: nao foi possivel renomear os arquivos ilegiveis; eles nao serao alterados.\n");
+    }
+    if (!preservado || !abrirDiario(&diario, ARQUIVO_DIARIO, intervaloDiario, soma) || !compactarDiario(&diario, ARQUIVO_SNAPSHOT, &mv, &ml)) {
+        printf("Aviso: diario indisponivel, as operacoes nao serao persistidas.\n");
+    }
 
     int escolha;
     do {
         printf("\nEscolha a estrutura:\n");
         printf("1. Mochila com Vetor\n");
         printf("2. Mochila com Lista Encadeada\n");
+        printf("3. Mochila com Lista Desenrolada (blocos de itens)\n");
+        printf("4. Mochila Colunar (um array por campo)\n");
+        printf("5. Mochila com Skip List (ordenada por nome)\n");
+        printf("6. Estatisticas (contadores e latencias por operacao)\n");
         printf("0. Sair\n");
         printf("Escolha: ");
         scanf("%d", &escolha);
 
         switch (escolha) {
             case 1:
-                menuOperacoes(&mv, &ml, 1);
+                menuOperacoes(&mv, &ml, &md, &ms, &mk, ESTRUTURA_VETOR);
                 break;
             case 2:
-                menuOperacoes(&mv, &ml, 0);
+                menuOperacoes(&mv, &ml, &md, &ms, &mk, ESTRUTURA_LISTA);
+                break;
+            case 3:
+                menuOperacoes(&mv, &ml, &md, &ms, &mk, ESTRUTURA_DESENROLADA);
+                break;
+            case 4:
+                menuOperacoes(&mv, &ml, &md, &ms, &mk, ESTRUTURA_SOA);
+                break;
+            case 5:
+                menuOperacoes(&mv, &ml, &md, &ms, &mk, ESTRUTURA_SKIP);
+                break;
+            case 6:
+                mostrarEstatisticas();
                 break;
             case 0:
                 break;
@@ -354,13 +5098,25 @@ int main() {
         }
     } while (escolha != 0);
 
-    // Libera memoria da lista ao final (boa pratica, embora nao obrigatorio aqui).
-    No* atual = ml.inicio;
-    while (atual) {
-        No* temp = atual;
-        atual = atual->proximo;
-        free(temp);
+    if (diario.fd >= 0) {
+        if (!compactarDiario(&diario, ARQUIVO_SNAPSHOT, &mv, &ml)) {
+            printf("Aviso: falha ao compactar o diario; ele sera repetido na proxima execucao.\n");
+        }
+        fecharDiario(&diario);
+        avisarFalhasDiario(&diario);
     }
+    liberarVetor(&mv);
 
+    // Libera memoria das listas ao final (boa pratica, embora nao obrigatorio aqui).
+    liberarLista(&ml);
+    liberarDesenrolada(&md);
+    liberarSoA(&ms);
+    liberarSkip(&mk);
+    liberarDicionario(&tiposItens);
+
+    if (arquivoEstatisticas && !exportarEstatisticas(arquivoEstatisticas)) {
+        fprintf(stderr, "Nao foi possivel gravar as estatisticas em %s.\n", arquivoEstatisticas);
+        return 1;
+    }
     return 0;
 }
\ No newline at end of file
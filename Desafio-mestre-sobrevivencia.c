@@ -1,145 +1,3405 @@
+#define _POSIX_C_SOURCE 200809L // Com -std=c11: pthreads da ordenacao paralela, clock_gettime, strnlen, fsync, fdatasync e fileno
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <limits.h>
 #include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Estatisticas de execucao: quantas insercoes, remocoes, buscas e ordenacoes
+// foram feitas, quantas comparacoes, itens movidos e alocacoes elas custaram e,
+// por operacao, um histograma de latencias medidas com o relogio monotono.
+// O histograma usa baldes em potencias de 2: o balde b conta as latencias em
+// [2^b, 2^(b+1)) ns e o ultimo tambem guarda as maiores.
+// As medicoes passam pelas macros ESTAT_*; compilando com -DSEM_ESTATISTICAS
+// elas nao leem o relogio nem tocam nos contadores.
+// Copia do bloco de Desafio-aventureiro-sobrevivencia.c, que e a referencia (cada desafio
+// compila sozinho, sem cabecalho comum): altere la e replique aqui.
+typedef enum {
+    OP_INSERIR,
+    OP_REMOVER,
+    OP_BUSCAR,
+    OP_ORDENAR,
+    NUM_OPERACOES
+} OperacaoMedida;
+
+#define BALDES_LATENCIA 32
+
+typedef struct {
+    long long operacoes[NUM_OPERACOES];
+    long long nanossegundos[NUM_OPERACOES]; // Soma das latencias, para a media
+    long long latencias[NUM_OPERACOES][BALDES_LATENCIA];
+    long long comparacoes;
+    long long movimentos;
+    long long alocacoes;
+} Estatisticas;
+
+// Contadores do programa. As alocacoes podem vir de varias threads e sao somadas
+// com atomicos relaxados; as latencias so sao registradas pela thread do menu.
+Estatisticas estatisticas;
+const char* nomesOperacoes[NUM_OPERACOES] = { "inserir", "remover", "buscar", "ordenar" };
+
+#ifndef SEM_ESTATISTICAS
+// Relogio monotono em nanossegundos (nao anda para tras se o relogio do sistema for ajustado).
+static inline uint64_t relogioNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Conta uma operacao e coloca sua latencia no balde da potencia de 2 correspondente.
+// Complexidade: O(1).
+static void registrarLatencia(OperacaoMedida op, uint64_t ns) {
+    int balde = 63 - __builtin_clzll(ns | 1);
+    if (balde >= BALDES_LATENCIA) {
+        balde = BALDES_LATENCIA - 1;
+    }
+    estatisticas.operacoes[op]++;
+    estatisticas.nanossegundos[op] += (long long)ns;
+    estatisticas.latencias[op][balde]++;
+}
+
+#define ESTAT_INICIAR(t) ((t) = relogioNs())
+#define ESTAT_REGISTRAR(op, t) registrarLatencia((op), relogioNs() - (t))
+#define ESTAT_SOMAR(campo, n) __atomic_fetch_add(&estatisticas.campo, (long long)(n), __ATOMIC_RELAXED)
+#else
+#define ESTAT_INICIAR(t) ((t) = 0)
+#define ESTAT_REGISTRAR(op, t) ((void)(op), (void)(t))
+#define ESTAT_SOMAR(campo, n) ((void)(n))
+#endif
+
+// Funcao para mostrar as estatisticas: contadores e, para cada operacao feita,
+// a latencia media e os baldes nao vazios do histograma.
+void mostrarEstatisticas() {
+#ifdef SEM_ESTATISTICAS
+    printf("Estatisticas desligadas na compilacao (-DSEM_ESTATISTICAS).\n");
+#else
+    printf("\n--- Estatisticas ---\n");
+    printf("Comparacoes: %lld | Itens movidos: %lld | Alocacoes: %lld\n", estatisticas.comparacoes, estatisticas.movimentos, estatisticas.alocacoes);
+    for (int op = 0; op < NUM_OPERACOES; op++) {
+        long long n = estatisticas.operacoes[op];
+        if (n == 0) {
+            continue;
+        }
+        printf("%s: %lld operacoes, media %.0f ns\n", nomesOperacoes[op], n, (double)estatisticas.nanossegundos[op] / n);
+        for (int b = 0; b < BALDES_LATENCIA; b++) {
+            if (estatisticas.latencias[op][b] > 0) {
+                printf("  ate %12llu ns: %lld\n", (1ULL << (b + 1)) - 1, estatisticas.latencias[op][b]);
+            }
+        }
+    }
+#endif
+}
+
+// Funcao para exportar as estatisticas em CSV (metrica,valor), para outros programas.
+// Os baldes aparecem como <operacao>.ate_<limite>ns, com todos os baldes listados.
+// Retorna 1 se o arquivo foi gravado, 0 caso contrario.
+int exportarEstatisticas(const char* caminho) {
+    FILE* arquivo = fopen(caminho, "w");
+    if (!arquivo) {
+        return 0;
+    }
+    fprintf(arquivo, "metrica,valor\n");
+    fprintf(arquivo, "comparacoes,%lld\n", estatisticas.comparacoes);
+    fprintf(arquivo, "movimentos,%lld\n", estatisticas.movimentos);
+    fprintf(arquivo, "alocacoes,%lld\n", estatisticas.alocacoes);
+    for (int op = 0; op < NUM_OPERACOES; op++) {
+        fprintf(arquivo, "%s.quantidade,%lld\n", nomesOperacoes[op], estatisticas.operacoes[op]);
+        fprintf(arquivo, "%s.ns_total,%lld\n", nomesOperacoes[op], estatisticas.nanossegundos[op]);
+        for (int b = 0; b < BALDES_LATENCIA; b++) {
+            fprintf(arquivo, "%s.ate_%lluns,%lld\n", nomesOperacoes[op], (1ULL << (b + 1)) - 1, estatisticas.latencias[op][b]);
+        }
+    }
+    return fclose(arquivo) == 0;
+}
+
+// Nova capacidade: 'atual' dobrada ate alcancar 'necessario' (crescimento geometrico).
+// Retorna -1 se o dobro passaria de INT_MAX, isto e, se 'necessario' nao cabe.
+static int capacidadeDobrada(int atual, int necessario) {
+    while (atual < necessario) {
+        if (atual > INT_MAX / 2) {
+            return -1;
+        }
+        atual *= 2;
+    }
+    return atual;
+}
+
+// Dicionario de tipos: cada tipo distinto e guardado uma unica vez e identificado
+// por um id pequeno (ordem de chegada). ordem[id] e a posicao alfabetica do tipo,
+// entao comparar tipos e comparar dois inteiros e a ordem continua a de strcmp.
+#define MAX_TIPOS 256 // Os ids cabem em um uint8_t
+typedef struct {
+    char (*nomes)[20];
+    int* ordem;
+    int quantidade;
+    int capacidade;
+} DicionarioTipos;
+
+// Dicionario unico do programa: os ids guardados nos componentes se referem a ele.
+DicionarioTipos tiposComponentes;
 
 // Definicao da struct Componente, que representa um componente da torre.
 // Contem nome, tipo e prioridade (1 a 10).
+// prefixoNome e um cache dos 8 primeiros bytes do nome (ver normalizarComponente):
+// a maioria das comparacoes de nome vira uma unica comparacao de inteiros.
+// O tipo e o id em tiposComponentes (1 byte em vez de 20).
 typedef struct {
+    uint64_t prefixoNome;
     char nome[30];
-    char tipo[20];
+    uint8_t tipo;
     int prioridade;
 } Componente;
 
-// Funcao para ler um componente do usuario.
-// Usa fgets para capturar strings com seguranca, removendo newline.
-void lerComponente(Componente* comp) {
-    printf("Digite o nome do componente: ");
-    fgets(comp->nome, 30, stdin);
-    comp->nome[strcspn(comp->nome, "\n")] = 0; // Remove newline
+#define MAX_COMPONENTES 20 // Capacidade da torre no menu
+
+// Criterios (chaves) de ordenacao disponiveis para os algoritmos genericos.
+typedef enum {
+    CRITERIO_NOME = 1,
+    CRITERIO_TIPO,
+    CRITERIO_PRIORIDADE
+} CriterioOrdenacao;
+
+// Prefixo normalizado de uma string: ate 8 bytes em big-endian, completado com zeros.
+uint64_t prefixoTexto(const char* texto) {
+    uint64_t prefixo = 0;
+    int fim = 0;
+    for (int i = 0; i < 8; i++) {
+        if (!fim && texto[i] == '\0') {
+            fim = 1;
+        }
+        prefixo = (prefixo << 8) | (fim ? 0 : (unsigned char)texto[i]);
+    }
+    return prefixo;
+}
+
+// Libera a memoria do dicionario.
+void liberarDicionario(DicionarioTipos* dic) {
+    free(dic->nomes);
+    free(dic->ordem);
+    dic->nomes = NULL;
+    dic->ordem = NULL;
+    dic->quantidade = 0;
+    dic->capacidade = 0;
+}
+
+// Id de um tipo ja conhecido.
+// Retorna o id, ou -1 se o tipo nunca foi inserido.
+// Complexidade: O(t), com t tipos distintos (poucos na pratica).
+int buscarTipo(const DicionarioTipos* dic, const char* tipo) {
+    for (int i = 0; i < dic->quantidade; i++) {
+        if (strcmp(dic->nomes[i], tipo) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Id do tipo, inserindo-o no dicionario se for novo (e reposicionando a ordem alfabetica).
+// Retorna o id, ou -1 se falhar a alocacao ou o limite de MAX_TIPOS for atingido.
+// Complexidade: O(t).
+int internarTipo(DicionarioTipos* dic, const char* tipo) {
+    int id = buscarTipo(dic, tipo);
+    if (id != -1) {
+        return id;
+    }
+    if (dic->quantidade == MAX_TIPOS) {
+        return -1;
+    }
+    if (dic->quantidade == dic->capacidade) {
+        int nova = dic->capacidade > 0 ? dic->capacidade * 2 : 8;
+        ESTAT_SOMAR(alocacoes, 1);
+        char (*nomes)[20] = realloc(dic->nomes, (size_t)nova * sizeof(*nomes));
+        if (!nomes) {
+            return -1;
+        }
+        dic->nomes = nomes;
+        ESTAT_SOMAR(alocacoes, 1);
+        int* ordem = (int*)realloc(dic->ordem, (size_t)nova * sizeof(int));
+        if (!ordem) {
+            return -1;
+        }
+        dic->ordem = ordem;
+        dic->capacidade = nova;
+    }
+    id = dic->quantidade;
+    strncpy(dic->nomes[id], tipo, sizeof(dic->nomes[0]) - 1);
+    dic->nomes[id][sizeof(dic->nomes[0]) - 1] = '\0';
+    dic->ordem[id] = 0;
+    for (int i = 0; i < id; i++) {
+        if (strcmp(dic->nomes[i], dic->nomes[id]) < 0) {
+            dic->ordem[id]++;
+        } else {
+            dic->ordem[i]++;
+        }
+    }
+    dic->quantidade++;
+    return id;
+}
+
+// Desfaz o internarTipo que acabou de criar 'id', quando o componente que trouxe o tipo
+// nao chegou a entrar na torre: um tipo sem componentes nao deve ocupar um dos MAX_TIPOS
+// ids. So age se 'id' ainda for o ultimo do dicionario; a ordem alfabetica dos demais
+// volta a ser a de antes.
+// Complexidade: O(t).
+void descartarTipo(DicionarioTipos* dic, int id) {
+    if (id != dic->quantidade - 1) {
+        return;
+    }
+    for (int i = 0; i < id; i++) {
+        if (dic->ordem[i] > dic->ordem[id]) {
+            dic->ordem[i]--;
+        }
+    }
+    dic->quantidade--;
+}
+
+// Copia o dicionario 'origem' (nomes e ordem alfabetica) para 'destino': quem precisa
+// internar varios tipos e so aplicar o resultado se tudo der certo trabalha na copia.
+// Retorna 1 se sucesso, 0 se falhar a alocacao (destino fica vazio).
+// Complexidade: O(t).
+int copiarDicionario(DicionarioTipos* destino, const DicionarioTipos* origem) {
+    memset(destino, 0, sizeof(*destino));
+    if (origem->quantidade == 0) {
+        return 1;
+    }
+    ESTAT_SOMAR(alocacoes, 2);
+    destino->nomes = malloc((size_t)origem->capacidade * sizeof(*destino->nomes));
+    destino->ordem = (int*)malloc((size_t)origem->capacidade * sizeof(int));
+    if (!destino->nomes || !destino->ordem) {
+        liberarDicionario(destino);
+        return 0;
+    }
+    memcpy(destino->nomes, origem->nomes, (size_t)origem->quantidade * sizeof(*destino->nomes));
+    memcpy(destino->ordem, origem->ordem, (size_t)origem->quantidade * sizeof(int));
+    destino->quantidade = origem->quantidade;
+    destino->capacidade = origem->capacidade;
+    return 1;
+}
+
+// Nome legivel de um id do dicionario.
+// Complexidade: O(1).
+const char* nomeDoTipo(const DicionarioTipos* dic, int id) {
+    return dic->nomes[id];
+}
+
+// Completa o campo de texto com zeros depois do terminador, ate o fim do campo.
+static void completarComZeros(char* texto, size_t tamanho) {
+    const char* fim = (const char*)memchr(texto, '\0', tamanho);
+    size_t usados = fim ? (size_t)(fim - texto) : tamanho - 1;
+    memset(texto + usados, 0, tamanho - usados);
+}
+
+// Prepara o componente para as comparacoes rapidas: completa o nome com zeros
+// (a comparacao de largura fixa olha o campo inteiro) e atualiza o prefixo.
+// Deve ser chamada sempre que o nome for escrito.
+void normalizarComponente(Componente* comp) {
+    completarComZeros(comp->nome, sizeof(comp->nome));
+    comp->prefixoNome = prefixoTexto(comp->nome);
+}
+
+// Compara dois campos de texto de largura fixa (16 a 32 bytes) completados com zeros.
+// Da o mesmo sinal de strcmp. Com SSE2 sao duas cargas de 16 bytes por lado (a segunda
+// termina no fim do campo, sobrepondo a primeira) e o primeiro byte diferente sai da mascara.
+static int compararLarguraFixa(const char* a, const char* b, int tamanho) {
+#ifdef __SSE2__
+    __m128i a0 = _mm_loadu_si128((const __m128i*)a);
+    __m128i b0 = _mm_loadu_si128((const __m128i*)b);
+    __m128i a1 = _mm_loadu_si128((const __m128i*)(a + tamanho - 16));
+    __m128i b1 = _mm_loadu_si128((const __m128i*)(b + tamanho - 16));
+    unsigned int diferentes = ((unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(a0, b0)) ^ 0xFFFFu)
+                            | ((unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(a1, b1)) ^ 0xFFFFu) << (tamanho - 16);
+    if (diferentes == 0) {
+        return 0;
+    }
+    int i = __builtin_ctz(diferentes);
+    return (unsigned char)a[i] - (unsigned char)b[i];
+#else
+    return memcmp(a, b, (size_t)tamanho);
+#endif
+}
+
+// Compara nomes: prefixo primeiro, campo inteiro so em caso de empate.
+static inline int compararNomes(const Componente* a, const Componente* b) {
+    if (a->prefixoNome != b->prefixoNome) {
+        return a->prefixoNome < b->prefixoNome ? -1 : 1;
+    }
+    return compararLarguraFixa(a->nome, b->nome, (int)sizeof(a->nome));
+}
+
+// Compara tipos pela posicao alfabetica dos ids (sem olhar o texto).
+static inline int compararTipos(const Componente* a, const Componente* b) {
+    return tiposComponentes.ordem[a->tipo] - tiposComponentes.ordem[b->tipo];
+}
+
+// Monta em 'chave' um componente de busca so com o nome dado.
+void montarChave(Componente* chave, const char* nome) {
+    memset(chave, 0, sizeof(*chave));
+    memcpy(chave->nome, nome, strnlen(nome, sizeof(chave->nome) - 1));
+    normalizarComponente(chave);
+}
+
+// Funcao para ler um componente do usuario.
+// Usa fgets para capturar strings com seguranca, removendo newline.
+// O tipo digitado e convertido no id do dicionario de tipos; 'tipoNovo' diz se ele
+// acabou de entrar no dicionario (e deve ser descartado se o cadastro falhar).
+// Retorna 1 se sucesso, 0 se o tipo nao coube no dicionario.
+int lerComponente(Componente* comp, int* tipoNovo) {
+    char tipo[20];
+    printf("Digite o nome do componente: ");
+    fgets(comp->nome, 30, stdin);
+    comp->nome[strcspn(comp->nome, "\n")] = 0; // Remove newline
+
+    printf("Digite o tipo do componente: ");
+    fgets(tipo, 20, stdin);
+    tipo[strcspn(tipo, "\n")] = 0; // Remove newline
+
+    do {
+        printf("Digite a prioridade (1-10): ");
+        if (scanf("%d", &comp->prioridade) != 1) {
+            comp->prioridade = 0;
+        }
+        while (getchar() != '\n' && !feof(stdin)) {
+            // Descarta o resto da linha (e a entrada invalida)
+        }
+    } while ((comp->prioridade < 1 || comp->prioridade > 10) && !feof(stdin));
+    normalizarComponente(comp);
+    *tipoNovo = buscarTipo(&tiposComponentes, tipo) == -1;
+    int id = internarTipo(&tiposComponentes, tipo);
+    if (id == -1) {
+        return 0;
+    }
+    comp->tipo = (uint8_t)id;
+    return 1;
+}
+
+// Funcao para mostrar todos os componentes.
+// Percorre o array e imprime formatado.
+// Complexidade: O(n).
+void mostrarComponentes(Componente comps[], int n) {
+    for (int i = 0; i < n; i++) {
+        printf("Nome: %s, Tipo: %s, Prioridade: %d\n", comps[i].nome, nomeDoTipo(&tiposComponentes, comps[i].tipo), comps[i].prioridade);
+    }
+}
+
+// Todos os algoritmos de ordenacao seguem o mesmo contrato:
+// (array, n, &comparacoes, &movimentos), em que movimentos conta cada copia
+// de um Componente inteiro (uma troca custa 3 movimentos).
+
+// Compara prioridades (int) sem risco de overflow na subtracao.
+// Escrita com o ternario (e nao com (a > b) - (a < b)) para que, expandida num teste
+// como "< 0", o compilador a reduza a um unico compare.
+static inline int compararPrioridades(const Componente* a, const Componente* b) {
+    return a->prioridade < b->prioridade ? -1 : a->prioridade > b->prioridade;
+}
+
+// Intervalos menores que isto sao terminados com Insertion Sort no Introsort.
+#define LIMITE_INSERCAO 16
+
+// Sentido das ordenacoes geradas por DEFINIR_ORDENACOES.
+#define CRESCENTE 1
+#define DECRESCENTE (-1)
+
+// Kernels de ordenacao e busca gerados por (tipo do registro, chave, sentido).
+// DEFINIR_ORDENACOES(S, TIPO, COMPARAR, SENTIDO) gera, para arrays de TIPO, onde COMPARAR
+// e uma funcao static inline (const TIPO*, const TIPO*) que devolve <0, 0 ou >0 como strcmp:
+//   bubbleSortS, insertionSortS, selectionSortS, mergeSortS, heapSortS e introsortS,
+//   todos no contrato acima (o Merge Sort sinaliza falta de memoria com comparacoes = -1);
+//   buscaBinariaS (indice ou -1) e limiteSuperiorS (primeira posicao com elemento maior
+//   que a chave), para arrays ja ordenados pela mesma chave e no mesmo sentido.
+// Cada instancia chama COMPARAR diretamente e o SENTIDO e uma constante, entao o
+// compilador expande a comparacao dentro dos lacos: nenhuma chamada por ponteiro nem
+// switch por comparacao. No sentido DECRESCENTE os empates continuam na ordem original
+// (Bubble, Insertion e Merge Sort seguem estaveis).
+// Dentro da macro so cabem comentarios de bloco: a barra no fim da linha continuaria um //.
+#define DEFINIR_ORDENACOES(S, TIPO, COMPARAR, SENTIDO)                                                  \
+static inline int comparar##S(const TIPO* a, const TIPO* b, int* comparacoes) {                         \
+    (*comparacoes)++;                                                                                   \
+    return (SENTIDO) * COMPARAR(a, b);                                                                  \
+}                                                                                                       \
+                                                                                                        \
+static inline void trocar##S(TIPO* a, TIPO* b, int* movimentos) {                                       \
+    TIPO temp = *a;                                                                                     \
+    *a = *b;                                                                                            \
+    *b = temp;                                                                                          \
+    *movimentos += 3;                                                                                   \
+}                                                                                                       \
+                                                                                                        \
+/* Bubble Sort: bolhas os maiores para o final. O(n^2), estavel. */                                     \
+void bubbleSort##S(TIPO v[], int n, int* comparacoes, int* movimentos) {                                \
+    *comparacoes = 0;                                                                                   \
+    *movimentos = 0;                                                                                    \
+    for (int i = 0; i < n - 1; i++) {                                                                   \
+        for (int j = 0; j < n - i - 1; j++) {                                                           \
+            if (comparar##S(&v[j], &v[j + 1], comparacoes) > 0) {                                       \
+                trocar##S(&v[j], &v[j + 1], movimentos);                                                \
+            }                                                                                           \
+        }                                                                                               \
+    }                                                                                                   \
+}                                                                                                       \
+                                                                                                        \
+/* Nucleo do Insertion Sort, sem zerar os contadores (reaproveitado pelo Introsort).                    \
+   Elemento que ja esta no lugar custa uma comparacao e nenhum movimento. */                            \
+static void insertionSortIntervalo##S(TIPO v[], int n, int* comparacoes, int* movimentos) {             \
+    for (int i = 1; i < n; i++) {                                                                       \
+        if (comparar##S(&v[i - 1], &v[i], comparacoes) <= 0) {                                          \
+            continue;                                                                                   \
+        }                                                                                               \
+        TIPO key = v[i];                                                                                \
+        int j = i - 1;                                                                                  \
+        do {                                                                                            \
+            v[j + 1] = v[j];                                                                            \
+            (*movimentos)++;                                                                            \
+            j--;                                                                                        \
+        } while (j >= 0 && comparar##S(&v[j], &key, comparacoes) > 0);                                  \
+        v[j + 1] = key;                                                                                 \
+        *movimentos += 2; /* Copia para key e de volta */                                               \
+    }                                                                                                   \
+}                                                                                                       \
+                                                                                                        \
+/* Insertion Sort: insere cada elemento na sublista ordenada. O(n^2), O(n) se quase ordenado. */        \
+void insertionSort##S(TIPO v[], int n, int* comparacoes, int* movimentos) {                             \
+    *comparacoes = 0;                                                                                   \
+    *movimentos = 0;                                                                                    \
+    insertionSortIntervalo##S(v, n, comparacoes, movimentos);                                           \
+}                                                                                                       \
+                                                                                                        \
+/* Selection Sort: seleciona o menor e troca com a posicao atual. Sempre O(n^2) comparacoes. */         \
+void selectionSort##S(TIPO v[], int n, int* comparacoes, int* movimentos) {                             \
+    *comparacoes = 0;                                                                                   \
+    *movimentos = 0;                                                                                    \
+    for (int i = 0; i < n - 1; i++) {                                                                   \
+        int min_idx = i;                                                                                \
+        for (int j = i + 1; j < n; j++) {                                                               \
+            if (comparar##S(&v[j], &v[min_idx], comparacoes) < 0) {                                     \
+                min_idx = j;                                                                            \
+            }                                                                                           \
+        }                                                                                               \
+        if (min_idx != i) {                                                                             \
+            trocar##S(&v[i], &v[min_idx], movimentos);                                                  \
+        }                                                                                               \
+    }                                                                                                   \
+}                                                                                                       \
+                                                                                                        \
+/* Intercala recursivamente v[ini..fim) usando 'aux' como area temporaria. Se as duas                   \
+   metades ja estao em ordem, pula a intercalacao (O(n) em entradas ordenadas). */                      \
+static void mergeSortRec##S(TIPO v[], TIPO aux[], int ini, int fim, int* comparacoes, int* movimentos) { \
+    if (fim - ini < 2) {                                                                                \
+        return;                                                                                         \
+    }                                                                                                   \
+    int meio = ini + (fim - ini) / 2;                                                                   \
+    mergeSortRec##S(v, aux, ini, meio, comparacoes, movimentos);                                        \
+    mergeSortRec##S(v, aux, meio, fim, comparacoes, movimentos);                                        \
+    if (comparar##S(&v[meio - 1], &v[meio], comparacoes) <= 0) {                                        \
+        return;                                                                                         \
+    }                                                                                                   \
+    /* Copia so a metade esquerda; a direita e consumida no proprio array. */                           \
+    int nEsq = meio - ini;                                                                              \
+    memcpy(&aux[ini], &v[ini], (size_t)nEsq * sizeof(TIPO));                                            \
+    *movimentos += nEsq;                                                                                \
+    int i = ini, j = meio, k = ini;                                                                     \
+    while (i < meio && j < fim) {                                                                       \
+        /* Em caso de empate vem primeiro o da esquerda: e isso que o torna estavel. */                 \
+        if (comparar##S(&v[j], &aux[i], comparacoes) < 0) {                                             \
+            v[k++] = v[j++];                                                                            \
+        } else {                                                                                        \
+            v[k++] = aux[i++];                                                                          \
+        }                                                                                               \
+        (*movimentos)++;                                                                                \
+    }                                                                                                   \
+    while (i < meio) {                                                                                  \
+        v[k++] = aux[i++];                                                                              \
+        (*movimentos)++;                                                                                \
+    }                                                                                                   \
+}                                                                                                       \
+                                                                                                        \
+/* Merge Sort: O(n log n) no pior caso, estavel, O(n) de memoria extra. */                              \
+void mergeSort##S(TIPO v[], int n, int* comparacoes, int* movimentos) {                                 \
+    *comparacoes = 0;                                                                                   \
+    *movimentos = 0;                                                                                    \
+    if (n < 2) {                                                                                        \
+        return;                                                                                         \
+    }                                                                                                   \
+    ESTAT_SOMAR(alocacoes, 1);                                                                          \
+    TIPO* aux = (TIPO*)malloc((size_t)n * sizeof(TIPO));                                                \
+    if (!aux) {                                                                                         \
+        *comparacoes = -1;                                                                              \
+        return;                                                                                         \
+    }                                                                                                   \
+    mergeSortRec##S(v, aux, 0, n, comparacoes, movimentos);                                             \
+    free(aux);                                                                                          \
+}                                                                                                       \
+                                                                                                        \
+/* Desce v[i] ate restaurar o heap maximo em v[0..n). Tecnica do "buraco": o elemento                   \
+   so e gravado uma vez, na posicao final. */                                                           \
+static void descerHeap##S(TIPO v[], int i, int n, int* comparacoes, int* movimentos) {                  \
+    TIPO valor = v[i];                                                                                  \
+    (*movimentos)++;                                                                                    \
+    while (2 * i + 1 < n) {                                                                             \
+        int filho = 2 * i + 1;                                                                          \
+        if (filho + 1 < n && comparar##S(&v[filho + 1], &v[filho], comparacoes) > 0) {                  \
+            filho++;                                                                                    \
+        }                                                                                               \
+        if (comparar##S(&v[filho], &valor, comparacoes) <= 0) {                                         \
+            break;                                                                                      \
+        }                                                                                               \
+        v[i] = v[filho];                                                                                \
+        (*movimentos)++;                                                                                \
+        i = filho;                                                                                      \
+    }                                                                                                   \
+    v[i] = valor;                                                                                       \
+    (*movimentos)++;                                                                                    \
+}                                                                                                       \
+                                                                                                        \
+/* Nucleo do Heap Sort, sem zerar os contadores (reaproveitado pelo Introsort). */                      \
+static void heapSortIntervalo##S(TIPO v[], int n, int* comparacoes, int* movimentos) {                  \
+    for (int i = n / 2 - 1; i >= 0; i--) {                                                              \
+        descerHeap##S(v, i, n, comparacoes, movimentos);                                                \
+    }                                                                                                   \
+    for (int fim = n - 1; fim > 0; fim--) {                                                             \
+        trocar##S(&v[0], &v[fim], movimentos);                                                          \
+        descerHeap##S(v, 0, fim, comparacoes, movimentos);                                              \
+    }                                                                                                   \
+}                                                                                                       \
+                                                                                                        \
+/* Heap Sort: O(n log n) no pior caso, sem memoria extra (nao estavel). */                              \
+void heapSort##S(TIPO v[], int n, int* comparacoes, int* movimentos) {                                  \
+    *comparacoes = 0;                                                                                   \
+    *movimentos = 0;                                                                                    \
+    heapSortIntervalo##S(v, n, comparacoes, movimentos);                                                \
+}                                                                                                       \
+                                                                                                        \
+/* Quicksort com pivo mediana-de-tres e limite de profundidade; ao estourar o limite                    \
+   cai para Heap Sort e termina os intervalos pequenos com Insertion Sort. */                           \
+static void introsortRec##S(TIPO v[], int n, int profundidade, int* comparacoes, int* movimentos) {     \
+    while (n > LIMITE_INSERCAO) {                                                                       \
+        if (profundidade == 0) {                                                                        \
+            heapSortIntervalo##S(v, n, comparacoes, movimentos);                                        \
+            return;                                                                                     \
+        }                                                                                               \
+        profundidade--;                                                                                 \
+        int meio = n / 2;                                                                               \
+        if (comparar##S(&v[meio], &v[0], comparacoes) < 0) {                                            \
+            trocar##S(&v[meio], &v[0], movimentos);                                                     \
+        }                                                                                               \
+        if (comparar##S(&v[n - 1], &v[meio], comparacoes) < 0) {                                        \
+            trocar##S(&v[n - 1], &v[meio], movimentos);                                                 \
+            if (comparar##S(&v[meio], &v[0], comparacoes) < 0) {                                        \
+                trocar##S(&v[meio], &v[0], movimentos);                                                 \
+            }                                                                                           \
+        }                                                                                               \
+        TIPO pivo = v[meio];                                                                            \
+        (*movimentos)++;                                                                                \
+        /* Particao de Hoare: iguais ao pivo ficam dos dois lados (chaves repetidas                     \
+           nao levam ao caso quadratico). */                                                            \
+        int i = 0, j = n - 1;                                                                           \
+        while (1) {                                                                                     \
+            do {                                                                                        \
+                i++;                                                                                    \
+            } while (comparar##S(&v[i], &pivo, comparacoes) < 0);                                       \
+            do {                                                                                        \
+                j--;                                                                                    \
+            } while (comparar##S(&v[j], &pivo, comparacoes) > 0);                                       \
+            if (i >= j) {                                                                               \
+                break;                                                                                  \
+            }                                                                                           \
+            trocar##S(&v[i], &v[j], movimentos);                                                        \
+        }                                                                                               \
+        /* Recursao na parte menor e laco na maior: pilha O(log n). */                                  \
+        int nEsq = j + 1;                                                                               \
+        if (nEsq < n - nEsq) {                                                                          \
+            introsortRec##S(v, nEsq, profundidade, comparacoes, movimentos);                            \
+            v += nEsq;                                                                                  \
+            n -= nEsq;                                                                                  \
+        } else {                                                                                        \
+            introsortRec##S(v + nEsq, n - nEsq, profundidade, comparacoes, movimentos);                 \
+            n = nEsq;                                                                                   \
+        }                                                                                               \
+    }                                                                                                   \
+    insertionSortIntervalo##S(v, n, comparacoes, movimentos);                                           \
+}                                                                                                       \
+                                                                                                        \
+/* Introsort: O(n log n) no pior caso, sem memoria extra (nao estavel). */                              \
+void introsort##S(TIPO v[], int n, int* comparacoes, int* movimentos) {                                 \
+    *comparacoes = 0;                                                                                   \
+    *movimentos = 0;                                                                                    \
+    int profundidade = 0;                                                                               \
+    for (int k = n; k > 1; k >>= 1) {                                                                   \
+        profundidade += 2; /* 2 * log2(n) */                                                            \
+    }                                                                                                   \
+    introsortRec##S(v, n, profundidade, comparacoes, movimentos);                                       \
+}                                                                                                       \
+                                                                                                        \
+/* Busca binaria: indice de um elemento igual a chave, ou -1. O(log n). */                              \
+int buscaBinaria##S(const TIPO v[], int n, const TIPO* chave, int* comparacoes) {                       \
+    *comparacoes = 0;                                                                                   \
+    int low = 0;                                                                                        \
+    int high = n - 1;                                                                                   \
+    while (low <= high) {                                                                               \
+        int mid = low + (high - low) / 2;                                                               \
+        int cmp = comparar##S(&v[mid], chave, comparacoes);                                             \
+        if (cmp == 0) {                                                                                 \
+            return mid;                                                                                 \
+        } else if (cmp < 0) {                                                                           \
+            low = mid + 1;                                                                              \
+        } else {                                                                                        \
+            high = mid - 1;                                                                             \
+        }                                                                                               \
+    }                                                                                                   \
+    return -1;                                                                                          \
+}                                                                                                       \
+                                                                                                        \
+/* Primeira posicao cujo elemento e maior que a chave (n se nenhum): inserir ali mantem                 \
+   a ordem e deixa a chave depois dos iguais. O(log n). */                                              \
+int limiteSuperior##S(const TIPO v[], int n, const TIPO* chave, int* comparacoes) {                     \
+    *comparacoes = 0;                                                                                   \
+    int low = 0, high = n;                                                                              \
+    while (low < high) {                                                                                \
+        int mid = low + (high - low) / 2;                                                               \
+        if (comparar##S(&v[mid], chave, comparacoes) <= 0) {                                            \
+            low = mid + 1;                                                                              \
+        } else {                                                                                        \
+            high = mid;                                                                                 \
+        }                                                                                               \
+    }                                                                                                   \
+    return low;                                                                                         \
+}
+
+// Instancias para os componentes: uma por chave (e prioridade tambem do maior para o menor).
+// Geram, entre outras, bubbleSortNome, insertionSortTipo, selectionSortPrioridade,
+// mergeSortNome, introsortTipo, heapSortPrioridade e introsortPrioridadeDecrescente.
+DEFINIR_ORDENACOES(Nome, Componente, compararNomes, CRESCENTE)
+DEFINIR_ORDENACOES(Tipo, Componente, compararTipos, CRESCENTE)
+DEFINIR_ORDENACOES(Prioridade, Componente, compararPrioridades, CRESCENTE)
+DEFINIR_ORDENACOES(PrioridadeDecrescente, Componente, compararPrioridades, DECRESCENTE)
+
+// Compara dois componentes pelo criterio escolhido e conta a comparacao.
+// Retorna <0, 0 ou >0 como strcmp (prioridade em ordem crescente, como no Selection Sort).
+// Usada onde o criterio so e conhecido em tempo de execucao (visoes ordenadas);
+// as ordenacoes usam os kernels especializados acima.
+int compararComponentes(const Componente* a, const Componente* b, CriterioOrdenacao criterio, int* comparacoes) {
+    (*comparacoes)++;
+    switch (criterio) {
+        case CRITERIO_NOME:
+            return compararNomes(a, b);
+        case CRITERIO_TIPO:
+            return compararTipos(a, b);
+        default:
+            return compararPrioridades(a, b);
+    }
+}
+
+// Merge Sort (estavel) por qualquer criterio: escolhe o kernel da chave uma unica vez.
+// Retorna 1 se sucesso, 0 se falha ao alocar a area temporaria.
+// Complexidade: O(n log n) no pior caso, O(n) de memoria extra.
+int mergeSort(Componente comps[], int n, CriterioOrdenacao criterio, int* comparacoes, int* movimentos) {
+    switch (criterio) {
+        case CRITERIO_NOME:
+            mergeSortNome(comps, n, comparacoes, movimentos);
+            break;
+        case CRITERIO_TIPO:
+            mergeSortTipo(comps, n, comparacoes, movimentos);
+            break;
+        default:
+            mergeSortPrioridade(comps, n, comparacoes, movimentos);
+            break;
+    }
+    return *comparacoes >= 0;
+}
+
+// Pool de threads e Merge Sort paralelo
+//
+// O pool mantem numThreads - 1 threads paradas numa variavel de condicao; quem chama
+// executarNoPool faz o papel da thread 0. Cada tarefa roda tarefa(arg, i) uma vez para
+// cada i em [0, numThreads) e executarNoPool so volta quando todas terminaram, entao
+// cada chamada funciona como uma fase seguida de barreira.
+#define MAX_THREADS_ORDENACAO 64
+#define LIMITE_PARALELO 8192 // Abaixo disto acordar as threads custa mais que ordenar
+// A torre do menu tem no maximo MAX_COMPONENTES, bem abaixo do limite, entao o menu nao
+// oferece o Merge Sort paralelo: ele so roda no --bench (benchmarkParalelo), com n grande.
+
+struct PoolThreads;
+
+typedef struct {
+    struct PoolThreads* pool;
+    int indice;
+} ArgumentoThread;
+
+typedef struct PoolThreads {
+    pthread_t threads[MAX_THREADS_ORDENACAO];
+    ArgumentoThread argumentos[MAX_THREADS_ORDENACAO];
+    int numThreads;
+    pthread_mutex_t trava;
+    pthread_cond_t temTarefa;
+    pthread_cond_t terminou;
+    void (*tarefa)(void* arg, int indice);
+    void* arg;
+    unsigned int geracao; // Incrementa a cada tarefa publicada
+    int pendentes;        // Threads do pool que ainda nao terminaram a tarefa atual
+    int encerrar;
+} PoolThreads;
+
+// Laco de cada thread do pool: espera uma geracao nova, executa sua parte e avisa.
+static void* loopThread(void* p) {
+    ArgumentoThread* a = (ArgumentoThread*)p;
+    PoolThreads* pool = a->pool;
+    unsigned int vista = 0;
+    pthread_mutex_lock(&pool->trava);
+    for (;;) {
+        while (!pool->encerrar && pool->geracao == vista) {
+            pthread_cond_wait(&pool->temTarefa, &pool->trava);
+        }
+        if (pool->encerrar) {
+            break;
+        }
+        vista = pool->geracao;
+        void (*tarefa)(void*, int) = pool->tarefa;
+        void* arg = pool->arg;
+        pthread_mutex_unlock(&pool->trava);
+        tarefa(arg, a->indice);
+        pthread_mutex_lock(&pool->trava);
+        if (--pool->pendentes == 0) {
+            pthread_cond_signal(&pool->terminou);
+        }
+    }
+    pthread_mutex_unlock(&pool->trava);
+    return NULL;
+}
+
+// Cria o pool com 'numThreads' threads no total (limitado a MAX_THREADS_ORDENACAO).
+// Retorna 1 se sucesso, 0 se nenhuma thread extra pode ser criada
+// (com numThreads = 1 nao cria thread nenhuma e sempre tem sucesso).
+int iniciarPool(PoolThreads* pool, int numThreads) {
+    if (numThreads < 1) {
+        numThreads = 1;
+    }
+    if (numThreads > MAX_THREADS_ORDENACAO) {
+        numThreads = MAX_THREADS_ORDENACAO;
+    }
+    pthread_mutex_init(&pool->trava, NULL);
+    pthread_cond_init(&pool->temTarefa, NULL);
+    pthread_cond_init(&pool->terminou, NULL);
+    pool->geracao = 0;
+    pool->pendentes = 0;
+    pool->encerrar = 0;
+    pool->numThreads = 1;
+    for (int i = 1; i < numThreads; i++) {
+        pool->argumentos[i].pool = pool;
+        pool->argumentos[i].indice = i;
+        if (pthread_create(&pool->threads[i], NULL, loopThread, &pool->argumentos[i]) != 0) {
+            break; // Segue com as threads que conseguiu criar
+        }
+        pool->numThreads++;
+    }
+    return pool->numThreads == numThreads || pool->numThreads > 1;
+}
+
+// Executa tarefa(arg, i) para i = 0..numThreads-1 em paralelo e espera todas.
+void executarNoPool(PoolThreads* pool, void (*tarefa)(void*, int), void* arg) {
+    if (pool->numThreads > 1) {
+        pthread_mutex_lock(&pool->trava);
+        pool->tarefa = tarefa;
+        pool->arg = arg;
+        pool->pendentes = pool->numThreads - 1;
+        pool->geracao++;
+        pthread_cond_broadcast(&pool->temTarefa);
+        pthread_mutex_unlock(&pool->trava);
+    }
+    tarefa(arg, 0);
+    if (pool->numThreads > 1) {
+        pthread_mutex_lock(&pool->trava);
+        while (pool->pendentes > 0) {
+            pthread_cond_wait(&pool->terminou, &pool->trava);
+        }
+        pthread_mutex_unlock(&pool->trava);
+    }
+}
+
+// Encerra e junta as threads do pool.
+void encerrarPool(PoolThreads* pool) {
+    pthread_mutex_lock(&pool->trava);
+    pool->encerrar = 1;
+    pthread_cond_broadcast(&pool->temTarefa);
+    pthread_mutex_unlock(&pool->trava);
+    for (int i = 1; i < pool->numThreads; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pthread_mutex_destroy(&pool->trava);
+    pthread_cond_destroy(&pool->temTarefa);
+    pthread_cond_destroy(&pool->terminou);
+    pool->numThreads = 1;
+}
+
+// Estado compartilhado de uma ordenacao paralela. Cada thread so escreve na sua
+// faixa de 'origem'/'destino' e nos seus proprios contadores (acumulados em variaveis
+// locais e gravados uma vez no fim da fase, para nao disputar a mesma linha de cache).
+typedef struct {
+    Componente* origem;
+    Componente* destino;
+    int n;
+    int numPartes;
+    int limites[MAX_THREADS_ORDENACAO + 1]; // Inicio de cada sequencia ordenada (a ultima termina em n)
+    int numSequencias;
+    int comparacoes[MAX_THREADS_ORDENACAO];
+    int movimentos[MAX_THREADS_ORDENACAO];
+} OrdenacaoParalela;
+
+// Fases do Merge Sort paralelo geradas por chave, sobre os kernels de DEFINIR_ORDENACOES
+// (a instancia S precisa existir): ordenarPedacoS, coRankS e intercalarRodadaS.
+// Sao as tarefas entregues ao pool, entao a unica chamada indireta e uma por fase.
+//   ordenarPedacoS (fase 1): a thread i ordena (Merge Sort estavel) o seu pedaco
+//   [limites[i], limites[i+1]).
+//   coRankS: quantos elementos de a[0..nA) entram nas k primeiras posicoes da intercalacao
+//   estavel de a com b (empates: a primeiro). Busca binaria no "caminho da intercalacao".
+//   intercalarRodadaS (fase 2, uma rodada): intercala as sequencias aos pares, de 'origem'
+//   para 'destino'. A saida inteira e dividida em numPartes faixas iguais; cada thread acha,
+//   com coRank, onde sua faixa comeca e termina dentro de cada par e intercala so esse trecho.
+//   Assim ate a ultima intercalacao (um unico par) usa todas as threads.
+#define DEFINIR_MERGE_PARALELO(S)                                                                       \
+static void ordenarPedaco##S(void* p, int i) {                                                          \
+    OrdenacaoParalela* o = (OrdenacaoParalela*)p;                                                       \
+    int comparacoes = 0, movimentos = 0;                                                                \
+    mergeSortRec##S(o->origem, o->destino, o->limites[i], o->limites[i + 1], &comparacoes, &movimentos); \
+    o->comparacoes[i] += comparacoes;                                                                   \
+    o->movimentos[i] += movimentos;                                                                     \
+}                                                                                                       \
+                                                                                                        \
+static int coRank##S(int k, const Componente a[], int nA, const Componente b[], int nB, int* comparacoes) { \
+    int lo = k > nB ? k - nB : 0;                                                                       \
+    int hi = k < nA ? k : nA;                                                                           \
+    while (lo < hi) {                                                                                   \
+        int i = lo + (hi - lo) / 2;                                                                     \
+        int j = k - i;                                                                                  \
+        if (j > 0 && comparar##S(&a[i], &b[j - 1], comparacoes) <= 0) {                                 \
+            lo = i + 1; /* a[i] sai antes de b[j-1]: precisa de mais elementos de a */                  \
+        } else {                                                                                        \
+            hi = i;                                                                                     \
+        }                                                                                               \
+    }                                                                                                   \
+    return lo;                                                                                          \
+}                                                                                                       \
+                                                                                                        \
+static void intercalarRodada##S(void* p, int t) {                                                       \
+    OrdenacaoParalela* o = (OrdenacaoParalela*)p;                                                       \
+    int inicioFaixa = (int)((long long)o->n * t / o->numPartes);                                        \
+    int fimFaixa = (int)((long long)o->n * (t + 1) / o->numPartes);                                     \
+    int comparacoes = 0, movimentos = 0;                                                                \
+    for (int s = 0; s < o->numSequencias; s += 2) {                                                     \
+        int ini = o->limites[s];                                                                        \
+        int meio = o->limites[s + 1];                                                                   \
+        int fim = s + 2 <= o->numSequencias ? o->limites[s + 2] : meio;                                 \
+        int de = inicioFaixa > ini ? inicioFaixa : ini;                                                 \
+        int ate = fimFaixa < fim ? fimFaixa : fim;                                                      \
+        if (de >= ate) {                                                                                \
+            continue;                                                                                   \
+        }                                                                                               \
+        const Componente* a = &o->origem[ini];                                                          \
+        const Componente* b = &o->origem[meio];                                                         \
+        int nA = meio - ini, nB = fim - meio;                                                           \
+        int i = coRank##S(de - ini, a, nA, b, nB, &comparacoes);                                        \
+        int j = de - ini - i;                                                                           \
+        int iFim = coRank##S(ate - ini, a, nA, b, nB, &comparacoes);                                    \
+        int jFim = ate - ini - iFim;                                                                    \
+        Componente* saida = &o->destino[de];                                                            \
+        while (i < iFim && j < jFim) {                                                                  \
+            if (comparar##S(&b[j], &a[i], &comparacoes) < 0) {                                          \
+                *saida++ = b[j++];                                                                      \
+            } else {                                                                                    \
+                *saida++ = a[i++];                                                                      \
+            }                                                                                           \
+        }                                                                                               \
+        while (i < iFim) {                                                                              \
+            *saida++ = a[i++];                                                                          \
+        }                                                                                               \
+        while (j < jFim) {                                                                              \
+            *saida++ = b[j++];                                                                          \
+        }                                                                                               \
+        movimentos += ate - de;                                                                         \
+    }                                                                                                   \
+    o->comparacoes[t] += comparacoes;                                                                   \
+    o->movimentos[t] += movimentos;                                                                     \
+}
+
+DEFINIR_MERGE_PARALELO(Nome)
+DEFINIR_MERGE_PARALELO(Tipo)
+DEFINIR_MERGE_PARALELO(Prioridade)
+
+// Copia a faixa da thread t de 'origem' para 'destino' (resultado final no array certo).
+static void copiarFaixa(void* p, int t) {
+    OrdenacaoParalela* o = (OrdenacaoParalela*)p;
+    int ini = (int)((long long)o->n * t / o->numPartes);
+    int fim = (int)((long long)o->n * (t + 1) / o->numPartes);
+    memcpy(&o->destino[ini], &o->origem[ini], (size_t)(fim - ini) * sizeof(Componente));
+    o->movimentos[t] += fim - ini;
+}
+
+// Merge Sort paralelo (estavel) por qualquer criterio, usando as threads do pool.
+// Fase 1: cada thread ordena um pedaco de n/T componentes. Fase 2: log2(T) rodadas de
+// intercalacao em pares, alternando entre o array e a area auxiliar, com cada rodada
+// repartida igualmente entre as threads. Como as duas fases sao estaveis, o resultado e
+// identico byte a byte ao de mergeSort.
+// Comparacoes e movimentos sao a soma de todas as threads.
+// Retorna 1 se sucesso, 0 se falha ao alocar a area temporaria.
+// Complexidade: O(n log n) de trabalho, O((n/T) log n + n log T / T) por thread; O(n) de memoria extra.
+int mergeSortParalelo(PoolThreads* pool, Componente comps[], int n, CriterioOrdenacao criterio, int* comparacoes, int* movimentos) {
+    if (pool->numThreads < 2 || n < LIMITE_PARALELO) {
+        return mergeSort(comps, n, criterio, comparacoes, movimentos);
+    }
+    OrdenacaoParalela* o = (OrdenacaoParalela*)calloc(1, sizeof(OrdenacaoParalela));
+    ESTAT_SOMAR(alocacoes, 1);
+    Componente* aux = (Componente*)malloc((size_t)n * sizeof(Componente));
+    if (!o || !aux) {
+        free(o);
+        free(aux);
+        return 0;
+    }
+    // As fases da chave sao escolhidas aqui, uma vez; dentro delas a comparacao e direta.
+    void (*ordenarPedaco)(void*, int) = ordenarPedacoPrioridade;
+    void (*intercalarRodada)(void*, int) = intercalarRodadaPrioridade;
+    if (criterio == CRITERIO_NOME) {
+        ordenarPedaco = ordenarPedacoNome;
+        intercalarRodada = intercalarRodadaNome;
+    } else if (criterio == CRITERIO_TIPO) {
+        ordenarPedaco = ordenarPedacoTipo;
+        intercalarRodada = intercalarRodadaTipo;
+    }
+    o->n = n;
+    o->numPartes = pool->numThreads;
+    o->numSequencias = pool->numThreads;
+    for (int i = 0; i <= o->numSequencias; i++) {
+        o->limites[i] = (int)((long long)n * i / o->numSequencias);
+    }
+    o->origem = comps;
+    o->destino = aux;
+    executarNoPool(pool, ordenarPedaco, o);
+
+    while (o->numSequencias > 1) {
+        executarNoPool(pool, intercalarRodada, o);
+        int novas = 0;
+        for (int s = 0; s < o->numSequencias; s += 2) {
+            o->limites[novas++] = o->limites[s];
+        }
+        o->limites[novas] = n;
+        o->numSequencias = novas;
+        Componente* t = o->origem;
+        o->origem = o->destino;
+        o->destino = t;
+    }
+    if (o->origem != comps) {
+        o->destino = comps;
+        executarNoPool(pool, copiarFaixa, o);
+    }
+
+    *comparacoes = 0;
+    *movimentos = 0;
+    for (int t = 0; t < pool->numThreads; t++) {
+        *comparacoes += o->comparacoes[t];
+        *movimentos += o->movimentos[t];
+    }
+    free(o);
+    free(aux);
+    return 1;
+}
+
+// Heap Sort por qualquer criterio: escolhe o kernel da chave uma unica vez.
+// Complexidade: O(n log n) no pior caso, sem memoria extra (nao estavel).
+void heapSort(Componente comps[], int n, CriterioOrdenacao criterio, int* comparacoes, int* movimentos) {
+    switch (criterio) {
+        case CRITERIO_NOME:
+            heapSortNome(comps, n, comparacoes, movimentos);
+            break;
+        case CRITERIO_TIPO:
+            heapSortTipo(comps, n, comparacoes, movimentos);
+            break;
+        default:
+            heapSortPrioridade(comps, n, comparacoes, movimentos);
+            break;
+    }
+}
+
+// Introsort por qualquer criterio: escolhe o kernel da chave uma unica vez.
+// Complexidade: O(n log n) no pior caso, sem memoria extra (nao estavel).
+void introsort(Componente comps[], int n, CriterioOrdenacao criterio, int* comparacoes, int* movimentos) {
+    switch (criterio) {
+        case CRITERIO_NOME:
+            introsortNome(comps, n, comparacoes, movimentos);
+            break;
+        case CRITERIO_TIPO:
+            introsortTipo(comps, n, comparacoes, movimentos);
+            break;
+        default:
+            introsortPrioridade(comps, n, comparacoes, movimentos);
+            break;
+    }
+}
+
+// Entrada compacta para a ordenacao por indices: os 8 primeiros bytes da chave
+// (big-endian, entao comparar inteiros = comparar strings) e a posicao original.
+// Ocupa 16 bytes contra os 48 de um Componente.
+typedef struct {
+    uint64_t prefixo;
+    uint32_t indice;
+} ChaveIndice;
+
+// Prefixo da chave do componente pelo criterio (tipo e prioridade cabem inteiros no prefixo).
+uint64_t prefixoChave(const Componente* comp, CriterioOrdenacao criterio) {
+    switch (criterio) {
+        case CRITERIO_NOME:
+            return comp->prefixoNome;
+        case CRITERIO_TIPO:
+            return (uint64_t)tiposComponentes.ordem[comp->tipo];
+        default:
+            return (uint64_t)(int64_t)comp->prioridade ^ 0x8000000000000000ull; // Preserva a ordem com sinal
+    }
+}
+
+// Compara duas entradas: primeiro o prefixo (um unico compare de inteiros) e,
+// so em caso de empate, a chave completa no registro original.
+static int compararChaves(const ChaveIndice* a, const ChaveIndice* b, const Componente comps[], CriterioOrdenacao criterio, int* comparacoes) {
+    (*comparacoes)++;
+    if (a->prefixo != b->prefixo) {
+        return a->prefixo < b->prefixo ? -1 : 1;
+    }
+    switch (criterio) {
+        case CRITERIO_NOME:
+            return compararLarguraFixa(comps[a->indice].nome, comps[b->indice].nome, (int)sizeof(comps->nome));
+        default:
+            return 0;
+    }
+}
+
+// Merge Sort recursivo sobre as entradas compactas (mesma estrutura do mergeSortRec de DEFINIR_ORDENACOES).
+static void mergeSortChavesRec(ChaveIndice chaves[], ChaveIndice aux[], int ini, int fim, const Componente comps[],
+                               CriterioOrdenacao criterio, int* comparacoes, int* movimentos) {
+    if (fim - ini < 2) {
+        return;
+    }
+    int meio = ini + (fim - ini) / 2;
+    mergeSortChavesRec(chaves, aux, ini, meio, comps, criterio, comparacoes, movimentos);
+    mergeSortChavesRec(chaves, aux, meio, fim, comps, criterio, comparacoes, movimentos);
+    if (compararChaves(&chaves[meio - 1], &chaves[meio], comps, criterio, comparacoes) <= 0) {
+        return;
+    }
+    int nEsq = meio - ini;
+    memcpy(&aux[ini], &chaves[ini], (size_t)nEsq * sizeof(ChaveIndice));
+    *movimentos += nEsq;
+    int i = ini, j = meio, k = ini;
+    while (i < meio && j < fim) {
+        if (compararChaves(&chaves[j], &aux[i], comps, criterio, comparacoes) < 0) {
+            chaves[k++] = chaves[j++];
+        } else {
+            chaves[k++] = aux[i++];
+        }
+        (*movimentos)++;
+    }
+    while (i < meio) {
+        chaves[k++] = aux[i++];
+        (*movimentos)++;
+    }
+}
+
+// Ordenacao por indices (estavel): calcula em 'ordem' a permutacao que ordena comps
+// pelo criterio, sem mover nenhum Componente. ordem[i] = posicao original do i-esimo.
+// Movimentos contam copias de ChaveIndice (16 bytes), nao de Componente.
+// Retorna 1 se sucesso, 0 se falha na alocacao.
+// Complexidade: O(n log n), O(n) de memoria extra.
+int ordenarIndices(const Componente comps[], int n, CriterioOrdenacao criterio, uint32_t ordem[], int* comparacoes, int* movimentos) {
+    *comparacoes = 0;
+    *movimentos = 0;
+    ESTAT_SOMAR(alocacoes, 1);
+    ChaveIndice* chaves = (ChaveIndice*)malloc((size_t)(n > 0 ? n : 1) * 2 * sizeof(ChaveIndice));
+    if (!chaves) {
+        return 0;
+    }
+    for (int i = 0; i < n; i++) {
+        chaves[i].prefixo = prefixoChave(&comps[i], criterio);
+        chaves[i].indice = (uint32_t)i;
+    }
+    mergeSortChavesRec(chaves, chaves + n, 0, n, comps, criterio, comparacoes, movimentos);
+    for (int i = 0; i < n; i++) {
+        ordem[i] = chaves[i].indice;
+    }
+    free(chaves);
+    return 1;
+}
+
+// Aplica a permutacao no lugar, seguindo cada ciclo uma unica vez:
+// ao final comps[i] contem o antigo comps[ordem[i]].
+// Cada Componente fora do lugar e copiado uma vez (mais uma copia por ciclo).
+// 'ordem' e consumida (vira a identidade).
+// Retorna o numero de Componentes movidos.
+// Complexidade: O(n).
+int aplicarPermutacao(Componente comps[], int n, uint32_t ordem[]) {
+    int movimentos = 0;
+    for (int i = 0; i < n; i++) {
+        if (ordem[i] == (uint32_t)i) {
+            continue;
+        }
+        Componente temp = comps[i];
+        int j = i;
+        while (ordem[j] != (uint32_t)i) {
+            int origem = (int)ordem[j];
+            comps[j] = comps[origem];
+            ordem[j] = (uint32_t)j;
+            j = origem;
+            movimentos++;
+        }
+        comps[j] = temp;
+        ordem[j] = (uint32_t)j;
+        movimentos += 2; // Copia para temp e de volta
+    }
+    return movimentos;
+}
+
+// Ordena por indices e aplica a permutacao (contrato dos demais algoritmos).
+// movimentos = Componentes movidos ao aplicar a permutacao; comparacoes = -1 se faltar memoria.
+static void indiceSort(Componente comps[], int n, CriterioOrdenacao criterio, int* comparacoes, int* movimentos) {
+    ESTAT_SOMAR(alocacoes, 1);
+    uint32_t* ordem = (uint32_t*)malloc((size_t)(n > 0 ? n : 1) * sizeof(uint32_t));
+    int movimentosIndice;
+    if (!ordem || !ordenarIndices(comps, n, criterio, ordem, comparacoes, &movimentosIndice)) {
+        free(ordem);
+        *comparacoes = -1;
+        *movimentos = 0;
+        return;
+    }
+    *movimentos = aplicarPermutacao(comps, n, ordem);
+    free(ordem);
+}
+
+// Versoes por chave dos algoritmos que nao vem de DEFINIR_ORDENACOES, no mesmo formato
+// de bubbleSortNome & cia, para medirTempoOrdenacao. Se a area temporaria nao puder ser
+// alocada o algoritmo nao ordena; isso e sinalizado com comparacoes = -1.
+// Merge Sort paralelo no pool global (o --bench o cria com 1, 2, 4 ... threads).
+PoolThreads poolOrdenacao;
+
+void mergeSortParaleloNome(Componente comps[], int n, int* comparacoes, int* movimentos) {
+    if (!mergeSortParalelo(&poolOrdenacao, comps, n, CRITERIO_NOME, comparacoes, movimentos)) {
+        *comparacoes = -1;
+    }
+}
+void mergeSortParaleloTipo(Componente comps[], int n, int* comparacoes, int* movimentos) {
+    if (!mergeSortParalelo(&poolOrdenacao, comps, n, CRITERIO_TIPO, comparacoes, movimentos)) {
+        *comparacoes = -1;
+    }
+}
+void mergeSortParaleloPrioridade(Componente comps[], int n, int* comparacoes, int* movimentos) {
+    if (!mergeSortParalelo(&poolOrdenacao, comps, n, CRITERIO_PRIORIDADE, comparacoes, movimentos)) {
+        *comparacoes = -1;
+    }
+}
+void indiceSortNome(Componente comps[], int n, int* comparacoes, int* movimentos) {
+    indiceSort(comps, n, CRITERIO_NOME, comparacoes, movimentos);
+}
+void indiceSortTipo(Componente comps[], int n, int* comparacoes, int* movimentos) {
+    indiceSort(comps, n, CRITERIO_TIPO, comparacoes, movimentos);
+}
+void indiceSortPrioridade(Componente comps[], int n, int* comparacoes, int* movimentos) {
+    indiceSort(comps, n, CRITERIO_PRIORIDADE, comparacoes, movimentos);
+}
+
+// Counting Sort por tipo: como o tipo e um id pequeno, basta contar quantos componentes
+// ha de cada tipo, somar as contagens na ordem alfabetica dos tipos e copiar cada
+// componente direto para a sua posicao final (estavel, sem nenhuma comparacao).
+// Usa um array auxiliar; se ele nao puder ser alocado, sinaliza comparacoes = -1.
+// Complexidade: O(n + t), com t tipos distintos.
+void countingSortTipo(Componente comps[], int n, int* comparacoes, int* movimentos) {
+    *comparacoes = 0;
+    *movimentos = 0;
+    ESTAT_SOMAR(alocacoes, 1);
+    Componente* aux = (Componente*)malloc((size_t)(n > 0 ? n : 1) * sizeof(Componente));
+    if (!aux) {
+        *comparacoes = -1;
+        return;
+    }
+    int inicioDaOrdem[MAX_TIPOS + 1] = { 0 };
+    for (int i = 0; i < n; i++) {
+        inicioDaOrdem[tiposComponentes.ordem[comps[i].tipo] + 1]++;
+    }
+    for (int r = 0; r < MAX_TIPOS; r++) {
+        inicioDaOrdem[r + 1] += inicioDaOrdem[r];
+    }
+    for (int i = 0; i < n; i++) {
+        aux[inicioDaOrdem[tiposComponentes.ordem[comps[i].tipo]]++] = comps[i];
+    }
+    memcpy(comps, aux, (size_t)n * sizeof(Componente));
+    *movimentos = 2 * n;
+    free(aux);
+}
+
+// Radix Sort LSD por nome. O nome e um campo de largura fixa completado com zeros
+// (normalizarComponente), entao basta uma distribuicao estavel por byte, do ultimo ao
+// primeiro: depois da passada do byte b o array esta ordenado pelos bytes b..29 e a
+// passada do byte 0 deixa a ordem de strcmp, com os empates na ordem original.
+// Os histogramas de todas as colunas saem de uma unica leitura; coluna em que todos tem
+// o mesmo byte (o fim dos nomes curtos, so zeros) nao mudaria nada e e pulada.
+// As passadas alternam entre o array e a area auxiliar, sem copia extra entre elas.
+// Usa memoria auxiliar; se ela nao puder ser alocada, sinaliza comparacoes = -1.
+// Complexidade: O(k (n + 256)) para k colunas nao triviais (k <= 30), sem comparacoes.
+void radixSortNome(Componente comps[], int n, int* comparacoes, int* movimentos) {
+    *comparacoes = 0;
+    *movimentos = 0;
+    if (n < 2) {
+        return;
+    }
+    const int colunas = (int)sizeof(comps->nome);
+    ESTAT_SOMAR(alocacoes, 2);
+    Componente* aux = (Componente*)malloc((size_t)n * sizeof(Componente));
+    int (*contagens)[256] = (int (*)[256])calloc((size_t)colunas, sizeof(*contagens));
+    if (!aux || !contagens) {
+        free(aux);
+        free(contagens);
+        *comparacoes = -1;
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        const unsigned char* nome = (const unsigned char*)comps[i].nome;
+        for (int b = 0; b < colunas; b++) {
+            contagens[b][nome[b]]++;
+        }
+    }
+
+    Componente* origem = comps;
+    Componente* destino = aux;
+    for (int b = colunas - 1; b >= 0; b--) {
+        int* inicio = contagens[b];
+        if (inicio[(unsigned char)origem[0].nome[b]] == n) {
+            continue; // Todos no mesmo balde
+        }
+        int soma = 0;
+        for (int d = 0; d < 256; d++) {
+            int quantidade = inicio[d];
+            inicio[d] = soma;
+            soma += quantidade;
+        }
+        for (int i = 0; i < n; i++) {
+            destino[inicio[(unsigned char)origem[i].nome[b]]++] = origem[i];
+        }
+        *movimentos += n;
+        Componente* t = origem;
+        origem = destino;
+        destino = t;
+    }
+    if (origem != comps) {
+        memcpy(comps, origem, (size_t)n * sizeof(Componente));
+        *movimentos += n;
+    }
+    free(contagens);
+    free(aux);
+}
+
+// Acima desta amplitude (maior - menor prioridade + 1) o Counting Sort gastaria mais
+// com o array de contagens do que com os componentes.
+#define LIMITE_FAIXA_CONTAGEM 65536
+
+// Counting Sort por prioridade: as prioridades ficam numa faixa pequena (1 a 10), entao
+// conta quantos componentes ha de cada valor entre a menor e a maior prioridade, soma as
+// contagens e copia cada componente direto para a sua posicao final (estavel, sem
+// comparacoes). A faixa e medida, entao prioridades fora de 1 a 10 tambem funcionam; se
+// ela passar de LIMITE_FAIXA_CONTAGEM, cai para o Merge Sort (tambem estavel).
+// Usa memoria auxiliar; se ela nao puder ser alocada, sinaliza comparacoes = -1.
+// Complexidade: O(n + f), com f = maior - menor prioridade + 1.
+void countingSortPrioridade(Componente comps[], int n, int* comparacoes, int* movimentos) {
+    *comparacoes = 0;
+    *movimentos = 0;
+    if (n < 2) {
+        return;
+    }
+    int menor = comps[0].prioridade, maior = comps[0].prioridade;
+    for (int i = 1; i < n; i++) {
+        if (comps[i].prioridade < menor) {
+            menor = comps[i].prioridade;
+        } else if (comps[i].prioridade > maior) {
+            maior = comps[i].prioridade;
+        }
+    }
+    long long faixa = (long long)maior - menor + 1;
+    if (faixa > LIMITE_FAIXA_CONTAGEM) {
+        mergeSortPrioridade(comps, n, comparacoes, movimentos);
+        return;
+    }
+    ESTAT_SOMAR(alocacoes, 2);
+    Componente* aux = (Componente*)malloc((size_t)n * sizeof(Componente));
+    int* inicio = (int*)calloc((size_t)faixa + 1, sizeof(int));
+    if (!aux || !inicio) {
+        free(aux);
+        free(inicio);
+        *comparacoes = -1;
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        inicio[comps[i].prioridade - menor + 1]++;
+    }
+    for (long long v = 0; v < faixa; v++) {
+        inicio[v + 1] += inicio[v];
+    }
+    for (int i = 0; i < n; i++) {
+        aux[inicio[comps[i].prioridade - menor]++] = comps[i];
+    }
+    memcpy(comps, aux, (size_t)n * sizeof(Componente));
+    *movimentos = 2 * n;
+    free(inicio);
+    free(aux);
+}
+
+// Ordenacao por varias chaves com passadas estaveis (LSD nas chaves): primeiro pela chave
+// menos importante (nome), depois prioridade e por ultimo tipo. Como cada passada preserva
+// a ordem dos empates, o resultado fica por tipo, prioridade dentro do tipo e nome dentro
+// da prioridade. Comparacoes e movimentos sao a soma das tres passadas.
+// Complexidade: O(n k), com k colunas do nome nao triviais mais as duas chaves pequenas.
+void radixSortTipoPrioridadeNome(Componente comps[], int n, int* comparacoes, int* movimentos) {
+    void (*passadas[3])(Componente[], int, int*, int*) = { radixSortNome, countingSortPrioridade, countingSortTipo };
+    *comparacoes = 0;
+    *movimentos = 0;
+    for (int p = 0; p < 3; p++) {
+        int c, m;
+        passadas[p](comps, n, &c, &m);
+        if (c < 0) {
+            *comparacoes = -1; // Falta de memoria no meio: ordem parcial
+            return;
+        }
+        *comparacoes += c;
+        *movimentos += m;
+    }
+}
+
+// Busca binaria por nome (requer array ordenado por nome).
+// Conta o numero de comparacoes.
+// Retorna indice se encontrado, -1 caso contrario.
+// Complexidade: O(log n) - divide o espaco de busca pela metade a cada passo.
+int buscaBinariaPorNome(Componente comps[], int n, char* nome, int* comparacoes) {
+    Componente chave;
+    montarChave(&chave, nome);
+    return buscaBinariaNome(comps, n, &chave, comparacoes);
+}
+
+
+// Layout de Eytzinger dos nomes de um array ordenado por nome (ver buscaEytzingerPorNome).
+// Os prefixos ficam na ordem de um percurso em largura da arvore binaria implicita:
+// raiz em 1, filhos de k em 2k e 2k + 1. Os primeiros niveis, visitados por toda busca,
+// ficam juntos (e na cache), e os 8 descendentes de k tres niveis abaixo (8k a 8k + 7)
+// ocupam uma unica linha de 64 bytes.
+typedef struct {
+    uint64_t* prefixos; // prefixos[1..tamanho]; alinhado a 64 bytes
+    int* posicoes;      // posicoes[k]: posicao no array do componente de prefixos[k]
+    int tamanho;
+} LayoutEytzinger;
+
+// Preenche a subarvore de raiz k com os proximos componentes do array, em ordem.
+// Complexidade: O(tamanho da subarvore), recursao de profundidade O(log n).
+static void preencherEytzinger(LayoutEytzinger* ez, const Componente comps[], int* proximo, int k) {
+    if (k > ez->tamanho) {
+        return;
+    }
+    preencherEytzinger(ez, comps, proximo, 2 * k);
+    ez->prefixos[k] = comps[*proximo].prefixoNome;
+    ez->posicoes[k] = (*proximo)++;
+    preencherEytzinger(ez, comps, proximo, 2 * k + 1);
+}
+
+// Libera a memoria do layout.
+void liberarEytzinger(LayoutEytzinger* ez) {
+    free(ez->prefixos);
+    free(ez->posicoes);
+    ez->prefixos = NULL;
+    ez->posicoes = NULL;
+    ez->tamanho = 0;
+}
+
+// Monta o layout de Eytzinger de um array ordenado por nome.
+// Vale ate o array mudar; depois disso precisa ser montado de novo.
+// Retorna 1 se sucesso, 0 se falha na alocacao (o layout fica vazio).
+// Complexidade: O(n).
+int montarEytzinger(LayoutEytzinger* ez, const Componente comps[], int n) {
+    size_t bytes = ((size_t)n + 1) * sizeof(uint64_t);
+    bytes = (bytes + 63) & ~(size_t)63; // aligned_alloc exige multiplo do alinhamento
+    ESTAT_SOMAR(alocacoes, 2);
+    ez->prefixos = (uint64_t*)aligned_alloc(64, bytes);
+    ez->posicoes = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    ez->tamanho = n;
+    if (!ez->prefixos || !ez->posicoes) {
+        liberarEytzinger(ez);
+        return 0;
+    }
+    int proximo = 0;
+    preencherEytzinger(ez, comps, &proximo, 1);
+    return 1;
+}
+
+// Busca por nome no layout de Eytzinger (mesmo resultado de buscaBinariaPorNome).
+// A descida so compara prefixos de 8 bytes e nao tem desvio que dependa deles (o
+// proximo no e 2k + (prefixo < chave)); a cada passo pede a linha de cache dos
+// descendentes tres niveis abaixo. No fim, k volta ao primeiro prefixo >= chave e os
+// componentes com esse prefixo (quase sempre um) sao conferidos pelo nome inteiro.
+// Conta o numero de comparacoes.
+// Retorna indice se encontrado, -1 caso contrario.
+// Complexidade: O(log n).
+int buscaEytzingerPorNome(const LayoutEytzinger* ez, const Componente comps[], const char* nome, int* comparacoes) {
+    Componente chave;
+    montarChave(&chave, nome);
+    *comparacoes = 0;
+    unsigned int k = 1;
+    while (k <= (unsigned int)ez->tamanho) {
+        __builtin_prefetch(ez->prefixos + 8 * (size_t)k);
+        (*comparacoes)++;
+        k = 2 * k + (ez->prefixos[k] < chave.prefixoNome);
+    }
+    k >>= __builtin_ffs((int)~k); // Desfaz as descidas a direita depois da ultima a esquerda
+    if (k == 0) {
+        return -1; // Todos os prefixos sao menores que o da chave
+    }
+    for (int i = ez->posicoes[k]; i < ez->tamanho && comps[i].prefixoNome == chave.prefixoNome; i++) {
+        (*comparacoes)++;
+        if (compararNomes(&comps[i], &chave) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Insere 'novo' num array ja ordenado por nome, mantendo a ordem (modo "manter ordenado").
+// A posicao vem de uma busca binaria (depois dos nomes iguais, preservando a ordem de
+// chegada) e o espaco e aberto com um unico memmove. Conta comparacoes e movimentos.
+// Retorna a posicao em que o componente ficou.
+// Complexidade: O(log n) comparacoes + O(n) movimentos.
+int inserirOrdenadoPorNome(Componente comps[], int n, const Componente* novo, int* comparacoes, int* movimentos) {
+    int low = limiteSuperiorNome(comps, n, novo, comparacoes);
+    memmove(&comps[low + 1], &comps[low], (size_t)(n - low) * sizeof(Componente));
+    comps[low] = *novo;
+    *movimentos = n - low + 1;
+    return low;
+}
+
+
+// Agregados da torre: quantos componentes ha de cada tipo e de cada prioridade.
+// Sao atualizados em O(1) a cada insercao e remocao (junto com as visoes), entao o
+// resumo nao percorre os componentes.
+#define PRIORIDADE_MAXIMA 10
+typedef struct {
+    int porTipo[MAX_TIPOS];                     // Indexado pelo id do tipo
+    int porPrioridade[PRIORIDADE_MAXIMA + 1];   // Indices 1 a 10; o 0 conta prioridades fora da faixa
+    int total;
+} ResumoTorre;
+
+// Visoes ordenadas persistentes: para cada criterio, um array com as posicoes dos
+// componentes ordenadas por (chave, posicao). Sao mantidas a cada insercao e remocao,
+// entao a busca binaria e as consultas por faixa funcionam em O(log n) qualquer que
+// seja a ordem atual de exibicao do array de componentes.
+// O preco e O(n) por alteracao: cada insercao, remocao ou mudanca de prioridade move um
+// trecho dos arrays (memmove) e insercao e remocao ainda renumeram as posicoes seguintes
+// (deslocarVisoes). Uma arvore de estatisticas de ordem daria O(log n), mas para as
+// poucas dezenas de componentes da torre os arrays contiguos saem mais baratos.
+// Junto delas fica uma fila de prioridade indexada: um heap binario de maximo com as
+// posicoes dos componentes (maior prioridade na raiz; no empate, a menor posicao) e,
+// para cada posicao, onde ela esta no heap. O plano de fuga pega o proximo componente,
+// os k mais importantes ou muda uma prioridade sem reordenar o array.
+typedef struct {
+    int* porCriterio[3]; // Indexado por criterio - 1
+    int* heap;           // heap[0] e a posicao do componente de maior prioridade
+    int* noHeap;         // noHeap[pos]: indice em heap do componente comps[pos]
+    int tamanho;
+    int capacidade;
+    int desatualizadas;  // 1: a ultima reconstrucao falhou e as visoes nao batem com o array
+    ResumoTorre resumo; // Agregados dos mesmos componentes
+} VisoesOrdenadas;
+
+// Posicao de uma prioridade no histograma do resumo.
+static int faixaPrioridade(int prioridade) {
+    return (prioridade >= 1 && prioridade <= PRIORIDADE_MAXIMA) ? prioridade : 0;
+}
+
+// Soma 'delta' (+1 ou -1) aos agregados do componente. Complexidade: O(1).
+static void resumoAjustar(ResumoTorre* r, const Componente* comp, int delta) {
+    r->porTipo[comp->tipo] += delta;
+    r->porPrioridade[faixaPrioridade(comp->prioridade)] += delta;
+    r->total += delta;
+}
+
+// Recalcula os agregados do zero (carga de arquivo). Complexidade: O(n).
+static void resumoReconstruir(ResumoTorre* r, const Componente comps[], int n) {
+    memset(r, 0, sizeof(*r));
+    for (int i = 0; i < n; i++) {
+        resumoAjustar(r, &comps[i], 1);
+    }
+}
+
+// Inicializa as visoes vazias.
+void initVisoes(VisoesOrdenadas* v) {
+    for (int c = 0; c < 3; c++) {
+        v->porCriterio[c] = NULL;
+    }
+    v->heap = NULL;
+    v->noHeap = NULL;
+    v->tamanho = 0;
+    v->capacidade = 0;
+    v->desatualizadas = 0;
+    memset(&v->resumo, 0, sizeof(v->resumo));
+}
+
+// Libera a memoria das visoes.
+void liberarVisoes(VisoesOrdenadas* v) {
+    for (int c = 0; c < 3; c++) {
+        free(v->porCriterio[c]);
+    }
+    free(v->heap);
+    free(v->noHeap);
+    initVisoes(v);
+}
+
+// Garante espaco para 'capacidade' posicoes em cada visao (dobrando quando necessario).
+// Retorna 1 se sucesso, 0 se falha na alocacao.
+static int reservarVisoes(VisoesOrdenadas* v, int capacidade) {
+    if (capacidade <= v->capacidade) {
+        return 1;
+    }
+    int nova = capacidadeDobrada(v->capacidade > 0 ? v->capacidade : 16, capacidade);
+    if (nova < 0) {
+        return 0;
+    }
+    for (int c = 0; c < 3; c++) {
+        ESTAT_SOMAR(alocacoes, 1);
+        int* novo = (int*)realloc(v->porCriterio[c], (size_t)nova * sizeof(int));
+        if (!novo) {
+            return 0;
+        }
+        v->porCriterio[c] = novo;
+    }
+    int** filas[2] = { &v->heap, &v->noHeap };
+    for (int f = 0; f < 2; f++) {
+        ESTAT_SOMAR(alocacoes, 1);
+        int* novo = (int*)realloc(*filas[f], (size_t)nova * sizeof(int));
+        if (!novo) {
+            return 0;
+        }
+        *filas[f] = novo;
+    }
+    v->capacidade = nova;
+    return 1;
+}
+
+// Fila de prioridade (heap binario de maximo indexado)
+
+// 1 se o componente comps[a] deve sair da fila antes de comps[b]:
+// prioridade maior, ou a mesma prioridade e posicao menor.
+static int heapAntes(const Componente comps[], int a, int b) {
+    if (comps[a].prioridade != comps[b].prioridade) {
+        return comps[a].prioridade > comps[b].prioridade;
+    }
+    return a < b;
+}
+
+// Troca dois elementos do heap e atualiza noHeap. Complexidade: O(1).
+static void heapTrocar(VisoesOrdenadas* v, int i, int j) {
+    int temp = v->heap[i];
+    v->heap[i] = v->heap[j];
+    v->heap[j] = temp;
+    v->noHeap[v->heap[i]] = i;
+    v->noHeap[v->heap[j]] = j;
+}
+
+// Sobe o elemento i enquanto ele deve sair antes do pai. Complexidade: O(log n).
+static void heapSubir(VisoesOrdenadas* v, const Componente comps[], int i) {
+    while (i > 0 && heapAntes(comps, v->heap[i], v->heap[(i - 1) / 2])) {
+        heapTrocar(v, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+// Desce o elemento i num heap de n elementos ate nenhum filho dever sair antes dele.
+// Complexidade: O(log n).
+static void heapDescer(VisoesOrdenadas* v, const Componente comps[], int i, int n) {
+    while (2 * i + 1 < n) {
+        int filho = 2 * i + 1;
+        if (filho + 1 < n && heapAntes(comps, v->heap[filho + 1], v->heap[filho])) {
+            filho++;
+        }
+        if (!heapAntes(comps, v->heap[filho], v->heap[i])) {
+            break;
+        }
+        heapTrocar(v, i, filho);
+        i = filho;
+    }
+}
+
+// Monta o heap com as posicoes 0..n-1 (heapify de baixo para cima).
+// Complexidade: O(n).
+static void heapConstruir(VisoesOrdenadas* v, const Componente comps[], int n) {
+    for (int i = 0; i < n; i++) {
+        v->heap[i] = i;
+        v->noHeap[i] = i;
+    }
+    for (int i = n / 2 - 1; i >= 0; i--) {
+        heapDescer(v, comps, i, n);
+    }
+}
+
+// Primeira posicao da visao cujo elemento e >= (chave de comps[pos], pos).
+static int posicaoNaVisao(const VisoesOrdenadas* v, const Componente comps[], CriterioOrdenacao criterio, int pos, int* comparacoes) {
+    const int* visao = v->porCriterio[criterio - 1];
+    int low = 0, high = v->tamanho;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        int cmp = compararComponentes(&comps[visao[mid]], &comps[pos], criterio, comparacoes);
+        if (cmp < 0 || (cmp == 0 && visao[mid] < pos)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Soma 'delta' as posicoes >= 'inicio' em todas as visoes e no heap (o array foi
+// deslocado). A ordem relativa das posicoes nao muda, entao o heap continua valido.
+static void deslocarVisoes(VisoesOrdenadas* v, int inicio, int delta) {
+    for (int c = 0; c < 3; c++) {
+        for (int i = 0; i < v->tamanho; i++) {
+            if (v->porCriterio[c][i] >= inicio) {
+                v->porCriterio[c][i] += delta;
+            }
+        }
+    }
+    for (int i = 0; i < v->tamanho; i++) {
+        if (v->heap[i] >= inicio) {
+            v->heap[i] += delta;
+        }
+    }
+}
+
+// Registra nas visoes um componente que acabou de ser inserido em comps[pos]
+// (os que estavam de pos em diante foram deslocados uma posicao para frente).
+// Retorna 1 se sucesso, 0 se falha na alocacao.
+// Complexidade: O(log n) comparacoes + O(n) para deslocar posicoes inteiras.
+int visoesInserir(VisoesOrdenadas* v, const Componente comps[], int pos) {
+    if (!reservarVisoes(v, v->tamanho + 1)) {
+        return 0;
+    }
+    deslocarVisoes(v, pos, 1);
+    int comparacoes = 0;
+    for (int c = CRITERIO_NOME; c <= CRITERIO_PRIORIDADE; c++) {
+        int* visao = v->porCriterio[c - 1];
+        int i = posicaoNaVisao(v, comps, (CriterioOrdenacao)c, pos, &comparacoes);
+        memmove(&visao[i + 1], &visao[i], (size_t)(v->tamanho - i) * sizeof(int));
+        visao[i] = pos;
+    }
+    memmove(&v->noHeap[pos + 1], &v->noHeap[pos], (size_t)(v->tamanho - pos) * sizeof(int));
+    v->heap[v->tamanho] = pos;
+    v->noHeap[pos] = v->tamanho;
+    heapSubir(v, comps, v->tamanho);
+    v->tamanho++;
+    resumoAjustar(&v->resumo, &comps[pos], 1);
+    return 1;
+}
+
+// Retira das visoes o componente comps[pos]. Deve ser chamada antes de remover
+// o componente do array (precisa da chave dele); as posicoes seguintes sao
+// ajustadas como se o array fosse deslocado uma posicao para tras.
+// Complexidade: O(log n) comparacoes + O(n) para deslocar posicoes inteiras.
+void visoesRemover(VisoesOrdenadas* v, const Componente comps[], int pos) {
+    int comparacoes = 0;
+    for (int c = CRITERIO_NOME; c <= CRITERIO_PRIORIDADE; c++) {
+        int* visao = v->porCriterio[c - 1];
+        int i = posicaoNaVisao(v, comps, (CriterioOrdenacao)c, pos, &comparacoes);
+        memmove(&visao[i], &visao[i + 1], (size_t)(v->tamanho - i - 1) * sizeof(int));
+    }
+    // No heap, o ultimo elemento ocupa o lugar do removido e sobe ou desce ate se acomodar.
+    int i = v->noHeap[pos];
+    int ultimo = v->tamanho - 1;
+    heapTrocar(v, i, ultimo);
+    if (i < ultimo) {
+        heapSubir(v, comps, i);
+        heapDescer(v, comps, i, ultimo);
+    }
+    resumoAjustar(&v->resumo, &comps[pos], -1);
+    v->tamanho--;
+    memmove(&v->noHeap[pos], &v->noHeap[pos + 1], (size_t)(v->tamanho - pos) * sizeof(int));
+    deslocarVisoes(v, pos + 1, -1);
+}
+
+// Muda a prioridade de comps[pos], mantendo a visao por prioridade, o resumo e o heap.
+// Complexidade: O(log n) comparacoes + O(n) para deslocar posicoes na visao.
+void visoesAlterarPrioridade(VisoesOrdenadas* v, Componente comps[], int pos, int prioridade) {
+    int comparacoes = 0;
+    int* visao = v->porCriterio[CRITERIO_PRIORIDADE - 1];
+    int i = posicaoNaVisao(v, comps, CRITERIO_PRIORIDADE, pos, &comparacoes);
+    memmove(&visao[i], &visao[i + 1], (size_t)(v->tamanho - i - 1) * sizeof(int));
+    resumoAjustar(&v->resumo, &comps[pos], -1);
+    comps[pos].prioridade = prioridade;
+    resumoAjustar(&v->resumo, &comps[pos], 1);
+    v->tamanho--; // posicaoNaVisao procura entre os demais
+    i = posicaoNaVisao(v, comps, CRITERIO_PRIORIDADE, pos, &comparacoes);
+    v->tamanho++;
+    memmove(&visao[i + 1], &visao[i], (size_t)(v->tamanho - i - 1) * sizeof(int));
+    visao[i] = pos;
+    heapSubir(v, comps, v->noHeap[pos]);
+    heapDescer(v, comps, v->noHeap[pos], v->tamanho);
+}
+
+// Posicao do componente de maior prioridade (o proximo do plano de fuga).
+// Retorna a posicao, ou -1 se nao ha componentes. Complexidade: O(1).
+int visoesMaiorPrioridade(const VisoesOrdenadas* v) {
+    return v->tamanho > 0 ? v->heap[0] : -1;
+}
+
+// Posicoes dos k componentes de maior prioridade, em ordem (sem ordenar o array).
+// Percorre o heap a partir da raiz com um segundo heap de candidatos: cada elemento
+// retirado dele entra na resposta e poe seus dois filhos como candidatos.
+// Retorna quantas posicoes foram escritas em 'saida' (min(k, n)), ou -1 se faltar memoria.
+// Complexidade: O(k log k), independente de n.
+int maioresPrioridades(const VisoesOrdenadas* v, const Componente comps[], int k, int saida[]) {
+    if (k > v->tamanho) {
+        k = v->tamanho;
+    }
+    if (k <= 0) {
+        return 0;
+    }
+    ESTAT_SOMAR(alocacoes, 1);
+    int* candidatos = (int*)malloc((size_t)(k + 1) * sizeof(int)); // Indices no heap principal
+    if (!candidatos) {
+        return -1;
+    }
+    int numCandidatos = 1;
+    candidatos[0] = 0;
+    for (int m = 0; m < k; m++) {
+        int topo = candidatos[0];
+        saida[m] = v->heap[topo];
+        // O ultimo candidato vai para a raiz e desce; depois os filhos do retirado entram e sobem.
+        candidatos[0] = candidatos[--numCandidatos];
+        for (int i = 0; 2 * i + 1 < numCandidatos;) {
+            int filho = 2 * i + 1;
+            if (filho + 1 < numCandidatos && heapAntes(comps, v->heap[candidatos[filho + 1]], v->heap[candidatos[filho]])) {
+                filho++;
+            }
+            if (!heapAntes(comps, v->heap[candidatos[filho]], v->heap[candidatos[i]])) {
+                break;
+            }
+            int temp = candidatos[i];
+            candidatos[i] = candidatos[filho];
+            candidatos[filho] = temp;
+            i = filho;
+        }
+        for (int f = 2 * topo + 1; f <= 2 * topo + 2 && f < v->tamanho; f++) {
+            candidatos[numCandidatos++] = f;
+            for (int i = numCandidatos - 1; i > 0 && heapAntes(comps, v->heap[candidatos[i]], v->heap[candidatos[(i - 1) / 2]]); i = (i - 1) / 2) {
+                int temp = candidatos[i];
+                candidatos[i] = candidatos[(i - 1) / 2];
+                candidatos[(i - 1) / 2] = temp;
+            }
+        }
+    }
+    free(candidatos);
+    return k;
+}
+
+// Reconstroi as visoes depois que o array foi reordenado (ex.: ordenacao para exibicao).
+// Usa a ordenacao por indices, que e estavel: empates ficam em ordem de posicao.
+// Os agregados sao recalculados tambem, caso 'comps' seja outro conjunto.
+// Retorna 1 se sucesso, 0 se falha na alocacao.
+// Complexidade: O(n log n).
+int visoesReconstruir(VisoesOrdenadas* v, const Componente comps[], int n) {
+    v->desatualizadas = 1; // Ate a reconstrucao terminar
+    if (!reservarVisoes(v, n)) {
+        return 0;
+    }
+    int comparacoes, movimentos;
+    for (int c = CRITERIO_NOME; c <= CRITERIO_PRIORIDADE; c++) {
+        // int e uint32_t tem o mesmo tamanho; as posicoes sao sempre nao negativas.
+        if (!ordenarIndices(comps, n, (CriterioOrdenacao)c, (uint32_t*)v->porCriterio[c - 1], &comparacoes, &movimentos)) {
+            return 0;
+        }
+    }
+    v->tamanho = n;
+    v->desatualizadas = 0;
+    resumoReconstruir(&v->resumo, comps, n);
+    heapConstruir(v, comps, n);
+    return 1;
+}
+
+// Primeira posicao da visao cuja chave e >= chave (estrito = 0) ou > chave (estrito = 1).
+// Apenas o campo do criterio precisa estar preenchido em 'chave'.
+static int limiteNaVisao(const VisoesOrdenadas* v, const Componente comps[], CriterioOrdenacao criterio, const Componente* chave,
+                         int estrito, int* comparacoes) {
+    const int* visao = v->porCriterio[criterio - 1];
+    int low = 0, high = v->tamanho;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        int cmp = compararComponentes(&comps[visao[mid]], chave, criterio, comparacoes);
+        if (cmp < 0 || (estrito && cmp == 0)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Busca binaria por nome na visao por nome (nao exige o array ordenado).
+// Conta o numero de comparacoes.
+// Retorna a posicao no array de componentes se encontrado, -1 caso contrario.
+// Complexidade: O(log n).
+int buscaBinariaVisao(const VisoesOrdenadas* v, const Componente comps[], const char* nome, int* comparacoes) {
+    Componente chave;
+    montarChave(&chave, nome);
+    *comparacoes = 0;
+    int i = limiteNaVisao(v, comps, CRITERIO_NOME, &chave, 0, comparacoes);
+    if (i < v->tamanho && compararComponentes(&comps[v->porCriterio[0][i]], &chave, CRITERIO_NOME, comparacoes) == 0) {
+        return v->porCriterio[0][i];
+    }
+    return -1;
+}
+
+// Faixa [*inicio, *fim) da visao por tipo com os componentes do tipo dado.
+// Um tipo que nao esta no dicionario da uma faixa vazia sem busca.
+// Conta o numero de comparacoes. Complexidade: O(log n).
+void intervaloPorTipo(const VisoesOrdenadas* v, const Componente comps[], const char* tipo, int* inicio, int* fim, int* comparacoes) {
+    Componente chave;
+    *comparacoes = 0;
+    int id = buscarTipo(&tiposComponentes, tipo);
+    if (id == -1) {
+        *inicio = *fim = 0;
+        return;
+    }
+    chave.tipo = (uint8_t)id;
+    *inicio = limiteNaVisao(v, comps, CRITERIO_TIPO, &chave, 0, comparacoes);
+    *fim = limiteNaVisao(v, comps, CRITERIO_TIPO, &chave, 1, comparacoes);
+}
+
+// Faixa [*inicio, *fim) da visao por nome com os componentes cujo nome comeca com 'prefixo'
+// (autocompletar). Os nomes com o mesmo prefixo ficam contiguos na visao por nome, entao
+// bastam duas buscas binarias: o inicio e a primeira posicao >= prefixo e o fim e a primeira
+// cujos primeiros bytes ja passam do prefixo. Prefixo vazio da a visao inteira.
+// Conta o numero de comparacoes. Complexidade: O(log n).
+void intervaloPorPrefixo(const VisoesOrdenadas* v, const Componente comps[], const char* prefixo, int* inicio, int* fim, int* comparacoes) {
+    const int* visao = v->porCriterio[CRITERIO_NOME - 1];
+    size_t tamanho = strlen(prefixo);
+    Componente chave;
+    montarChave(&chave, prefixo);
+    *comparacoes = 0;
+    *inicio = limiteNaVisao(v, comps, CRITERIO_NOME, &chave, 0, comparacoes);
+    int low = *inicio, high = v->tamanho;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        (*comparacoes)++;
+        if (strncmp(comps[visao[mid]].nome, prefixo, tamanho) <= 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    *fim = low;
+}
+
+// Faixa [*inicio, *fim) da visao por prioridade com prioridades entre pmin e pmax.
+// Conta o numero de comparacoes. Complexidade: O(log n).
+void intervaloPorPrioridade(const VisoesOrdenadas* v, const Componente comps[], int pmin, int pmax, int* inicio, int* fim, int* comparacoes) {
+    Componente chave;
+    *comparacoes = 0;
+    chave.prioridade = pmin;
+    *inicio = limiteNaVisao(v, comps, CRITERIO_PRIORIDADE, &chave, 0, comparacoes);
+    chave.prioridade = pmax;
+    *fim = limiteNaVisao(v, comps, CRITERIO_PRIORIDADE, &chave, 1, comparacoes);
+    if (*fim < *inicio) {
+        *fim = *inicio;
+    }
+}
+
+// Mostra os componentes de uma faixa de uma visao.
+void mostrarFaixaVisao(const int visao[], const Componente comps[], int inicio, int fim) {
+    for (int i = inicio; i < fim; i++) {
+        const Componente* c = &comps[visao[i]];
+        printf("Nome: %s, Tipo: %s, Prioridade: %d\n", c->nome, nomeDoTipo(&tiposComponentes, c->tipo), c->prioridade);
+    }
+}
+
+// Mostra os agregados da torre: componentes por tipo e histograma de prioridades.
+// Complexidade: O(t + 10), independente do numero de componentes.
+void mostrarResumo(const ResumoTorre* r) {
+    printf("Componentes: %d\n", r->total);
+    printf("Por tipo:\n");
+    for (int id = 0; id < tiposComponentes.quantidade; id++) {
+        if (r->porTipo[id] > 0) {
+            printf("  %-20s %d\n", nomeDoTipo(&tiposComponentes, id), r->porTipo[id]);
+        }
+    }
+    printf("Por prioridade:\n");
+    for (int p = 1; p <= PRIORIDADE_MAXIMA; p++) {
+        printf("  %2d: %d\n", p, r->porPrioridade[p]);
+    }
+    if (r->porPrioridade[0] > 0) {
+        printf("  fora de 1-%d: %d\n", PRIORIDADE_MAXIMA, r->porPrioridade[0]);
+    }
+}
+
+// Funcoes de arquivo (snapshot binario da torre)
+//
+// Layout, na ordem nativa da maquina (o cabecalho confere tamanhos e versao):
+//   CabecalhoArquivo | componentes (n * Componente) | tipos (t * 20 bytes) | visoes (3 * n ints)
+// Cada bloco e gravado e lido inteiro, como esta na memoria: nao ha conversao por componente.
+// O array da torre tem tamanho fixo (MAX_COMPONENTES), entao a carga le os blocos
+// para ele com fread em vez de mapear o arquivo.
+#define MAGICA_ARQUIVO "TORRE"
+#define VERSAO_ARQUIVO 1
+
+typedef struct {
+    char magica[8];
+    uint32_t versao;
+    uint32_t tamanhoCabecalho;
+    uint32_t tamanhoComponente;
+    uint32_t quantidade;      // Componentes no arquivo
+    uint32_t quantidadeTipos; // Entradas do dicionario de tipos
+    uint32_t reservado;
+    uint64_t soma;            // FNV-1a de 64 bits dos tres blocos
+} CabecalhoArquivo;
+
+// FNV-1a de 64 bits sobre bytes, continuando a partir de 'h'.
+static uint64_t somaVerificacao(const void* dados, size_t tamanho, uint64_t h) {
+    const unsigned char* p = (const unsigned char*)dados;
+    for (size_t i = 0; i < tamanho; i++) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// Salva os n componentes, o dicionario de tipos e as visoes em 'caminho'.
+// Grava em "<caminho>.tmp", faz fsync e renomeia: nunca deixa um arquivo pela metade.
+// Retorna 1 se sucesso, 0 se falha de escrita.
+// Complexidade: O(n + t).
+int salvarComponentes(const Componente comps[], int n, const VisoesOrdenadas* v, const char* caminho) {
+    CabecalhoArquivo cab;
+    memset(&cab, 0, sizeof(cab));
+    memcpy(cab.magica, MAGICA_ARQUIVO, sizeof(MAGICA_ARQUIVO));
+    cab.versao = VERSAO_ARQUIVO;
+    cab.tamanhoCabecalho = sizeof(CabecalhoArquivo);
+    cab.tamanhoComponente = sizeof(Componente);
+    cab.quantidade = (uint32_t)n;
+    cab.quantidadeTipos = (uint32_t)tiposComponentes.quantidade;
+    size_t bytesTipos = (size_t)tiposComponentes.quantidade * sizeof(tiposComponentes.nomes[0]);
+    cab.soma = somaVerificacao(comps, (size_t)n * sizeof(Componente), 14695981039346656037ull);
+    cab.soma = somaVerificacao(tiposComponentes.nomes, bytesTipos, cab.soma);
+    for (int c = 0; c < 3; c++) {
+        cab.soma = somaVerificacao(v->porCriterio[c], (size_t)n * sizeof(int), cab.soma);
+    }
+
+    char temporario[512];
+    if (snprintf(temporario, sizeof(temporario), "%s.tmp", caminho) >= (int)sizeof(temporario)) {
+        return 0;
+    }
+    FILE* arquivo = fopen(temporario, "wb");
+    if (!arquivo) {
+        return 0;
+    }
+    int ok = fwrite(&cab, sizeof(cab), 1, arquivo) == 1
+          && fwrite(comps, sizeof(Componente), (size_t)n, arquivo) == (size_t)n
+          && (bytesTipos == 0 || fwrite(tiposComponentes.nomes, bytesTipos, 1, arquivo) == 1);
+    for (int c = 0; c < 3 && ok && n > 0; c++) {
+        ok = fwrite(v->porCriterio[c], sizeof(int), (size_t)n, arquivo) == (size_t)n;
+    }
+    ok = ok && fflush(arquivo) == 0 && fsync(fileno(arquivo)) == 0;
+    if (fclose(arquivo) != 0) {
+        ok = 0;
+    }
+    if (!ok || rename(temporario, caminho) != 0) {
+        remove(temporario);
+        return 0;
+    }
+    return 1;
+}
+
+// Carrega o snapshot gravado por salvarComponentes, substituindo componentes e visoes.
+// Os tipos do arquivo entram no dicionario do programa; se algum receber outro id,
+// os componentes sao renumerados (as visoes por tipo seguem a ordem alfabetica, que nao muda).
+// Retorna 1 se sucesso, 0 se o arquivo nao existe, e de outra versao/maquina, tem mais de
+// MAX_COMPONENTES ou esta corrompido (nesses casos nem a torre nem o dicionario sao alterados).
+// Le com fread, e nao com mmap como carregarVetor no aventureiro: a torre e um array fixo
+// de MAX_COMPONENTES posicoes, entao mesmo mapeado o arquivo teria de ser copiado para ele,
+// e a copia previa em lidos[] e o que deixa a torre intacta quando o arquivo e recusado.
+// Complexidade: O(n + t).
+int carregarComponentes(Componente comps[], int* n, VisoesOrdenadas* v, const char* caminho) {
+    FILE* arquivo = fopen(caminho, "rb");
+    if (!arquivo) {
+        return 0;
+    }
+    CabecalhoArquivo cab;
+    Componente lidos[MAX_COMPONENTES];
+    char tipos[MAX_TIPOS][20];
+    int visoes[3][MAX_COMPONENTES];
+    int ok = fread(&cab, sizeof(cab), 1, arquivo) == 1
+          && memcmp(cab.magica, MAGICA_ARQUIVO, sizeof(MAGICA_ARQUIVO)) == 0
+          && cab.versao == VERSAO_ARQUIVO
+          && cab.tamanhoCabecalho == sizeof(CabecalhoArquivo)
+          && cab.tamanhoComponente == sizeof(Componente)
+          && cab.quantidade <= MAX_COMPONENTES
+          && cab.quantidadeTipos <= MAX_TIPOS
+          && fread(lidos, sizeof(Componente), cab.quantidade, arquivo) == cab.quantidade
+          && fread(tipos, sizeof(tipos[0]), cab.quantidadeTipos, arquivo) == cab.quantidadeTipos;
+    for (int c = 0; c < 3 && ok; c++) {
+        ok = fread(visoes[c], sizeof(int), cab.quantidade, arquivo) == cab.quantidade;
+    }
+    ok = ok && fgetc(arquivo) == EOF;
+    fclose(arquivo);
+    if (ok) {
+        uint64_t soma = somaVerificacao(lidos, (size_t)cab.quantidade * sizeof(Componente), 14695981039346656037ull);
+        soma = somaVerificacao(tipos, (size_t)cab.quantidadeTipos * sizeof(tipos[0]), soma);
+        for (int c = 0; c < 3; c++) {
+            soma = somaVerificacao(visoes[c], (size_t)cab.quantidade * sizeof(int), soma);
+        }
+        ok = soma == cab.soma;
+    }
+    for (uint32_t i = 0; ok && i < cab.quantidade; i++) {
+        ok = lidos[i].tipo < cab.quantidadeTipos;
+    }
+    // Cada visao precisa ser uma permutacao de 0..n-1: um indice repetido deixaria
+    // componentes fora da visao e a busca binaria sobre ela daria respostas erradas.
+    for (int c = 0; c < 3 && ok; c++) {
+        unsigned char visto[MAX_COMPONENTES] = { 0 };
+        for (uint32_t i = 0; ok && i < cab.quantidade; i++) {
+            int p = visoes[c][i];
+            ok = p >= 0 && p < (int)cab.quantidade && !visto[p];
+            if (ok) {
+                visto[p] = 1;
+            }
+        }
+    }
+    if (!ok || !reservarVisoes(v, (int)cab.quantidade)) {
+        return 0;
+    }
+
+    // Traduz os ids de tipo do arquivo para os do dicionario do programa. Os tipos novos
+    // entram em uma copia do dicionario, que so substitui tiposComponentes no fim.
+    DicionarioTipos dicionario;
+    if (!copiarDicionario(&dicionario, &tiposComponentes)) {
+        return 0;
+    }
+    uint8_t novoId[MAX_TIPOS];
+    for (uint32_t i = 0; i < cab.quantidadeTipos; i++) {
+        tipos[i][sizeof(tipos[i]) - 1] = '\0';
+        int id = internarTipo(&dicionario, tipos[i]);
+        if (id == -1) {
+            liberarDicionario(&dicionario);
+            return 0;
+        }
+        novoId[i] = (uint8_t)id;
+    }
+    liberarDicionario(&tiposComponentes);
+    tiposComponentes = dicionario;
+    for (uint32_t i = 0; i < cab.quantidade; i++) {
+        lidos[i].tipo = novoId[lidos[i].tipo];
+    }
+    memcpy(comps, lidos, (size_t)cab.quantidade * sizeof(Componente));
+    for (int c = 0; c < 3 && cab.quantidade > 0; c++) {
+        memcpy(v->porCriterio[c], visoes[c], (size_t)cab.quantidade * sizeof(int));
+    }
+    v->tamanho = (int)cab.quantidade;
+    v->desatualizadas = 0;
+    resumoReconstruir(&v->resumo, comps, v->tamanho);
+    heapConstruir(v, comps, v->tamanho); // O heap nao vai para o arquivo
+    *n = (int)cab.quantidade;
+    return 1;
+}
+
+// Diario de operacoes (append-only)
+//
+// Cada cadastro, remocao e mudanca de prioridade vira um registro binario curto no fim do diario. Ao iniciar,
+// o programa carrega o ultimo snapshot (salvarComponentes), repete o diario por cima e
+// compacta tudo de volta em um snapshot novo com o diario vazio.
+//
+// Arquivo: CabecalhoDiario seguido dos registros:
+//   [tamanho u8][operacao u8][prioridade i32][tamNome u8][nome][tamTipo u8][tipo][soma u32]
+// A soma (FNV-1a dos bytes anteriores do registro) detecta o registro cortado por uma
+// queda: a repeticao para nele.
+//
+// Commit em grupo: os registros ficam num buffer proprio e sao gravados com um unico
+// write + fdatasync a cada 'intervalo' registros (1 = duravel a cada operacao; maior =
+// menos fdatasyncs). Os registros ainda no buffer quando o programa cai se perdem: ate
+// 'intervalo' operacoes (as pendentes, ou o grupo inteiro se a queda vier no meio do
+// write + fdatasync; a repeticao para no registro cortado).
+#define ARQUIVO_SNAPSHOT "torre.bin"
+#define ARQUIVO_DIARIO "torre.diario"
+#define MAGICA_DIARIO "DIARIO"
+#define VERSAO_DIARIO 2 // 2: registro de mudanca de prioridade (a versao 1 continua legivel)
+#define INTERVALO_DIARIO_PADRAO 16
+#define TAMANHO_BUFFER_DIARIO 4096
+#define MAX_REGISTRO_DIARIO 64 // 1 + 1 + 4 + 1 + 29 + 1 + 19 + 4 = 60
+
+typedef enum {
+    OPERACAO_INSERIR = 1,
+    OPERACAO_REMOVER,
+    OPERACAO_PRIORIDADE // Nome e a prioridade nova; o componente fica na mesma posicao
+} OperacaoDiario;
+
+typedef struct {
+    char magica[8];
+    uint32_t versao;
+    uint32_t reservado;
+    uint64_t somaSnapshot; // Soma do snapshot sobre o qual os registros se aplicam (0: nenhum)
+} CabecalhoDiario;
+
+typedef struct {
+    int fd;                 // -1: diario fechado (nada e registrado)
+    char caminho[256];
+    int intervalo;          // Registros por commit
+    int pendentes;          // Registros no buffer ainda nao gravados
+    size_t usado;
+    unsigned char buffer[TAMANHO_BUFFER_DIARIO];
+    long long registros;    // Contadores desde a abertura
+    long long commits;
+    long long falhas;
+    long long falhasAvisadas; // Falhas ja mostradas ao usuario (ver avisarFalhasDiario)
+    long long compactacoes;
+} Diario;
+
+// Grava todos os 'tamanho' bytes em fd, repetindo em escritas parciais.
+// Retorna 1 se sucesso, 0 se falha de escrita.
+static int gravarTudo(int fd, const void* dados, size_t tamanho) {
+    const unsigned char* p = (const unsigned char*)dados;
+    while (tamanho > 0) {
+        ssize_t escritos = write(fd, p, tamanho);
+        if (escritos <= 0) {
+            return 0;
+        }
+        p += escritos;
+        tamanho -= (size_t)escritos;
+    }
+    return 1;
+}
+
+// Abre (ou cria) o diario em 'caminho' para acrescentar registros.
+// Um arquivo vazio recebe o cabecalho com 'soma' (a do snapshot atual).
+// Retorna 1 se sucesso, 0 se falha ao abrir ou gravar.
+int abrirDiario(Diario* d, const char* caminho, int intervalo, uint64_t soma) {
+    if (snprintf(d->caminho, sizeof(d->caminho), "%s", caminho) >= (int)sizeof(d->caminho)) {
+        return 0;
+    }
+    d->fd = open(caminho, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (d->fd < 0) {
+        return 0;
+    }
+    d->intervalo = intervalo > 0 ? intervalo : 1;
+    d->pendentes = 0;
+    d->usado = 0;
+    struct stat info;
+    if (fstat(d->fd, &info) == 0 && info.st_size == 0) {
+        CabecalhoDiario cab;
+        memset(&cab, 0, sizeof(cab));
+        memcpy(cab.magica, MAGICA_DIARIO, sizeof(MAGICA_DIARIO));
+        cab.versao = VERSAO_DIARIO;
+        cab.somaSnapshot = soma;
+        if (!gravarTudo(d->fd, &cab, sizeof(cab)) || fsync(d->fd) != 0) {
+            close(d->fd);
+            d->fd = -1;
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Commit do grupo: grava os registros pendentes com um write e um fdatasync.
+// Retorna 1 se sucesso (ou nada pendente), 0 se falha (os registros sao descartados).
+int confirmarDiario(Diario* d) {
+    if (d->fd < 0 || d->usado == 0) {
+        return 1;
+    }
+    int ok = gravarTudo(d->fd, d->buffer, d->usado) && fdatasync(d->fd) == 0;
+    d->usado = 0;
+    d->pendentes = 0;
+    d->commits++;
+    if (!ok) {
+        d->falhas++;
+    }
+    return ok;
+}
+
+// Confirma o que estiver pendente e fecha o diario.
+void fecharDiario(Diario* d) {
+    if (d->fd >= 0) {
+        confirmarDiario(d);
+        close(d->fd);
+        d->fd = -1;
+    }
+}
+
+// Mostra as falhas de gravacao do diario ocorridas desde o ultimo aviso: os registros
+// desses commits foram descartados e as operacoes nao sobrevivem a uma queda.
+void avisarFalhasDiario(Diario* d) {
+    if (d->falhas > d->falhasAvisadas) {
+        printf("Aviso: %lld falha(s) ao gravar o diario %s; as ultimas operacoes nao foram persistidas.\n",
+               d->falhas - d->falhasAvisadas, d->caminho);
+        d->falhasAvisadas = d->falhas;
+    }
+}
+
+// FNV-1a de 32 bits sobre os bytes de um registro.
+static uint32_t somaRegistro(const unsigned char* p, size_t tamanho) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < tamanho; i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Acrescenta um registro ao buffer do diario (nada acontece com o diario fechado).
+// Confirma o grupo ao completar o intervalo.
+// Complexidade: O(1); um write + fdatasync a cada 'intervalo' chamadas.
+void registrarOperacao(Diario* d, OperacaoDiario operacao, const char* nome, const char* tipo, int prioridade) {
+    if (d->fd < 0) {
+        return;
+    }
+    size_t tamNome = strnlen(nome, 29);
+    size_t tamTipo = strnlen(tipo, 19);
+    size_t tamanho = 1 + 1 + 4 + 1 + tamNome + 1 + tamTipo + 4;
+    if (d->usado + tamanho > sizeof(d->buffer)) {
+        confirmarDiario(d);
+    }
+    unsigned char* registro = d->buffer + d->usado;
+    registro[0] = (unsigned char)tamanho;
+    registro[1] = (unsigned char)operacao;
+    memcpy(registro + 2, &prioridade, 4);
+    registro[6] = (unsigned char)tamNome;
+    memcpy(registro + 7, nome, tamNome);
+    registro[7 + tamNome] = (unsigned char)tamTipo;
+    memcpy(registro + 8 + tamNome, tipo, tamTipo);
+    uint32_t soma = somaRegistro(registro, tamanho - 4);
+    memcpy(registro + tamanho - 4, &soma, 4);
+    d->usado += tamanho;
+    d->registros++;
+    if (++d->pendentes >= d->intervalo) {
+        confirmarDiario(d);
+    }
+}
+
+// O arquivo 'caminho' realmente nao existe? (e nao so falhou ao abrir por outro motivo)
+static int arquivoAusente(const char* caminho) {
+    struct stat info;
+    return stat(caminho, &info) != 0 && errno == ENOENT;
+}
+
+// Renomeia 'caminho' para "<caminho>.corrompido", tirando-o do caminho da recuperacao
+// sem perder o conteudo. Retorna 1 se renomeou ou se o arquivo nao existe, 0 se falhou.
+int separarCorrompido(const char* caminho) {
+    char destino[300];
+    snprintf(destino, sizeof(destino), "%s.corrompido", caminho);
+    if (rename(caminho, destino) == 0) {
+        printf("%s guardado como %s.\n", caminho, destino);
+        return 1;
+    }
+    return errno == ENOENT;
+}
+
+// Soma de verificacao gravada no cabecalho do snapshot em 'caminho'.
+// Retorna 0 se o arquivo nao existe ou nao e um snapshot.
+uint64_t somaSnapshot(const char* caminho) {
+    FILE* arquivo = fopen(caminho, "rb");
+    if (!arquivo) {
+        return 0;
+    }
+    CabecalhoArquivo cab;
+    int ok = fread(&cab, sizeof(cab), 1, arquivo) == 1 && memcmp(cab.magica, MAGICA_ARQUIVO, sizeof(MAGICA_ARQUIVO)) == 0;
+    fclose(arquivo);
+    return ok ? cab.soma : 0;
+}
+
+// Repete o diario 'caminho' sobre os componentes carregados do snapshot: cadastros
+// entram no final do array, remocoes saem pela visao por nome e mudancas de prioridade
+// sao aplicadas no lugar (a ordem do array e preservada).
+// So vale se o cabecalho aponta para o snapshot carregado ('soma'); senao a queda foi
+// entre gravar o snapshot novo e trocar o diario, e as operacoes ja estao no snapshot.
+// Para no primeiro registro cortado ou corrompido.
+// Retorna o numero de registros aplicados, 0 se o diario nao existe ou nao se aplica,
+// -1 se e invalido.
+// Complexidade: O(r * n) no pior caso (cada remocao desloca o array).
+long long repetirDiario(const char* caminho, uint64_t soma, Componente comps[], int* n, VisoesOrdenadas* v) {
+    FILE* arquivo = fopen(caminho, "rb");
+    if (!arquivo) {
+        return 0;
+    }
+    CabecalhoDiario cab;
+    if (fread(&cab, sizeof(cab), 1, arquivo) != 1 || memcmp(cab.magica, MAGICA_DIARIO, sizeof(MAGICA_DIARIO)) != 0 || (cab.versao != 1 && cab.versao != VERSAO_DIARIO)) {
+        fclose(arquivo);
+        return -1;
+    }
+    long long aplicados = 0;
+    unsigned char registro[MAX_REGISTRO_DIARIO];
+    while (cab.somaSnapshot == soma && fread(registro, 1, 1, arquivo) == 1) {
+        size_t tamanho = registro[0];
+        if (tamanho < 12 || tamanho > 60 || fread(registro + 1, 1, tamanho - 1, arquivo) != tamanho - 1) {
+            break;
+        }
+        size_t tamNome = registro[6];
+        uint32_t somaLida;
+        memcpy(&somaLida, registro + tamanho - 4, 4);
+        if (somaLida != somaRegistro(registro, tamanho - 4) || tamNome > 29 || 12 + tamNome + registro[7 + tamNome] != tamanho) {
+            break;
+        }
+        Componente comp;
+        memset(&comp, 0, sizeof(comp));
+        memcpy(comp.nome, registro + 7, tamNome);
+        memcpy(&comp.prioridade, registro + 2, 4);
+        char tipo[20] = { 0 };
+        memcpy(tipo, registro + 8 + tamNome, registro[7 + tamNome]);
+        normalizarComponente(&comp);
+
+        int comparacoes;
+        if (registro[1] == OPERACAO_INSERIR) {
+            int id = internarTipo(&tiposComponentes, tipo);
+            if (id == -1 || *n >= MAX_COMPONENTES) {
+                continue;
+            }
+            comp.tipo = (uint8_t)id;
+            comps[*n] = comp;
+            if (!visoesInserir(v, comps, *n)) {
+                continue;
+            }
+            (*n)++;
+        } else if (registro[1] == OPERACAO_REMOVER) {
+            int pos = buscaBinariaVisao(v, comps, comp.nome, &comparacoes);
+            if (pos == -1) {
+                continue;
+            }
+            visoesRemover(v, comps, pos);
+            memmove(&comps[pos], &comps[pos + 1], (size_t)(*n - pos - 1) * sizeof(Componente));
+            (*n)--;
+        } else if (registro[1] == OPERACAO_PRIORIDADE) {
+            int pos = buscaBinariaVisao(v, comps, comp.nome, &comparacoes);
+            if (pos == -1) {
+                continue;
+            }
+            visoesAlterarPrioridade(v, comps, pos, comp.prioridade);
+        }
+        aplicados++;
+    }
+    fclose(arquivo);
+    return aplicados;
+}
 
-    printf("Digite o tipo do componente: ");
-    fgets(comp->tipo, 20, stdin);
-    comp->tipo[strcspn(comp->tipo, "\n")] = 0; // Remove newline
+// Compacta o diario d: grava os componentes em 'snapshot' e troca o diario por um vazio
+// que aponta para esse snapshot. Os dois arquivos novos sao gravados ao lado dos antigos
+// e renomeados, snapshot primeiro (uma queda entre os renames deixa o diario antigo, que a
+// repeticao ignora pela soma).
+// Retorna 1 se sucesso, 0 se falha (snapshot e diario antigos continuam valendo).
+// Complexidade: O(n + t).
+int compactarDiario(Diario* d, const char* snapshot, const Componente comps[], int n, const VisoesOrdenadas* v) {
+    char snapshotNovo[300];
+    char diarioNovo[300];
+    snprintf(snapshotNovo, sizeof(snapshotNovo), "%s.novo", snapshot);
+    snprintf(diarioNovo, sizeof(diarioNovo), "%s.novo", d->caminho);
+    confirmarDiario(d);
+    if (!salvarComponentes(comps, n, v, snapshotNovo)) {
+        return 0;
+    }
+    uint64_t soma = somaSnapshot(snapshotNovo);
+    remove(diarioNovo);
+    Diario novo = { .fd = -1 };
+    if (!abrirDiario(&novo, diarioNovo, 1, soma)) {
+        remove(snapshotNovo);
+        return 0;
+    }
+    fecharDiario(&novo);
+    if (rename(snapshotNovo, snapshot) != 0 || rename(diarioNovo, d->caminho) != 0) {
+        remove(snapshotNovo);
+        remove(diarioNovo);
+        return 0;
+    }
 
-    printf("Digite a prioridade (1-10): ");
-    scanf("%d", &comp->prioridade);
-    getchar(); // Consome newline apos scanf
+    // O descritor antigo aponta para o arquivo substituido: reabre o novo.
+    char caminho[256];
+    memcpy(caminho, d->caminho, sizeof(caminho));
+    if (d->fd >= 0) {
+        close(d->fd);
+        d->fd = -1;
+    }
+    d->compactacoes++;
+    return abrirDiario(d, caminho, d->intervalo, soma);
 }
 
-// Funcao para mostrar todos os componentes.
-// Percorre o array e imprime formatado.
-// Complexidade: O(n).
-void mostrarComponentes(Componente comps[], int n) {
+// Tempo de relogio monotono em segundos (tempo real decorrido, com resolucao de ns).
+double tempoAtual() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Funcao para medir tempo e executar um algoritmo de ordenacao.
+// Usa o relogio monotono para medir o tempo real decorrido em segundos.
+// Chama a funcao de sort e imprime tempo, comparacoes e movimentos.
+void medirTempoOrdenacao(void (*algoritmo)(Componente[], int, int*, int*), Componente comps[], int n, const char* nomeAlg) {
+    int comparacoes;
+    int movimentos;
+    uint64_t inicioOp;
+    ESTAT_INICIAR(inicioOp);
+    double start = tempoAtual();
+    algoritmo(comps, n, &comparacoes, &movimentos);
+    double tempo = tempoAtual() - start;
+    if (comparacoes < 0) {
+        printf("Algoritmo %s: falha ao alocar memoria, componentes nao ordenados.\n", nomeAlg);
+        return;
+    }
+    ESTAT_REGISTRAR(OP_ORDENAR, inicioOp);
+    ESTAT_SOMAR(comparacoes, comparacoes);
+    ESTAT_SOMAR(movimentos, movimentos);
+    printf("Algoritmo %s: Tempo = %.6f s, Comparacoes = %d, Movimentos = %d\n", nomeAlg, tempo, comparacoes, movimentos);
+}
+
+// Reconstroi as visoes depois que o menu reordenou o array. Se faltar memoria, as visoes
+// ficam marcadas como desatualizadas e o menu recusa as opcoes que dependem delas.
+void reconstruirVisoesMenu(VisoesOrdenadas* v, const Componente comps[], int n) {
+    if (!visoesReconstruir(v, comps, n)) {
+        printf("Aviso: falta de memoria ao reconstruir as visoes; buscas e consultas ficam bloqueadas.\n");
+    }
+}
+
+// Opcoes do menu que leem ou atualizam as visoes (e por isso exigem visoes em dia).
+int opcaoUsaVisoes(int opcao) {
+    switch (opcao) {
+        case 1: case 5: case 11: case 12: case 13: case 16: case 18:
+        case 20: case 21: case 23: case 24: case 25:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+// Ordenar por outro criterio desfaz a ordem por nome: avisa e desliga o modo.
+// Retorna o novo valor do modo (sempre 0).
+int desativarManterOrdenado(int manterOrdenado) {
+    if (manterOrdenado) {
+        printf("Array reordenado por outro criterio: modo manter ordenado desativado.\n");
+    }
+    return 0;
+}
+
+// Funcao para ler o criterio de ordenacao desejado.
+// Retorna o criterio escolhido, ou 0 se a opcao for invalida.
+int lerCriterio() {
+    int criterio;
+    printf("Ordenar por: 1. Nome  2. Tipo  3. Prioridade\n");
+    printf("Escolha: ");
+    scanf("%d", &criterio);
+    getchar(); // Consome newline
+    if (criterio < CRITERIO_NOME || criterio > CRITERIO_PRIORIDADE) {
+        return 0;
+    }
+    return criterio;
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark nao interativo (modo --bench)
+// ---------------------------------------------------------------------------
+
+// TipoDataset, NOMES_DATASET, proximoAleatorio, calcularPercentis e tempoAtual sao copias
+// dos de Desafio-aventureiro-sobrevivencia.c, que e a referencia: cada desafio compila
+// sozinho, entao o codigo e repetido. Altere la primeiro e mantenha as copias iguais.
+
+// Formas de dados gerados para o benchmark.
+typedef enum {
+    DATASET_ALEATORIO,
+    DATASET_ORDENADO,
+    DATASET_REVERSO,
+    DATASET_QUASE_ORDENADO
+} TipoDataset;
+
+const char* NOMES_DATASET[] = { "aleatorio", "ordenado", "reverso", "quase_ordenado" };
+
+// Algoritmos O(n^2) so rodam ate este tamanho (acima disso levariam horas).
+#define LIMITE_QUADRATICO 10000
+
+// Gerador pseudoaleatorio xorshift32 (rapido e reprodutivel com a mesma semente).
+unsigned int proximoAleatorio(unsigned int* estado) {
+    unsigned int x = *estado;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *estado = x;
+    return x;
+}
+
+// Preenche um componente a partir de um valor ordinal v em [0, n).
+// Nome, tipo e prioridade crescem todos com v, entao um dataset "ordenado"
+// esta ordenado pelas tres chaves ao mesmo tempo. Tipo e prioridade repetem
+// valores, como num inventario real.
+// O nome e v em base 26 com 6 letras seguido de "-comp" (ex.: "aaabcd-comp"):
+// como nomes reais, ele se diferencia logo nos primeiros caracteres.
+void gerarComponente(Componente* comp, int v, int n) {
+    static const char* tipos[] = { "controle", "estrutural", "propulsao", "suporte" };
+    for (int d = 5, x = v; d >= 0; d--, x /= 26) {
+        comp->nome[d] = (char)('a' + x % 26);
+    }
+    memcpy(&comp->nome[6], "-comp", 6);
+    comp->tipo = (uint8_t)internarTipo(&tiposComponentes, tipos[(long long)v * 4 / n]); // Sempre cabe: sao 4 tipos
+    comp->prioridade = 1 + (int)((long long)v * 10 / n);
+    normalizarComponente(comp);
+}
+
+// Gera n componentes na forma pedida.
+// Quase ordenado: ordenado com 1% dos elementos trocados de lugar ao acaso.
+void gerarDataset(Componente comps[], int n, TipoDataset tipo, unsigned int* semente) {
     for (int i = 0; i < n; i++) {
-        printf("Nome: %s, Tipo: %s, Prioridade: %d\n", comps[i].nome, comps[i].tipo, comps[i].prioridade);
+        gerarComponente(&comps[i], tipo == DATASET_REVERSO ? n - 1 - i : i, n);
+    }
+    if (tipo == DATASET_ALEATORIO) {
+        for (int i = n - 1; i > 0; i--) { // Fisher-Yates
+            int j = (int)(proximoAleatorio(semente) % (unsigned int)(i + 1));
+            Componente temp = comps[i];
+            comps[i] = comps[j];
+            comps[j] = temp;
+        }
+    } else if (tipo == DATASET_QUASE_ORDENADO) {
+        for (int k = 0; k < n / 100; k++) {
+            int i = (int)(proximoAleatorio(semente) % (unsigned int)n);
+            int j = (int)(proximoAleatorio(semente) % (unsigned int)n);
+            Componente temp = comps[i];
+            comps[i] = comps[j];
+            comps[j] = temp;
+        }
     }
 }
 
-// Bubble Sort por nome (string).
-// Ordena o array comparando strings com strcmp.
-// Conta o numero de comparacoes.
-// Complexidade: O(n^2) - bolhas elementos maiores para o final.
-void bubbleSortNome(Componente comps[], int n, int* comparacoes) {
-    *comparacoes = 0;
-    for (int i = 0; i < n - 1; i++) {
-        for (int j = 0; j < n - i - 1; j++) {
-            (*comparacoes)++;
-            if (strcmp(comps[j].nome, comps[j + 1].nome) > 0) {
-                Componente temp = comps[j];
-                comps[j] = comps[j + 1];
-                comps[j + 1] = temp;
+// Funcao de comparacao de doubles para qsort (usada nos percentis).
+int compararTempos(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Ordena os tempos e devolve a mediana e o percentil 95 (metodo do posto mais proximo).
+void calcularPercentis(double tempos[], int n, double* mediana, double* p95) {
+    qsort(tempos, n, sizeof(double), compararTempos);
+    *mediana = n % 2 ? tempos[n / 2] : (tempos[n / 2 - 1] + tempos[n / 2]) / 2;
+    int posto = (95 * n + 99) / 100; // ceil(0.95 * n)
+    *p95 = tempos[posto - 1];
+}
+
+// Um algoritmo de ordenacao no benchmark.
+typedef struct {
+    const char* nome;
+    void (*funcao)(Componente[], int, int*, int*);
+    int quadratico; // 1 se O(n^2)
+} AlgoritmoBench;
+
+// Linhas "merge_paralelo_<chave>_<T>t" do benchmark: o Merge Sort paralelo com
+// T = 1, 2, 4, 8 threads (e o numero de nucleos, se maior). Com T = 1 e o proprio mergeSort.
+// Confere que cada resultado e identico byte a byte ao do Merge Sort sequencial e escreve
+// em stderr o speedup de cada T em relacao a T = 1.
+// Retorna 1 se sucesso, 0 se algum resultado divergiu ou faltou memoria.
+static int benchmarkParalelo(const Componente original[], Componente trabalho[], Componente referencia[], double tempos[],
+                             int n, int repeticoes, const char* dataset, FILE* saida) {
+    const char* chaves[] = { "nome", "tipo", "prioridade" };
+    void (*funcoes[3])(Componente[], int, int*, int*) = { mergeSortParaleloNome, mergeSortParaleloTipo, mergeSortParaleloPrioridade };
+    int contagens[5] = { 1, 2, 4, 8, (int)sysconf(_SC_NPROCESSORS_ONLN) };
+    int numContagens = contagens[4] > 8 ? 5 : 4;
+    int ok = 1;
+    for (int c = CRITERIO_NOME; c <= CRITERIO_PRIORIDADE && ok; c++) {
+        int comparacoes = 0, movimentos = 0;
+        memcpy(referencia, original, (size_t)n * sizeof(Componente));
+        if (!mergeSort(referencia, n, (CriterioOrdenacao)c, &comparacoes, &movimentos)) {
+            return 0;
+        }
+        double base = 0;
+        fprintf(stderr, "speedup merge_paralelo_%s (%s):", chaves[c - 1], dataset);
+        for (int k = 0; k < numContagens && ok; k++) {
+            iniciarPool(&poolOrdenacao, contagens[k]);
+            for (int r = -1; r < repeticoes; r++) {
+                memcpy(trabalho, original, (size_t)n * sizeof(Componente));
+                double inicio = tempoAtual();
+                funcoes[c - 1](trabalho, n, &comparacoes, &movimentos);
+                double fim = tempoAtual();
+                if (r >= 0) {
+                    tempos[r] = fim - inicio;
+                }
             }
+            ok = comparacoes >= 0 && memcmp(trabalho, referencia, (size_t)n * sizeof(Componente)) == 0;
+            double mediana, p95;
+            calcularPercentis(tempos, repeticoes, &mediana, &p95);
+            if (k == 0) {
+                base = mediana;
+            }
+            fprintf(saida, "merge_paralelo_%s_%dt,%s,%d,%d,1,%.9f,%.9f,%d,%d,%lld\n", chaves[c - 1], poolOrdenacao.numThreads, dataset, n,
+                    repeticoes, mediana, p95, comparacoes, movimentos, (long long)movimentos * (long long)sizeof(Componente));
+            fprintf(stderr, " %dt %.2fx", poolOrdenacao.numThreads, mediana > 0 ? base / mediana : 0.0);
+            encerrarPool(&poolOrdenacao);
         }
+        fprintf(stderr, ok ? "\n" : " DIVERGENTE do Merge Sort sequencial\n");
+        fflush(saida);
     }
+    return ok;
 }
 
-// Insertion Sort por tipo (string).
-// Insere cada elemento na posicao correta na sublista ordenada.
-// Conta o numero de comparacoes.
-// Complexidade: O(n^2) - eficiente para listas quase ordenadas.
-void insertionSortTipo(Componente comps[], int n, int* comparacoes) {
-    *comparacoes = 0;
-    for (int i = 1; i < n; i++) {
-        Componente key = comps[i];
-        int j = i - 1;
-        while (j >= 0) {
-            (*comparacoes)++;
-            if (strcmp(comps[j].tipo, key.tipo) > 0) {
-                comps[j + 1] = comps[j];
-                j--;
-            } else {
-                break;
+// Executa o benchmark completo e escreve uma linha CSV por (algoritmo, dataset):
+// algoritmo,dataset,n,repeticoes,operacoes,mediana_s,p95_s,comparacoes,movimentos,bytes_movidos
+// Para ordenacoes, operacoes = 1 e os tempos sao da ordenacao inteira.
+// Os sufixos _desc sao as instancias DECRESCENTE de DEFINIR_ORDENACOES (maior prioridade primeiro).
+// No modo por indices, "indice_*" so ordena as entradas compactas (movimentos de
+// ChaveIndice) e "indice_*_aplicado" inclui aplicar a permutacao aos Componentes.
+// Para buscas, operacoes = numero de consultas por repeticao, os tempos sao
+// por consulta e as comparacoes sao a media por consulta.
+// Cada medida tem uma execucao de aquecimento descartada antes das repeticoes.
+// As linhas merge_paralelo_* vem de benchmarkParalelo (speedup por numero de threads em stderr).
+int executarBenchmark(int n, int repeticoes, FILE* saida) {
+    AlgoritmoBench algoritmos[] = {
+        { "bubble_nome", bubbleSortNome, 1 },
+        { "insertion_tipo", insertionSortTipo, 1 },
+        { "selection_prioridade", selectionSortPrioridade, 1 },
+        { "merge_nome", mergeSortNome, 0 },
+        { "merge_tipo", mergeSortTipo, 0 },
+        { "merge_prioridade", mergeSortPrioridade, 0 },
+        { "introsort_nome", introsortNome, 0 },
+        { "introsort_tipo", introsortTipo, 0 },
+        { "introsort_prioridade", introsortPrioridade, 0 },
+        { "heap_nome", heapSortNome, 0 },
+        { "heap_tipo", heapSortTipo, 0 },
+        { "heap_prioridade", heapSortPrioridade, 0 },
+        { "merge_prioridade_desc", mergeSortPrioridadeDecrescente, 0 },
+        { "introsort_prioridade_desc", introsortPrioridadeDecrescente, 0 },
+        { "insertion_nome", insertionSortNome, 1 },
+        { "counting_tipo", countingSortTipo, 0 },
+        { "radix_nome", radixSortNome, 0 },
+        { "counting_prioridade", countingSortPrioridade, 0 },
+        { "radix_tipo_prioridade_nome", radixSortTipoPrioridadeNome, 0 }
+    };
+    int numAlgoritmos = (int)(sizeof(algoritmos) / sizeof(algoritmos[0]));
+
+    const char* chaves[] = { "nome", "tipo", "prioridade" };
+
+    Componente* original = (Componente*)malloc((size_t)n * sizeof(Componente));
+    Componente* trabalho = (Componente*)malloc((size_t)n * sizeof(Componente));
+    uint32_t* ordem = (uint32_t*)malloc((size_t)n * sizeof(uint32_t));
+    double* tempos = (double*)malloc((size_t)repeticoes * sizeof(double));
+    double* temposAplicado = (double*)malloc((size_t)repeticoes * sizeof(double));
+    Componente* referencia = (Componente*)malloc((size_t)n * sizeof(Componente));
+    if (!original || !trabalho || !ordem || !tempos || !temposAplicado || !referencia) {
+        free(original);
+        free(trabalho);
+        free(referencia);
+        free(ordem);
+        free(tempos);
+        free(temposAplicado);
+        fprintf(stderr, "Falha ao alocar memoria para %d componentes.\n", n);
+        return 0;
+    }
+
+    unsigned int semente = 12345;
+    fprintf(saida, "algoritmo,dataset,n,repeticoes,operacoes,mediana_s,p95_s,comparacoes,movimentos,bytes_movidos\n");
+    for (int d = DATASET_ALEATORIO; d <= DATASET_QUASE_ORDENADO; d++) {
+        gerarDataset(original, n, (TipoDataset)d, &semente);
+        for (int a = 0; a < numAlgoritmos; a++) {
+            if (algoritmos[a].quadratico && n > LIMITE_QUADRATICO) {
+                fprintf(stderr, "Pulando %s: n > %d.\n", algoritmos[a].nome, LIMITE_QUADRATICO);
+                continue;
+            }
+            int comparacoes = 0, movimentos = 0;
+            for (int r = -1; r < repeticoes; r++) { // r = -1: aquecimento
+                memcpy(trabalho, original, (size_t)n * sizeof(Componente));
+                double inicio = tempoAtual();
+                algoritmos[a].funcao(trabalho, n, &comparacoes, &movimentos);
+                double fim = tempoAtual();
+                if (r >= 0) {
+                    tempos[r] = fim - inicio;
+                }
+            }
+            double mediana, p95;
+            calcularPercentis(tempos, repeticoes, &mediana, &p95);
+            fprintf(saida, "%s,%s,%d,%d,1,%.9f,%.9f,%d,%d,%lld\n", algoritmos[a].nome, NOMES_DATASET[d], n,
+                    repeticoes, mediana, p95, comparacoes, movimentos, (long long)movimentos * (long long)sizeof(Componente));
+            fflush(saida);
+        }
+
+        for (int c = CRITERIO_NOME; c <= CRITERIO_PRIORIDADE; c++) {
+            int comparacoes = 0, movimentosIndice = 0, movimentosComp = 0;
+            int r = -1;
+            for (; r < repeticoes; r++) {
+                memcpy(trabalho, original, (size_t)n * sizeof(Componente));
+                double inicio = tempoAtual();
+                if (!ordenarIndices(trabalho, n, (CriterioOrdenacao)c, ordem, &comparacoes, &movimentosIndice)) {
+                    break;
+                }
+                double meio = tempoAtual();
+                movimentosComp = aplicarPermutacao(trabalho, n, ordem);
+                double fim = tempoAtual();
+                if (r >= 0) {
+                    tempos[r] = meio - inicio;
+                    temposAplicado[r] = fim - inicio;
+                }
+            }
+            if (r < repeticoes) {
+                // Os tempos das repeticoes que faltaram nao foram medidos: a linha nao sai.
+                fprintf(stderr, "Pulando indice_%s: falha na alocacao.\n", chaves[c - 1]);
+                continue;
+            }
+            long long bytesIndice = (long long)movimentosIndice * (long long)sizeof(ChaveIndice);
+            double mediana, p95;
+            calcularPercentis(tempos, repeticoes, &mediana, &p95);
+            fprintf(saida, "indice_%s,%s,%d,%d,1,%.9f,%.9f,%d,%d,%lld\n", chaves[c - 1], NOMES_DATASET[d], n,
+                    repeticoes, mediana, p95, comparacoes, movimentosIndice, bytesIndice);
+            calcularPercentis(temposAplicado, repeticoes, &mediana, &p95);
+            fprintf(saida, "indice_%s_aplicado,%s,%d,%d,1,%.9f,%.9f,%d,%d,%lld\n", chaves[c - 1], NOMES_DATASET[d], n,
+                    repeticoes, mediana, p95, comparacoes, movimentosIndice + movimentosComp,
+                    bytesIndice + (long long)movimentosComp * (long long)sizeof(Componente));
+            fflush(saida);
+        }
+
+        if (!benchmarkParalelo(original, trabalho, referencia, tempos, n, repeticoes, NOMES_DATASET[d], saida)) {
+            fprintf(stderr, "Merge Sort paralelo divergiu do sequencial.\n");
+            free(original);
+            free(trabalho);
+            free(referencia);
+            free(ordem);
+            free(tempos);
+            free(temposAplicado);
+            return 0;
+        }
+    }
+
+    // Busca binaria: consultas alternando nomes presentes e ausentes num array ordenado por nome.
+    int consultas = 100000;
+    int comparacoes, movimentos;
+    gerarDataset(original, n, DATASET_ORDENADO, &semente);
+    mergeSortNome(original, n, &comparacoes, &movimentos);
+    long long totalComparacoes = 0;
+    Componente chave;
+    unsigned int sementeBusca = semente;
+    for (int r = -1; r < repeticoes; r++) {
+        long long soma = 0;
+        double inicio = tempoAtual();
+        for (int q = 0; q < consultas; q++) {
+            gerarComponente(&chave, (int)(proximoAleatorio(&semente) % (unsigned int)n), n);
+            if (q % 2) {
+                chave.nome[11] = 'x'; // "aaabcd-compx" nao existe
+                chave.nome[12] = '\0';
+            }
+            buscaBinariaPorNome(original, n, chave.nome, &comparacoes);
+            soma += comparacoes;
+        }
+        double fim = tempoAtual();
+        if (r >= 0) {
+            tempos[r] = (fim - inicio) / consultas;
+            totalComparacoes += soma;
+        }
+    }
+    double mediana, p95;
+    calcularPercentis(tempos, repeticoes, &mediana, &p95);
+    fprintf(saida, "busca_binaria_nome,%s,%d,%d,%d,%.9f,%.9f,%.2f,0,0\n", NOMES_DATASET[DATASET_ORDENADO], n, repeticoes,
+            consultas, mediana, p95, (double)totalComparacoes / ((double)consultas * repeticoes));
+
+    // Busca no layout de Eytzinger: cada repeticao refaz as consultas da primeira passada
+    // acima (metade ausentes). A montagem do layout (O(n)) sai numa linha propria.
+    LayoutEytzinger ez;
+    for (int r = -1; r < repeticoes; r++) {
+        double inicio = tempoAtual();
+        int ok = montarEytzinger(&ez, original, n);
+        double fim = tempoAtual();
+        if (!ok) {
+            fprintf(stderr, "Falha na alocacao.\n");
+            break;
+        }
+        if (r >= 0) {
+            tempos[r] = fim - inicio;
+        }
+        if (r < repeticoes - 1) {
+            liberarEytzinger(&ez);
+        }
+    }
+    if (ez.prefixos) {
+        calcularPercentis(tempos, repeticoes, &mediana, &p95);
+        fprintf(saida, "montar_eytzinger_nome,%s,%d,%d,1,%.9f,%.9f,0,%d,%lld\n", NOMES_DATASET[DATASET_ORDENADO], n, repeticoes,
+                mediana, p95, n, (long long)n * (long long)(sizeof(uint64_t) + sizeof(int)));
+    }
+    totalComparacoes = 0;
+    long long divergentes = 0;
+    for (int r = -1; ez.prefixos && r < repeticoes; r++) {
+        long long soma = 0;
+        unsigned int sementeConsulta = sementeBusca;
+        double inicio = tempoAtual();
+        for (int q = 0; q < consultas; q++) {
+            gerarComponente(&chave, (int)(proximoAleatorio(&sementeConsulta) % (unsigned int)n), n);
+            if (q % 2) {
+                chave.nome[11] = 'x';
+                chave.nome[12] = '\0';
+            }
+            int pos = buscaEytzingerPorNome(&ez, original, chave.nome, &comparacoes);
+            divergentes += (pos == -1) != (q % 2 == 1);
+            soma += comparacoes;
+        }
+        double fim = tempoAtual();
+        if (r >= 0) {
+            tempos[r] = (fim - inicio) / consultas;
+            totalComparacoes += soma;
+        }
+    }
+    if (ez.prefixos) {
+        calcularPercentis(tempos, repeticoes, &mediana, &p95);
+        fprintf(saida, "busca_eytzinger_nome,%s,%d,%d,%d,%.9f,%.9f,%.2f,0,0\n", NOMES_DATASET[DATASET_ORDENADO], n, repeticoes,
+                consultas, mediana, p95, (double)totalComparacoes / ((double)consultas * repeticoes));
+        if (divergentes) {
+            fprintf(stderr, "Busca de Eytzinger errou %lld consultas.\n", divergentes);
+        }
+    }
+    liberarEytzinger(&ez);
+
+    // Fila de prioridade: montar o heap (O(n)) e pedir os 10 de maior prioridade
+    // (O(k log k)), contra ordenar o array inteiro por prioridade (linhas acima).
+    VisoesOrdenadas visoes;
+    initVisoes(&visoes);
+    gerarDataset(original, n, DATASET_ALEATORIO, &semente);
+    if (visoesReconstruir(&visoes, original, n)) {
+        int topo[10];
+        int consultasTopo = 100000;
+        for (int r = -1; r < repeticoes; r++) {
+            double inicio = tempoAtual();
+            heapConstruir(&visoes, original, n);
+            double fim = tempoAtual();
+            if (r >= 0) {
+                tempos[r] = fim - inicio;
+            }
+        }
+        calcularPercentis(tempos, repeticoes, &mediana, &p95);
+        fprintf(saida, "construir_fila_prioridade,%s,%d,%d,1,%.9f,%.9f,0,0,0\n", NOMES_DATASET[DATASET_ALEATORIO], n, repeticoes,
+                mediana, p95);
+        for (int r = -1; r < repeticoes; r++) {
+            double inicio = tempoAtual();
+            for (int q = 0; q < consultasTopo; q++) {
+                maioresPrioridades(&visoes, original, 10, topo);
+            }
+            double fim = tempoAtual();
+            if (r >= 0) {
+                tempos[r] = (fim - inicio) / consultasTopo;
             }
         }
-        comps[j + 1] = key;
+        calcularPercentis(tempos, repeticoes, &mediana, &p95);
+        fprintf(saida, "top10_fila_prioridade,%s,%d,%d,%d,%.9f,%.9f,0,0,0\n", NOMES_DATASET[DATASET_ALEATORIO], n, repeticoes,
+                consultasTopo, mediana, p95);
+    } else {
+        fprintf(stderr, "Falha na alocacao.\n");
     }
+    liberarVisoes(&visoes);
+
+    free(original);
+    free(trabalho);
+    free(referencia);
+    free(ordem);
+    free(tempos);
+    free(temposAplicado);
+    return 1;
 }
 
-// Selection Sort por prioridade (int).
-// Seleciona o menor elemento e troca com a posicao atual.
-// Conta o numero de comparacoes.
-// Complexidade: O(n^2) - sempre faz n^2 comparacoes.
-void selectionSortPrioridade(Componente comps[], int n, int* comparacoes) {
-    *comparacoes = 0;
-    for (int i = 0; i < n - 1; i++) {
-        int min_idx = i;
-        for (int j = i + 1; j < n; j++) {
-            (*comparacoes)++;
-            if (comps[j].prioridade < comps[min_idx].prioridade) {
-                min_idx = j;
+// Autoteste (--autoteste)
+//
+// Conferencias sem menu e sem tocar em torre.bin: cada funcao autoteste* monta os seus
+// dados, confere um recurso e mostra ok/FALHOU por item. Os arquivos temporarios ficam
+// no diretorio atual e sao apagados no fim.
+#define ARQUIVO_AUTOTESTE "autoteste_torre.bin"
+#define CORROMPIDO_AUTOTESTE "autoteste_corrompido.bin"
+#define DIARIO_AUTOTESTE "autoteste_torre.diario"
+#define COMPONENTES_AUTOTESTE 1000
+
+// Mostra o resultado de uma conferencia e o devolve.
+static int conferirAutoteste(const char* descricao, int ok) {
+    printf("%-62s %s\n", descricao, ok ? "ok" : "FALHOU");
+    return ok;
+}
+
+// 1 se os dois arrays tem os mesmos componentes na mesma ordem (campo a campo:
+// os bytes de preenchimento da struct nao contam).
+static int mesmosComponentes(const Componente a[], const Componente b[], int n) {
+    for (int i = 0; i < n; i++) {
+        if (memcmp(a[i].nome, b[i].nome, sizeof(a[i].nome)) != 0 || a[i].tipo != b[i].tipo || a[i].prioridade != b[i].prioridade) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Ordena uma copia de 'origem' com 'algoritmo' e outra com 'referencia' e compara.
+static int mesmaOrdenacao(void (*algoritmo)(Componente[], int, int*, int*), void (*referencia)(Componente[], int, int*, int*),
+                          const Componente origem[], int n, Componente a[], Componente b[]) {
+    int comparacoes, movimentos, comparacoesReferencia;
+    memcpy(a, origem, (size_t)n * sizeof(Componente));
+    memcpy(b, origem, (size_t)n * sizeof(Componente));
+    algoritmo(a, n, &comparacoes, &movimentos);
+    referencia(b, n, &comparacoesReferencia, &movimentos);
+    return comparacoes >= 0 && comparacoesReferencia >= 0 && mesmosComponentes(a, b, n);
+}
+
+// Referencia para radixSortTipoPrioridadeNome: as mesmas tres passadas com Merge Sort.
+static void mergeSortTipoPrioridadeNome(Componente comps[], int n, int* comparacoes, int* movimentos) {
+    int c, m;
+    mergeSortNome(comps, n, comparacoes, movimentos);
+    mergeSortPrioridade(comps, n, &c, &m);
+    *comparacoes = *comparacoes < 0 || c < 0 ? -1 : *comparacoes + c;
+    mergeSortTipo(comps, n, &c, &m);
+    *comparacoes = *comparacoes < 0 || c < 0 ? -1 : *comparacoes + c;
+}
+
+// 1 se as visoes de 'v' sao as mesmas que visoesReconstruir monta do zero para comps[].
+static int mesmasVisoes(const VisoesOrdenadas* v, const Componente comps[], int n) {
+    VisoesOrdenadas referencia;
+    initVisoes(&referencia);
+    int ok = v->tamanho == n && !v->desatualizadas && visoesReconstruir(&referencia, comps, n);
+    for (int c = 0; ok && c < 3; c++) {
+        ok = memcmp(v->porCriterio[c], referencia.porCriterio[c], (size_t)n * sizeof(int)) == 0;
+    }
+    liberarVisoes(&referencia);
+    return ok;
+}
+
+// Confere as visoes: cada uma e uma permutacao de 0..n-1 em ordem de (chave, posicao).
+// Retorna 1 se tudo confere.
+static int conferirVisoes(const VisoesOrdenadas* v, const Componente comps[], int n) {
+    if (v->tamanho != n || v->desatualizadas) {
+        return 0;
+    }
+    unsigned char* visto = (unsigned char*)malloc((size_t)(n > 0 ? n : 1));
+    int ok = visto != NULL;
+    for (int c = CRITERIO_NOME; c <= CRITERIO_PRIORIDADE && ok; c++) {
+        const int* visao = v->porCriterio[c - 1];
+        memset(visto, 0, (size_t)n);
+        for (int i = 0; ok && i < n; i++) {
+            int comparacoes = 0;
+            ok = visao[i] >= 0 && visao[i] < n && !visto[visao[i]];
+            if (ok && i > 0) {
+                int cmp = compararComponentes(&comps[visao[i - 1]], &comps[visao[i]], (CriterioOrdenacao)c, &comparacoes);
+                ok = cmp < 0 || (cmp == 0 && visao[i - 1] < visao[i]);
+            }
+            if (ok) {
+                visto[visao[i]] = 1;
             }
         }
-        if (min_idx != i) {
-            Componente temp = comps[i];
-            comps[i] = comps[min_idx];
-            comps[min_idx] = temp;
+    }
+    free(visto);
+    return ok;
+}
+
+// Confere o heap: nenhum filho sai antes do pai e noHeap e o inverso de heap.
+// Retorna 1 se tudo confere.
+static int conferirHeap(const VisoesOrdenadas* v, const Componente comps[], int n) {
+    if (v->tamanho != n) {
+        return 0;
+    }
+    for (int i = 0; i < n; i++) {
+        int pos = v->heap[i];
+        if (pos < 0 || pos >= n || v->noHeap[pos] != i || (i > 0 && heapAntes(comps, pos, v->heap[(i - 1) / 2]))) {
+            return 0;
         }
     }
+    return 1;
 }
 
-// Busca binaria por nome (requer array ordenado por nome).
-// Conta o numero de comparacoes.
-// Retorna indice se encontrado, -1 caso contrario.
-// Complexidade: O(log n) - divide o espaco de busca pela metade a cada passo.
-int buscaBinariaPorNome(Componente comps[], int n, char* nome, int* comparacoes) {
-    *comparacoes = 0;
-    int low = 0;
-    int high = n - 1;
-    while (low <= high) {
-        (*comparacoes)++;
-        int mid = (low + high) / 2;
-        int cmp = strcmp(comps[mid].nome, nome);
-        if (cmp == 0) {
-            return mid;
-        } else if (cmp < 0) {
-            low = mid + 1;
-        } else {
-            high = mid - 1;
+// Remove comps[pos] das visoes e do array (como a opcao de remover do menu).
+static void removerComponenteAutoteste(Componente comps[], int* n, VisoesOrdenadas* v, int pos) {
+    visoesRemover(v, comps, pos);
+    memmove(&comps[pos], &comps[pos + 1], (size_t)(*n - pos - 1) * sizeof(Componente));
+    (*n)--;
+}
+
+// Le o arquivo inteiro. Retorna o buffer (liberar com free) ou NULL se falhou.
+static unsigned char* lerArquivoInteiro(const char* caminho, size_t* tamanho) {
+    FILE* arquivo = fopen(caminho, "rb");
+    if (!arquivo) {
+        return NULL;
+    }
+    unsigned char* dados = NULL;
+    long fim = -1;
+    if (fseek(arquivo, 0, SEEK_END) == 0 && (fim = ftell(arquivo)) > 0) {
+        dados = (unsigned char*)malloc((size_t)fim);
+        rewind(arquivo);
+        if (dados && fread(dados, 1, (size_t)fim, arquivo) != (size_t)fim) {
+            free(dados);
+            dados = NULL;
         }
     }
-    return -1;
+    fclose(arquivo);
+    *tamanho = dados ? (size_t)fim : 0;
+    return dados;
 }
 
-// Funcao para medir tempo e executar um algoritmo de ordenacao.
-// Usa clock() para medir tempo em segundos.
-// Chama a funcao de sort e imprime tempo e comparacoes.
-void medirTempoOrdenacao(void (*algoritmo)(Componente[], int, int*), Componente comps[], int n, const char* nomeAlg) {
-    int comparacoes;
-    clock_t start = clock();
-    algoritmo(comps, n, &comparacoes);
-    clock_t end = clock();
-    double tempo = (double)(end - start) / CLOCKS_PER_SEC;
-    printf("Algoritmo %s: Tempo = %.6f s, Comparacoes = %d\n", nomeAlg, tempo, comparacoes);
+// Grava 'tamanho' bytes em 'caminho' (substituindo o arquivo). Retorna 1 se sucesso.
+static int gravarArquivoInteiro(const char* caminho, const void* dados, size_t tamanho) {
+    FILE* arquivo = fopen(caminho, "wb");
+    if (!arquivo) {
+        return 0;
+    }
+    int ok = fwrite(dados, 1, tamanho, arquivo) == tamanho;
+    return fclose(arquivo) == 0 && ok;
+}
+
+// Grava a copia alterada de um snapshot e tenta carrega-la.
+// Retorna 1 se o arquivo foi recusado sem mexer na torre nem no dicionario de tipos.
+static int snapshotRecusado(Componente comps[], int* n, VisoesOrdenadas* v, const unsigned char* dados, size_t tamanho) {
+    int tipos = tiposComponentes.quantidade;
+    int antes = *n;
+    Componente copia[MAX_COMPONENTES];
+    memcpy(copia, comps, (size_t)antes * sizeof(Componente));
+    return gravarArquivoInteiro(CORROMPIDO_AUTOTESTE, dados, tamanho)
+           && !carregarComponentes(comps, n, v, CORROMPIDO_AUTOTESTE)
+           && tiposComponentes.quantidade == tipos && *n == antes && mesmosComponentes(comps, copia, antes);
+}
+
+// Snapshot: ida e volta (torre e visoes) e arquivos que devem ser recusados (soma,
+// tamanho, versao, visao que nao e permutacao e tipo fora do dicionario).
+static int autotesteSnapshot(unsigned int* semente) {
+    Componente torre[MAX_COMPONENTES];
+    Componente lidos[MAX_COMPONENTES];
+    int numTorre = 15, numLidos = 0;
+    VisoesOrdenadas visoesTorre, visoesLidas;
+    initVisoes(&visoesTorre);
+    initVisoes(&visoesLidas);
+    int ok = 1;
+    gerarDataset(torre, numTorre, DATASET_ALEATORIO, semente);
+    int passo = visoesReconstruir(&visoesTorre, torre, numTorre) && salvarComponentes(torre, numTorre, &visoesTorre, ARQUIVO_AUTOTESTE)
+                && carregarComponentes(lidos, &numLidos, &visoesLidas, ARQUIVO_AUTOTESTE);
+    ok &= conferirAutoteste("snapshot: salvar e carregar devolvem torre e visoes",
+                            passo && numLidos == numTorre && mesmosComponentes(lidos, torre, numTorre)
+                            && mesmasVisoes(&visoesLidas, lidos, numLidos));
+    size_t bytes = 0;
+    unsigned char* dados = lerArquivoInteiro(ARQUIVO_AUTOTESTE, &bytes);
+    unsigned char* copia = dados ? (unsigned char*)malloc(bytes) : NULL;
+    if (copia) {
+        memcpy(copia, dados, bytes);
+        CabecalhoArquivo* cab = (CabecalhoArquivo*)copia;
+        Componente* comps = (Componente*)(copia + sizeof(CabecalhoArquivo));
+        char (*tipos)[20] = (char (*)[20])(comps + numTorre);
+        int* visaoNome = (int*)(tipos + cab->quantidadeTipos);
+        comps[2].nome[0] ^= 1;
+        passo = snapshotRecusado(lidos, &numLidos, &visoesLidas, copia, bytes);
+        memcpy(copia, dados, bytes);
+        passo = passo && snapshotRecusado(lidos, &numLidos, &visoesLidas, copia, bytes - 1);
+        memcpy(copia, dados, bytes);
+        cab->versao = VERSAO_ARQUIVO + 1;
+        passo = passo && snapshotRecusado(lidos, &numLidos, &visoesLidas, copia, bytes);
+        // Soma correta, mas uma posicao repetida na visao por nome.
+        memcpy(copia, dados, bytes);
+        visaoNome[1] = visaoNome[0];
+        cab->soma = somaVerificacao(copia + sizeof(CabecalhoArquivo), bytes - sizeof(CabecalhoArquivo), 14695981039346656037ull);
+        passo = passo && snapshotRecusado(lidos, &numLidos, &visoesLidas, copia, bytes);
+        // Soma correta, mas um tipo fora do dicionario do arquivo: o tipo novo do
+        // arquivo nao pode sobrar em tiposComponentes.
+        memcpy(copia, dados, bytes);
+        snprintf(tipos[0], sizeof(tipos[0]), "tipo-do-arquivo");
+        comps[0].tipo = 200;
+        cab->soma = somaVerificacao(copia + sizeof(CabecalhoArquivo), bytes - sizeof(CabecalhoArquivo), 14695981039346656037ull);
+        passo = passo && snapshotRecusado(lidos, &numLidos, &visoesLidas, copia, bytes) && buscarTipo(&tiposComponentes, "tipo-do-arquivo") == -1;
+    }
+    ok &= conferirAutoteste("snapshot: recusa soma, tamanho, versao, visao e tipo ruins",
+                            copia && passo && mesmasVisoes(&visoesLidas, lidos, numLidos));
+    free(dados);
+    free(copia);
+    liberarVisoes(&visoesTorre);
+    liberarVisoes(&visoesLidas);
+    return ok;
+}
+
+// Diario: cadastros, remocoes e mudancas de prioridade sobre o snapshot, com uma
+// queda no meio do ultimo registro. A repeticao preserva a ordem do array.
+static int autotesteDiario(unsigned int* semente) {
+    Componente torre[MAX_COMPONENTES];
+    Componente lidos[MAX_COMPONENTES];
+    int numTorre = 15, numLidos = 0;
+    VisoesOrdenadas visoesTorre, visoesLidas;
+    initVisoes(&visoesTorre);
+    initVisoes(&visoesLidas);
+    int ok = 1;
+    uint64_t soma = 0;
+    Diario d = { .fd = -1 };
+    remove(DIARIO_AUTOTESTE);
+    gerarDataset(torre, numTorre, DATASET_ALEATORIO, semente);
+    int passo = visoesReconstruir(&visoesTorre, torre, numTorre) && salvarComponentes(torre, numTorre, &visoesTorre, ARQUIVO_AUTOTESTE)
+                && (soma = somaSnapshot(ARQUIVO_AUTOTESTE)) != 0 && abrirDiario(&d, DIARIO_AUTOTESTE, 2, soma);
+    Componente novos[3];
+    for (int j = 0; passo && j < 3; j++) {
+        gerarComponente(&novos[j], numTorre + j, numTorre + 3);
+        registrarOperacao(&d, OPERACAO_INSERIR, novos[j].nome, nomeDoTipo(&tiposComponentes, novos[j].tipo), novos[j].prioridade);
+    }
+    Componente esperado[MAX_COMPONENTES];
+    int numEsperado = numTorre;
+    memcpy(esperado, torre, (size_t)numTorre * sizeof(Componente));
+    memcpy(&esperado[numEsperado], novos, sizeof(novos));
+    numEsperado += 3;
+    const int removidos[2] = { 4, 0 }; // Posicoes no array esperado no momento de cada remocao
+    for (int r = 0; passo && r < 2; r++) {
+        registrarOperacao(&d, OPERACAO_REMOVER, esperado[removidos[r]].nome, "", 0);
+        memmove(&esperado[removidos[r]], &esperado[removidos[r] + 1], (size_t)(numEsperado - removidos[r] - 1) * sizeof(Componente));
+        numEsperado--;
+    }
+    for (int j = 0; passo && j < 2; j++) {
+        esperado[3 * j + 1].prioridade = esperado[3 * j + 1].prioridade % PRIORIDADE_MAXIMA + 1;
+        registrarOperacao(&d, OPERACAO_PRIORIDADE, esperado[3 * j + 1].nome, "", esperado[3 * j + 1].prioridade);
+    }
+    fecharDiario(&d);
+    const unsigned char cortado[9] = { 40, OPERACAO_REMOVER, 0, 0, 0, 0, 20, 'a', 'a' };
+    FILE* arquivo = passo ? fopen(DIARIO_AUTOTESTE, "ab") : NULL;
+    passo = arquivo && fwrite(cortado, 1, sizeof(cortado), arquivo) == sizeof(cortado) && d.falhas == 0;
+    if (arquivo) {
+        passo = fclose(arquivo) == 0 && passo;
+    }
+    passo = passo && carregarComponentes(lidos, &numLidos, &visoesLidas, ARQUIVO_AUTOTESTE)
+            && repetirDiario(DIARIO_AUTOTESTE, soma, lidos, &numLidos, &visoesLidas) == 7;
+    ok &= conferirAutoteste("diario: repete ate o registro cortado pela queda",
+                            passo && numLidos == numEsperado && mesmosComponentes(lidos, esperado, numEsperado)
+                            && mesmasVisoes(&visoesLidas, lidos, numLidos));
+    passo = carregarComponentes(lidos, &numLidos, &visoesLidas, ARQUIVO_AUTOTESTE)
+            && repetirDiario(DIARIO_AUTOTESTE, soma + 1, lidos, &numLidos, &visoesLidas) == 0;
+    ok &= conferirAutoteste("diario: de outro snapshot nao repete nada",
+                            passo && numLidos == numTorre && mesmosComponentes(lidos, torre, numTorre));
+    liberarVisoes(&visoesTorre);
+    liberarVisoes(&visoesLidas);
+    return ok;
+}
+
+// Visoes: depois de reconstruir, remover, mudar prioridades e inserir no meio do array,
+// conferem as invariantes e batem com uma reconstrucao do zero.
+static int autotesteVisoes(unsigned int* semente) {
+    const int n = COMPONENTES_AUTOTESTE;
+    Componente* a = (Componente*)malloc((size_t)(n + 16) * sizeof(Componente));
+    if (!a) {
+        return conferirAutoteste("visoes: falha na alocacao", 0);
+    }
+    VisoesOrdenadas v;
+    initVisoes(&v);
+    int ok = 1;
+    int tamanho = n;
+    gerarDataset(a, n, DATASET_ALEATORIO, semente);
+    int passo = visoesReconstruir(&v, a, tamanho);
+    ok &= conferirAutoteste("visoes depois de visoesReconstruir", passo && conferirVisoes(&v, a, tamanho));
+    for (int r = 0; passo && r < 100; r++) {
+        removerComponenteAutoteste(a, &tamanho, &v, (int)(proximoAleatorio(semente) % (unsigned int)tamanho));
+    }
+    ok &= conferirAutoteste("visoes: 100 remocoes", passo && conferirVisoes(&v, a, tamanho) && mesmasVisoes(&v, a, tamanho));
+    for (int r = 0; r < 200; r++) {
+        int pos = (int)(proximoAleatorio(semente) % (unsigned int)tamanho);
+        visoesAlterarPrioridade(&v, a, pos, 1 + (int)(proximoAleatorio(semente) % PRIORIDADE_MAXIMA));
+    }
+    ok &= conferirAutoteste("visoes: 200 mudancas de prioridade", conferirVisoes(&v, a, tamanho) && mesmasVisoes(&v, a, tamanho));
+    for (int j = 0; passo && j < 16; j++) {
+        int pos = (int)(proximoAleatorio(semente) % (unsigned int)(tamanho + 1));
+        memmove(&a[pos + 1], &a[pos], (size_t)(tamanho - pos) * sizeof(Componente));
+        gerarComponente(&a[pos], n - 1 - j, n);
+        passo = visoesInserir(&v, a, pos);
+        tamanho += passo;
+    }
+    ok &= conferirAutoteste("visoes: 16 insercoes no meio do array",
+                            passo && conferirVisoes(&v, a, tamanho) && mesmasVisoes(&v, a, tamanho));
+    liberarVisoes(&v);
+    free(a);
+    return ok;
+}
+
+// Heap: remover o maximo, mudar prioridades, inserir e pegar os 10 de maior prioridade.
+static int autotesteHeap(unsigned int* semente) {
+    const int n = COMPONENTES_AUTOTESTE;
+    Componente* a = (Componente*)malloc((size_t)(n + 16) * sizeof(Componente));
+    if (!a) {
+        return conferirAutoteste("heap: falha na alocacao", 0);
+    }
+    VisoesOrdenadas v;
+    initVisoes(&v);
+    int ok = 1;
+    int tamanho = n;
+    gerarDataset(a, n, DATASET_ALEATORIO, semente);
+    int passo = visoesReconstruir(&v, a, tamanho);
+    ok &= conferirAutoteste("heap depois de visoesReconstruir", passo && conferirHeap(&v, a, tamanho));
+    for (int r = 0; passo && r < 100; r++) {
+        int maior = visoesMaiorPrioridade(&v);
+        for (int i = 0; passo && i < tamanho; i++) {
+            passo = i == maior || heapAntes(a, maior, i);
+        }
+        removerComponenteAutoteste(a, &tamanho, &v, maior);
+    }
+    ok &= conferirAutoteste("heap: remover o maximo 100 vezes", passo && conferirHeap(&v, a, tamanho));
+    for (int r = 0; r < 200; r++) {
+        int pos = (int)(proximoAleatorio(semente) % (unsigned int)tamanho);
+        visoesAlterarPrioridade(&v, a, pos, 1 + (int)(proximoAleatorio(semente) % PRIORIDADE_MAXIMA));
+    }
+    ok &= conferirAutoteste("heap: 200 mudancas de prioridade", conferirHeap(&v, a, tamanho));
+    for (int j = 0; passo && j < 16; j++) {
+        gerarComponente(&a[tamanho], n - 1 - j, n);
+        a[tamanho].prioridade = PRIORIDADE_MAXIMA - j % 3;
+        passo = visoesInserir(&v, a, tamanho);
+        tamanho += passo;
+    }
+    int topo[10];
+    passo = passo && conferirHeap(&v, a, tamanho) && maioresPrioridades(&v, a, 10, topo) == 10;
+    for (int m = 0; passo && m < 9; m++) {
+        passo = heapAntes(a, topo[m], topo[m + 1]);
+    }
+    int antesDoDecimo = 0;
+    for (int i = 0; passo && i < tamanho; i++) {
+        antesDoDecimo += heapAntes(a, i, topo[9]);
+    }
+    ok &= conferirAutoteste("heap: insercoes e os 10 de maior prioridade", passo && antesDoDecimo == 9);
+    liberarVisoes(&v);
+    free(a);
+    return ok;
+}
+
+// Ordenacoes sem comparacoes: mesma saida que o Merge Sort (estavel), inclusive nos empates.
+static int autotesteOrdenacoes(unsigned int* semente) {
+    const int n = COMPONENTES_AUTOTESTE;
+    Componente* original = (Componente*)malloc((size_t)n * sizeof(Componente));
+    Componente* a = (Componente*)malloc((size_t)n * sizeof(Componente));
+    Componente* b = (Componente*)malloc((size_t)n * sizeof(Componente));
+    if (!original || !a || !b) {
+        free(original);
+        free(a);
+        free(b);
+        return conferirAutoteste("ordenacoes: falha na alocacao", 0);
+    }
+    int ok = 1;
+    // Alguns nomes repetidos (com tipo e prioridade diferentes) expoem uma passada instavel;
+    // os nomes gerados comecam todos com 'a', entao parte deles muda a primeira letra.
+    gerarDataset(original, n, DATASET_ALEATORIO, semente);
+    for (int i = 0; i < n; i += 7) {
+        memcpy(original[i].nome, original[(i * 3 + 1) % n].nome, sizeof(original[i].nome));
+        normalizarComponente(&original[i]);
+    }
+    for (int i = 0; i < n; i += 11) {
+        original[i].nome[0] = (char)('a' + i % 26);
+        normalizarComponente(&original[i]);
+    }
+    ok &= conferirAutoteste("radix por nome igual ao Merge Sort por nome", mesmaOrdenacao(radixSortNome, mergeSortNome, original, n, a, b));
+    ok &= conferirAutoteste("counting por tipo igual ao Merge Sort por tipo", mesmaOrdenacao(countingSortTipo, mergeSortTipo, original, n, a, b));
+    ok &= conferirAutoteste("counting por prioridade igual ao Merge Sort por prioridade",
+                            mesmaOrdenacao(countingSortPrioridade, mergeSortPrioridade, original, n, a, b));
+    ok &= conferirAutoteste("radix tipo/prioridade/nome igual a tres Merge Sorts",
+                            mesmaOrdenacao(radixSortTipoPrioridadeNome, mergeSortTipoPrioridadeNome, original, n, a, b));
+    memcpy(b, original, (size_t)n * sizeof(Componente));
+    b[3].prioridade = -5;
+    b[8].prioridade = LIMITE_FAIXA_CONTAGEM; // Faixa larga demais: cai no Merge Sort
+    int passo = mesmaOrdenacao(countingSortPrioridade, mergeSortPrioridade, b, 10, a, a + 10);
+    b[8].prioridade = 40;
+    passo = passo && mesmaOrdenacao(countingSortPrioridade, mergeSortPrioridade, b, n, a, original);
+    ok &= conferirAutoteste("counting por prioridade fora de 1 a 10", passo);
+    free(original);
+    free(a);
+    free(b);
+    return ok;
+}
+
+// Executa os blocos de conferencias.
+// Retorna 1 se todas passaram, 0 caso contrario.
+int executarAutoteste(void) {
+    unsigned int semente = 12345u;
+    int ok = autotesteSnapshot(&semente);
+    ok &= autotesteDiario(&semente);
+    ok &= autotesteVisoes(&semente);
+    ok &= autotesteHeap(&semente);
+    ok &= autotesteOrdenacoes(&semente);
+    remove(ARQUIVO_AUTOTESTE);
+    remove(CORROMPIDO_AUTOTESTE);
+    remove(DIARIO_AUTOTESTE);
+    printf("Autoteste: %s\n", ok ? "ok" : "FALHOU");
+    return ok;
 }
 
 // Funcao main: gerencia o menu e operacoes.
 // Permite cadastrar componentes, escolher ordenacao, buscar e mostrar.
-int main() {
-    Componente componentes[20];
+// Com --bench [n] [repeticoes] [arquivo.csv] roda o benchmark sem menu
+// (padrao: n = 100000, 5 repeticoes, CSV na saida padrao).
+// Com --autoteste roda as conferencias de executarAutoteste (sem menu).
+// No modo interativo aceita --intervalo-diario N (registros por fsync do diario).
+int main(int argc, char* argv[]) {
+    const char* arquivoEstatisticas = NULL;
+    if (argc > 1 && strcmp(argv[1], "--autoteste") == 0) {
+        int ok = executarAutoteste();
+        liberarDicionario(&tiposComponentes);
+        return ok ? 0 : 1;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        int n = argc > 2 ? atoi(argv[2]) : 100000;
+        int repeticoes = argc > 3 ? atoi(argv[3]) : 5;
+        if (n < 1 || repeticoes < 1) {
+            fprintf(stderr, "Uso: %s --bench [n] [repeticoes] [arquivo.csv]\n", argv[0]);
+            return 1;
+        }
+        FILE* saida = stdout;
+        if (argc > 4) {
+            saida = fopen(argv[4], "w");
+            if (!saida) {
+                fprintf(stderr, "Nao foi possivel criar %s.\n", argv[4]);
+                return 1;
+            }
+        }
+        int ok = executarBenchmark(n, repeticoes, saida);
+        if (saida != stdout) {
+            fclose(saida);
+        }
+        return ok ? 0 : 1;
+    }
+
+    int intervaloDiario = INTERVALO_DIARIO_PADRAO;
+    for (int i = 1; i < argc; i += 2) {
+        int valor = i + 1 < argc ? atoi(argv[i + 1]) : 0;
+        if (strcmp(argv[i], "--intervalo-diario") == 0 && valor >= 1) {
+            intervaloDiario = valor;
+        } else if (strcmp(argv[i], "--estatisticas") == 0 && i + 1 < argc) {
+            arquivoEstatisticas = argv[i + 1];
+        } else {
+            fprintf(stderr, "Uso: %s [--intervalo-diario registros por fsync] [--estatisticas arquivo.csv]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    Componente componentes[MAX_COMPONENTES];
     int numComponentes = 0;
     int opcao;
-    int ordenadoPorNome = 0; // Flag para verificar se esta ordenado por nome para busca binaria
+    int manterOrdenado = 0; // 1: array sempre ordenado por nome (insercao ordenada)
+    VisoesOrdenadas visoes; // Visoes por nome, tipo e prioridade (busca binaria sempre disponivel)
+    initVisoes(&visoes);
+
+    // Recupera a torre da execucao anterior (snapshot + diario) e compacta. Um snapshot
+    // que existe mas nao carrega (e o diario que se apoia nele) ou um diario invalido sao
+    // guardados como *.corrompido antes: a compactacao nunca os sobrescreve.
+    // O diario e sempre repetido: a soma do snapshot no cabecalho decide o que se aplica
+    // (sem um snapshot valido, nenhum registro se aplica).
+    Diario diario = { .fd = -1 };
+    uint64_t soma = 0;
+    int snapshotRuim = 0;
+    if (carregarComponentes(componentes, &numComponentes, &visoes, ARQUIVO_SNAPSHOT)) {
+        soma = somaSnapshot(ARQUIVO_SNAPSHOT);
+    } else if (!arquivoAusente(ARQUIVO_SNAPSHOT)) {
+        printf("Aviso: snapshot %s ilegivel (corrompido ou de versao desconhecida).\n", ARQUIVO_SNAPSHOT);
+        snapshotRuim = 1;
+    }
+    long long repetidos = repetirDiario(ARQUIVO_DIARIO, soma, componentes, &numComponentes, &visoes);
+    if (repetidos == -1) {
+        printf("Aviso: diario %s invalido.\n", ARQUIVO_DIARIO);
+    } else if (repetidos > 0) {
+        printf("%lld operacoes recuperadas do diario.\n", repetidos);
+    }
+    int preservado = !snapshotRuim || separarCorrompido(ARQUIVO_SNAPSHOT);
+    if (preservado && (snapshotRuim || repetidos == -1)) {
+        preservado = separarCorrompido(ARQUIVO_DIARIO);
+    }
+    if (!preservado) {
+        printf("Aviso: nao foi possivel renomear os arquivos ilegiveis; eles nao serao alterados.\n");
+    }
+    if (!preservado || !abrirDiario(&diario, ARQUIVO_DIARIO, intervaloDiario, soma) || !compactarDiario(&diario, ARQUIVO_SNAPSHOT, componentes, numComponentes, &visoes)) {
+        printf("Aviso: diario indisponivel, as operacoes nao serao persistidas.\n");
+    }
+
+    // Algoritmos O(n log n) ou lineares, indexados por [algoritmo][criterio - 1].
+    // A ultima linha e a opcao 15 (sem comparacoes).
+    void (*algoritmosRapidos[5][3])(Componente[], int, int*, int*) = {
+        { mergeSortNome, mergeSortTipo, mergeSortPrioridade },
+        { introsortNome, introsortTipo, introsortPrioridade },
+        { heapSortNome, heapSortTipo, heapSortPrioridade },
+        { indiceSortNome, indiceSortTipo, indiceSortPrioridade },
+        { radixSortNome, countingSortTipo, countingSortPrioridade }
+    };
+    const char* nomesRapidos[5][3] = {
+        { "Merge Sort Nome", "Merge Sort Tipo", "Merge Sort Prioridade" },
+        { "Introsort Nome", "Introsort Tipo", "Introsort Prioridade" },
+        { "Heap Sort Nome", "Heap Sort Tipo", "Heap Sort Prioridade" },
+        { "Ordenacao por Indices Nome", "Ordenacao por Indices Tipo", "Ordenacao por Indices Prioridade" },
+        { "Radix Sort Nome", "Counting Sort Tipo", "Counting Sort Prioridade" }
+    };
 
     do {
         printf("\nMenu Principal:\n");
@@ -147,8 +3407,27 @@ int main() {
         printf("2. Ordenar por nome (Bubble Sort)\n");
         printf("3. Ordenar por tipo (Insertion Sort)\n");
         printf("4. Ordenar por prioridade (Selection Sort)\n");
-        printf("5. Buscar componente-chave por nome (Binaria - requer ordenacao por nome)\n");
+        printf("5. Buscar componente-chave por nome (Binaria na visao por nome)\n");
         printf("6. Mostrar componentes\n");
+        printf("7. Ordenar com Merge Sort (estavel, qualquer criterio)\n");
+        printf("8. Ordenar com Introsort (qualquer criterio)\n");
+        printf("9. Ordenar com Heap Sort (qualquer criterio)\n");
+        printf("10. Ordenar por indices (chaves compactas + permutacao)\n");
+        printf("11. Remover componente por nome\n");
+        printf("12. Listar componentes de um tipo\n");
+        printf("13. Listar componentes por faixa de prioridade\n");
+        printf("14. %s modo manter ordenado por nome\n", manterOrdenado ? "Desativar" : "Ativar");
+        printf("15. Ordenar sem comparacoes (Radix Sort no nome, Counting Sort no tipo e na prioridade)\n");
+        printf("16. Salvar componentes em arquivo\n");
+        printf("17. Carregar componentes de arquivo\n");
+        printf("18. Compactar diario de operacoes (grava o snapshot %s)\n", ARQUIVO_SNAPSHOT);
+        printf("20. Buscar componentes por prefixo do nome (autocompletar)\n");
+        printf("21. Resumo da torre (por tipo e por prioridade)\n");
+        printf("22. Estatisticas (contadores e latencias por operacao)\n");
+        printf("23. Proximo componente da fuga (maior prioridade, retira da torre)\n");
+        printf("24. Os k componentes de maior prioridade (sem ordenar)\n");
+        printf("25. Alterar a prioridade de um componente\n");
+        printf("26. Ordenar por tipo, prioridade e nome (passadas estaveis de Radix/Counting Sort)\n");
         printf("0. Sair\n");
         printf("Escolha: ");
         scanf("%d", &opcao);
@@ -157,41 +3436,84 @@ int main() {
         char nomeChave[30];
         int comparacoes;
         int resultado;
+        int criterio;
+        int algoritmo;
+        int inicio, fim;
+        int pmin, pmax;
+        int movimentos;
+        int posicao;
+        int tipoNovo;
+        Componente novo;
+        char caminho[256];
+        uint64_t inicioOp;
+        int posicoes[MAX_COMPONENTES];
+
+        // Depois de uma reconstrucao que falhou, tenta de novo antes de usar as visoes.
+        if (visoes.desatualizadas && opcaoUsaVisoes(opcao) && !visoesReconstruir(&visoes, componentes, numComponentes)) {
+            printf("Visoes indisponiveis (falta de memoria); tente novamente mais tarde.\n");
+            continue;
+        }
 
         switch (opcao) {
             case 1:
-                if (numComponentes < 20) {
-                    lerComponente(&componentes[numComponentes++]);
+                if (numComponentes < MAX_COMPONENTES) {
+                    if (!lerComponente(&novo, &tipoNovo)) {
+                        printf("Limite de %d tipos atingido.\n", MAX_TIPOS);
+                        break;
+                    }
+                    ESTAT_INICIAR(inicioOp);
+                    posicao = numComponentes;
+                    if (manterOrdenado) {
+                        posicao = inserirOrdenadoPorNome(componentes, numComponentes, &novo, &comparacoes, &movimentos);
+                        ESTAT_SOMAR(comparacoes, comparacoes);
+                        ESTAT_SOMAR(movimentos, movimentos);
+                    } else {
+                        componentes[posicao] = novo;
+                    }
+                    if (!visoesInserir(&visoes, componentes, posicao)) {
+                        printf("Falha ao alocar memoria.\n");
+                        if (tipoNovo) {
+                            descartarTipo(&tiposComponentes, novo.tipo); // O tipo so fica se o componente entrou
+                        }
+                        memmove(&componentes[posicao], &componentes[posicao + 1], (size_t)(numComponentes - posicao) * sizeof(Componente));
+                        break;
+                    }
+                    numComponentes++;
+                    ESTAT_REGISTRAR(OP_INSERIR, inicioOp);
+                    registrarOperacao(&diario, OPERACAO_INSERIR, novo.nome, nomeDoTipo(&tiposComponentes, novo.tipo), novo.prioridade);
                     printf("Componente cadastrado.\n");
-                    ordenadoPorNome = 0; // Reset flag apos insercao
+                    if (manterOrdenado) {
+                        printf("Posicao %d: %d comparacoes, %d movimentos (sem reordenar).\n", posicao, comparacoes, movimentos);
+                    }
                 } else {
                     printf("Limite de componentes atingido.\n");
                 }
                 break;
             case 2:
                 medirTempoOrdenacao(bubbleSortNome, componentes, numComponentes, "Bubble Sort Nome");
-                ordenadoPorNome = 1; // Set flag
+                reconstruirVisoesMenu(&visoes, componentes, numComponentes); // Posicoes mudaram
                 mostrarComponentes(componentes, numComponentes);
                 break;
             case 3:
                 medirTempoOrdenacao(insertionSortTipo, componentes, numComponentes, "Insertion Sort Tipo");
-                ordenadoPorNome = 0; // Reset flag
+                manterOrdenado = desativarManterOrdenado(manterOrdenado);
+                reconstruirVisoesMenu(&visoes, componentes, numComponentes);
                 mostrarComponentes(componentes, numComponentes);
                 break;
             case 4:
                 medirTempoOrdenacao(selectionSortPrioridade, componentes, numComponentes, "Selection Sort Prioridade");
-                ordenadoPorNome = 0; // Reset flag
+                manterOrdenado = desativarManterOrdenado(manterOrdenado);
+                reconstruirVisoesMenu(&visoes, componentes, numComponentes);
                 mostrarComponentes(componentes, numComponentes);
                 break;
             case 5:
-                if (!ordenadoPorNome) {
-                    printf("Ordene por nome primeiro para usar busca binaria.\n");
-                    break;
-                }
                 printf("Digite o nome do componente-chave: ");
                 fgets(nomeChave, 30, stdin);
                 nomeChave[strcspn(nomeChave, "\n")] = 0;
-                resultado = buscaBinariaPorNome(componentes, numComponentes, nomeChave, &comparacoes);
+                ESTAT_INICIAR(inicioOp);
+                resultado = buscaBinariaVisao(&visoes, componentes, nomeChave, &comparacoes);
+                ESTAT_REGISTRAR(OP_BUSCAR, inicioOp);
+                ESTAT_SOMAR(comparacoes, comparacoes);
                 if (resultado != -1) {
                     printf("Componente-chave encontrado na posicao %d.\n", resultado);
                     printf("Montagem pode prosseguir!\n");
@@ -203,12 +3525,198 @@ int main() {
             case 6:
                 mostrarComponentes(componentes, numComponentes);
                 break;
+            case 7:
+            case 8:
+            case 9:
+            case 10:
+            case 15:
+                criterio = lerCriterio();
+                if (!criterio) {
+                    printf("Criterio invalido.\n");
+                    break;
+                }
+                algoritmo = opcao == 15 ? 4 : opcao - 7;
+                medirTempoOrdenacao(algoritmosRapidos[algoritmo][criterio - 1], componentes, numComponentes, nomesRapidos[algoritmo][criterio - 1]);
+                if (criterio != CRITERIO_NOME) {
+                    manterOrdenado = desativarManterOrdenado(manterOrdenado);
+                }
+                reconstruirVisoesMenu(&visoes, componentes, numComponentes);
+                mostrarComponentes(componentes, numComponentes);
+                break;
+            case 11:
+                printf("Digite o nome do componente: ");
+                fgets(nomeChave, 30, stdin);
+                nomeChave[strcspn(nomeChave, "\n")] = 0;
+                ESTAT_INICIAR(inicioOp);
+                resultado = buscaBinariaVisao(&visoes, componentes, nomeChave, &comparacoes);
+                ESTAT_SOMAR(comparacoes, comparacoes);
+                if (resultado == -1) {
+                    printf("Componente nao encontrado.\n");
+                    break;
+                }
+                registrarOperacao(&diario, OPERACAO_REMOVER, nomeChave, "", 0);
+                visoesRemover(&visoes, componentes, resultado);
+                memmove(&componentes[resultado], &componentes[resultado + 1], (size_t)(numComponentes - resultado - 1) * sizeof(Componente));
+                numComponentes--;
+                ESTAT_SOMAR(movimentos, numComponentes - resultado);
+                ESTAT_REGISTRAR(OP_REMOVER, inicioOp);
+                printf("Componente removido.\n");
+                break;
+            case 12:
+                printf("Digite o tipo: ");
+                fgets(nomeChave, 20, stdin);
+                nomeChave[strcspn(nomeChave, "\n")] = 0;
+                ESTAT_INICIAR(inicioOp);
+                intervaloPorTipo(&visoes, componentes, nomeChave, &inicio, &fim, &comparacoes);
+                ESTAT_REGISTRAR(OP_BUSCAR, inicioOp);
+                ESTAT_SOMAR(comparacoes, comparacoes);
+                mostrarFaixaVisao(visoes.porCriterio[CRITERIO_TIPO - 1], componentes, inicio, fim);
+                printf("%d componente(s), comparacoes na busca: %d\n", fim - inicio, comparacoes);
+                break;
+            case 13:
+                printf("Prioridade minima e maxima: ");
+                scanf("%d %d", &pmin, &pmax);
+                getchar(); // Consome newline
+                ESTAT_INICIAR(inicioOp);
+                intervaloPorPrioridade(&visoes, componentes, pmin, pmax, &inicio, &fim, &comparacoes);
+                ESTAT_REGISTRAR(OP_BUSCAR, inicioOp);
+                ESTAT_SOMAR(comparacoes, comparacoes);
+                mostrarFaixaVisao(visoes.porCriterio[CRITERIO_PRIORIDADE - 1], componentes, inicio, fim);
+                printf("%d componente(s), comparacoes na busca: %d\n", fim - inicio, comparacoes);
+                break;
+            case 20:
+                printf("Digite o inicio do nome: ");
+                fgets(nomeChave, 30, stdin);
+                nomeChave[strcspn(nomeChave, "\n")] = 0;
+                ESTAT_INICIAR(inicioOp);
+                intervaloPorPrefixo(&visoes, componentes, nomeChave, &inicio, &fim, &comparacoes);
+                ESTAT_REGISTRAR(OP_BUSCAR, inicioOp);
+                ESTAT_SOMAR(comparacoes, comparacoes);
+                mostrarFaixaVisao(visoes.porCriterio[CRITERIO_NOME - 1], componentes, inicio, fim);
+                printf("%d componente(s), comparacoes na busca: %d\n", fim - inicio, comparacoes);
+                break;
+            case 21:
+                mostrarResumo(&visoes.resumo);
+                break;
+            case 22:
+                mostrarEstatisticas();
+                break;
+            case 23:
+                ESTAT_INICIAR(inicioOp);
+                resultado = visoesMaiorPrioridade(&visoes);
+                if (resultado == -1) {
+                    printf("Nenhum componente na torre.\n");
+                    break;
+                }
+                novo = componentes[resultado];
+                registrarOperacao(&diario, OPERACAO_REMOVER, novo.nome, "", 0);
+                visoesRemover(&visoes, componentes, resultado);
+                memmove(&componentes[resultado], &componentes[resultado + 1], (size_t)(numComponentes - resultado - 1) * sizeof(Componente));
+                numComponentes--;
+                ESTAT_SOMAR(movimentos, numComponentes - resultado);
+                ESTAT_REGISTRAR(OP_REMOVER, inicioOp);
+                printf("Proximo componente: %s (%s), prioridade %d. Restam %d.\n", novo.nome,
+                       nomeDoTipo(&tiposComponentes, novo.tipo), novo.prioridade, numComponentes);
+                break;
+            case 24:
+                printf("Quantos componentes? ");
+                scanf("%d", &resultado);
+                getchar(); // Consome newline
+                ESTAT_INICIAR(inicioOp);
+                resultado = maioresPrioridades(&visoes, componentes, resultado, posicoes);
+                ESTAT_REGISTRAR(OP_BUSCAR, inicioOp);
+                if (resultado == -1) {
+                    printf("Falha ao alocar memoria.\n");
+                    break;
+                }
+                mostrarFaixaVisao(posicoes, componentes, 0, resultado);
+                break;
+            case 25:
+                printf("Digite o nome do componente: ");
+                fgets(nomeChave, 30, stdin);
+                nomeChave[strcspn(nomeChave, "\n")] = 0;
+                resultado = buscaBinariaVisao(&visoes, componentes, nomeChave, &comparacoes);
+                if (resultado == -1) {
+                    printf("Componente nao encontrado.\n");
+                    break;
+                }
+                printf("Nova prioridade (1 a %d): ", PRIORIDADE_MAXIMA);
+                scanf("%d", &pmin);
+                getchar(); // Consome newline
+                if (pmin < 1 || pmin > PRIORIDADE_MAXIMA) {
+                    printf("Prioridade invalida: use um valor de 1 a %d.\n", PRIORIDADE_MAXIMA);
+                    break;
+                }
+                visoesAlterarPrioridade(&visoes, componentes, resultado, pmin);
+                registrarOperacao(&diario, OPERACAO_PRIORIDADE, componentes[resultado].nome, "", pmin);
+                printf("Prioridade de %s agora e %d.\n", componentes[resultado].nome, pmin);
+                break;
+            case 14:
+                if (manterOrdenado) {
+                    manterOrdenado = 0;
+                    printf("Modo manter ordenado desativado.\n");
+                    break;
+                }
+                medirTempoOrdenacao(mergeSortNome, componentes, numComponentes, "Merge Sort Nome");
+                reconstruirVisoesMenu(&visoes, componentes, numComponentes);
+                manterOrdenado = 1;
+                printf("Modo manter ordenado ativado: cadastros entram na posicao certa por nome.\n");
+                break;
+            case 26:
+                medirTempoOrdenacao(radixSortTipoPrioridadeNome, componentes, numComponentes, "Radix Sort Tipo, Prioridade e Nome");
+                manterOrdenado = desativarManterOrdenado(manterOrdenado);
+                reconstruirVisoesMenu(&visoes, componentes, numComponentes);
+                mostrarComponentes(componentes, numComponentes);
+                break;
+            case 16:
+            case 17:
+                printf("Digite o nome do arquivo: ");
+                fgets(caminho, sizeof(caminho), stdin);
+                caminho[strcspn(caminho, "\n")] = 0;
+                if (opcao == 16) {
+                    printf(salvarComponentes(componentes, numComponentes, &visoes, caminho) ? "Componentes salvos em %s.\n" : "Falha ao gravar %s.\n", caminho);
+                } else if (carregarComponentes(componentes, &numComponentes, &visoes, caminho)) {
+                    manterOrdenado = 0; // A ordem do array e a do arquivo
+                    printf("%d componentes carregados de %s.\n", numComponentes, caminho);
+                    // O diario descreve operacoes sobre a torre anterior: recomeca a partir desta.
+                    if (diario.fd >= 0 && !compactarDiario(&diario, ARQUIVO_SNAPSHOT, componentes, numComponentes, &visoes)) {
+                        printf("Aviso: falha ao compactar o diario.\n");
+                    }
+                } else {
+                    printf("Nao foi possivel carregar %s (ausente, corrompido ou de outra versao).\n", caminho);
+                }
+                break;
+            case 18:
+                printf("Registros no diario: %lld em %lld commits (intervalo %d)\n", diario.registros, diario.commits, diario.intervalo);
+                printf("Falhas de gravacao: %lld\n", diario.falhas);
+                if (diario.fd >= 0 && compactarDiario(&diario, ARQUIVO_SNAPSHOT, componentes, numComponentes, &visoes)) {
+                    printf("Diario compactado em %s (%lld compactacoes).\n", ARQUIVO_SNAPSHOT, diario.compactacoes);
+                } else {
+                    printf("Falha ao compactar o diario.\n");
+                }
+                break;
             case 0:
                 break;
             default:
                 printf("Opcao invalida.\n");
         }
+        avisarFalhasDiario(&diario);
     } while (opcao != 0);
 
+    if (diario.fd >= 0) {
+        // Com visoes desatualizadas o snapshot sairia incoerente: o diario fica para a proxima execucao.
+        if ((visoes.desatualizadas && !visoesReconstruir(&visoes, componentes, numComponentes))
+            || !compactarDiario(&diario, ARQUIVO_SNAPSHOT, componentes, numComponentes, &visoes)) {
+            printf("Aviso: falha ao compactar o diario; ele sera repetido na proxima execucao.\n");
+        }
+        fecharDiario(&diario);
+        avisarFalhasDiario(&diario);
+    }
+    liberarVisoes(&visoes);
+    liberarDicionario(&tiposComponentes);
+    if (arquivoEstatisticas && !exportarEstatisticas(arquivoEstatisticas)) {
+        fprintf(stderr, "Nao foi possivel gravar as estatisticas em %s.\n", arquivoEstatisticas);
+        return 1;
+    }
     return 0;
 }
\ No newline at end of file
@@ -1,6 +1,10 @@
+#define _POSIX_C_SOURCE 200809L // Com -std=c11: clock_gettime dos histogramas de latência, fileno e fsync
 #include <stdio.h>    // Biblioteca para entrada e saída padrão
 #include <stdlib.h>   // Biblioteca para funções utilitárias (ex: system)
 #include <string.h>   // Biblioteca para manipulação de strings
+#include <stdint.h>   // Biblioteca para inteiros de tamanho fixo (uint64_t)
+#include <time.h>     // Biblioteca para o relógio monótono (clock_gettime)
+#include <unistd.h>   // Biblioteca POSIX (fsync)
 
 // Definição da struct que representa um item da mochila
 typedef struct {
@@ -14,12 +18,146 @@ typedef struct {
 Item mochila[MAX_ITENS];
 int totalItens = 0;
 
+// Índice hash sobre o nome dos itens (endereçamento aberto com sondagem linear).
+// Cada posição guarda o índice do item em mochila[] ou -1 se estiver vazia.
+// O tamanho é uma potência de 2 com folga em relação a MAX_ITENS, para sondagens curtas.
+#define TAM_INDICE 32
+int indiceNomes[TAM_INDICE];
+
+// Estatísticas de execução: quantas inserções, remoções e buscas foram feitas,
+// quantas comparações e itens movidos elas custaram e, por operação, um histograma
+// de latências com baldes em potências de 2 (o balde b conta as latências em
+// [2^b, 2^(b+1)) ns; o último também guarda as maiores).
+// O formato é o mesmo dos outros níveis: "ordenar" e "alocacoes" ficam em zero aqui,
+// porque a mochila não é ordenada e vive num vetor fixo.
+// Compilando com -DSEM_ESTATISTICAS as macros ESTAT_* não fazem nada.
+// Versão reduzida do bloco de Desafio-aventureiro-sobrevivencia.c, que é a referência
+// (cada desafio compila sozinho, sem cabeçalho comum): altere lá e replique aqui.
+typedef enum {
+    OP_INSERIR,
+    OP_REMOVER,
+    OP_BUSCAR,
+    OP_ORDENAR,
+    NUM_OPERACOES
+} OperacaoMedida;
+
+#define BALDES_LATENCIA 32
+
+typedef struct {
+    long long operacoes[NUM_OPERACOES];
+    long long nanossegundos[NUM_OPERACOES]; // Soma das latências, para a média
+    long long latencias[NUM_OPERACOES][BALDES_LATENCIA];
+    long long comparacoes;
+    long long movimentos;
+    long long alocacoes;
+} Estatisticas;
+
+Estatisticas estatisticas;
+const char* nomesOperacoes[NUM_OPERACOES] = { "inserir", "remover", "buscar", "ordenar" };
+
+#ifndef SEM_ESTATISTICAS
+// Função que lê o relógio monótono em nanossegundos
+static inline uint64_t relogioNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Função para contar uma operação e colocar sua latência no balde certo
+static void registrarLatencia(OperacaoMedida op, uint64_t ns) {
+    int balde = 63 - __builtin_clzll(ns | 1); // Posição do bit mais alto
+    if (balde >= BALDES_LATENCIA) {
+        balde = BALDES_LATENCIA - 1;
+    }
+    estatisticas.operacoes[op]++;
+    estatisticas.nanossegundos[op] += (long long)ns;
+    estatisticas.latencias[op][balde]++;
+}
+
+#define ESTAT_INICIAR(t) ((t) = relogioNs())
+#define ESTAT_REGISTRAR(op, t) registrarLatencia((op), relogioNs() - (t))
+#define ESTAT_SOMAR(campo, n) (estatisticas.campo += (n))
+#else
+#define ESTAT_INICIAR(t) ((t) = 0)
+#define ESTAT_REGISTRAR(op, t) ((void)(op), (void)(t))
+#define ESTAT_SOMAR(campo, n) ((void)(n))
+#endif
+
 // Função para limpar o buffer do teclado (evita problemas com fgets)
 void limparBuffer() {
     int c;
     while ((c = getchar()) != '\n' && c != EOF) {}
 }
 
+// Função hash FNV-1a sobre o nome, reduzida ao tamanho do índice
+unsigned int hashNome(const char* nome) {
+    unsigned int h = 2166136261u;
+    while (*nome) {
+        h ^= (unsigned char)*nome++;
+        h *= 16777619u;
+    }
+    return h & (TAM_INDICE - 1);
+}
+
+// Função para esvaziar o índice (todas as posições livres)
+void iniciarIndice() {
+    for (int i = 0; i < TAM_INDICE; i++) {
+        indiceNomes[i] = -1;
+    }
+}
+
+// Função para registrar no índice o item que está em mochila[pos]
+void indiceInserir(int pos) {
+    unsigned int i = hashNome(mochila[pos].nome);
+    while (indiceNomes[i] != -1) {
+        i = (i + 1) & (TAM_INDICE - 1);
+    }
+    indiceNomes[i] = pos;
+}
+
+// Função que devolve a posição do item no índice (ou -1 se não estiver lá)
+// Em média consulta uma ou duas posições, em vez de percorrer a mochila toda
+int indiceBuscar(const char* nome) {
+    unsigned int i = hashNome(nome);
+    while (indiceNomes[i] != -1) {
+        ESTAT_SOMAR(comparacoes, 1);
+        if (strcmp(mochila[indiceNomes[i]].nome, nome) == 0) {
+            return indiceNomes[i];
+        }
+        i = (i + 1) & (TAM_INDICE - 1);
+    }
+    return -1;
+}
+
+// Função que devolve a posição do índice que aponta para mochila[pos]
+unsigned int indiceSlotDe(int pos) {
+    unsigned int i = hashNome(mochila[pos].nome);
+    while (indiceNomes[i] != pos) {
+        i = (i + 1) & (TAM_INDICE - 1);
+    }
+    return i;
+}
+
+// Função para tirar do índice o item que está em mochila[pos]
+// Os itens seguintes da mesma sequência de sondagem são puxados para trás,
+// para que nenhuma busca pare antes da hora num buraco
+void indiceRemover(int pos) {
+    unsigned int i = indiceSlotDe(pos);
+    unsigned int j = i;
+    while (1) {
+        j = (j + 1) & (TAM_INDICE - 1);
+        if (indiceNomes[j] == -1) {
+            break;
+        }
+        unsigned int k = hashNome(mochila[indiceNomes[j]].nome); // posição ideal do item j
+        if (((j - k) & (TAM_INDICE - 1)) >= ((j - i) & (TAM_INDICE - 1))) {
+            indiceNomes[i] = indiceNomes[j];
+            i = j;
+        }
+    }
+    indiceNomes[i] = -1;
+}
+
 // Função para cadastrar um novo item na mochila
 void inserirItem() {
     if (totalItens >= MAX_ITENS) {
@@ -41,8 +179,12 @@ void inserirItem() {
     printf("Digite a quantidade: ");
     scanf("%d", &novo.quantidade);
 
+    uint64_t inicio;
+    ESTAT_INICIAR(inicio);
     mochila[totalItens] = novo;  // adiciona ao vetor
+    indiceInserir(totalItens);   // registra o nome no índice
     totalItens++;
+    ESTAT_REGISTRAR(OP_INSERIR, inicio);
 
     printf("Item adicionado com sucesso!\n");
 }
@@ -60,22 +202,26 @@ void removerItem() {
     fgets(nome, sizeof(nome), stdin);
     nome[strcspn(nome, "\n")] = '\0';
 
-    // Busca pelo item no vetor
-    int encontrado = 0;
-    for (int i = 0; i < totalItens; i++) {
-        if (strcmp(mochila[i].nome, nome) == 0) {
-            encontrado = 1;
-            // Sobrescreve o item com o último da lista
-            mochila[i] = mochila[totalItens - 1];
-            totalItens--;
-            printf("Item '%s' removido com sucesso.\n", nome);
-            break;
-        }
+    // Busca pelo item no índice
+    uint64_t inicio;
+    ESTAT_INICIAR(inicio);
+    int i = indiceBuscar(nome);
+    if (i == -1) {
+        printf("Item não encontrado.\n");
+        return;
     }
 
-    if (!encontrado) {
-        printf("Item não encontrado.\n");
+    indiceRemover(i);
+    // Sobrescreve o item com o último da lista e atualiza a posição dele no índice
+    int ultimo = totalItens - 1;
+    if (i != ultimo) {
+        indiceNomes[indiceSlotDe(ultimo)] = i;
+        mochila[i] = mochila[ultimo];
+        ESTAT_SOMAR(movimentos, 1);
     }
+    totalItens--;
+    ESTAT_REGISTRAR(OP_REMOVER, inicio);
+    printf("Item '%s' removido com sucesso.\n", nome);
 }
 
 // Função para listar todos os itens da mochila
@@ -95,7 +241,7 @@ void listarItens() {
     printf("------------------------\n");
 }
 
-// Função de busca sequencial por nome do item
+// Função de busca por nome do item (usa o índice hash)
 void buscarItem() {
     if (totalItens == 0) {
         printf("A mochila está vazia.\n");
@@ -108,26 +254,186 @@ void buscarItem() {
     fgets(nome, sizeof(nome), stdin);
     nome[strcspn(nome, "\n")] = '\0';
 
-    int encontrado = 0;
-    for (int i = 0; i < totalItens; i++) {
-        if (strcmp(mochila[i].nome, nome) == 0) {
-            printf("Item encontrado:\n");
-            printf("  Nome: %s\n", mochila[i].nome);
-            printf("  Tipo: %s\n", mochila[i].tipo);
-            printf("  Quantidade: %d\n", mochila[i].quantidade);
-            encontrado = 1;
-            break;
+    uint64_t inicio;
+    ESTAT_INICIAR(inicio);
+    int i = indiceBuscar(nome);
+    ESTAT_REGISTRAR(OP_BUSCAR, inicio);
+    if (i != -1) {
+        printf("Item encontrado:\n");
+        printf("  Nome: %s\n", mochila[i].nome);
+        printf("  Tipo: %s\n", mochila[i].tipo);
+        printf("  Quantidade: %d\n", mochila[i].quantidade);
+    } else {
+        printf("Item não encontrado.\n");
+    }
+}
+
+// Arquivo binário onde a mochila é salva: um cabeçalho fixo, os itens e o índice,
+// gravados exatamente como estão na memória (carregar é só ler os blocos de volta).
+#define ARQUIVO_MOCHILA "mochila.dat"
+#define VERSAO_ARQUIVO 1
+
+typedef struct {
+    char magica[8];             // "MOCHILA": identifica o formato
+    unsigned int versao;        // Muda se o formato mudar
+    unsigned int tamanhoItem;   // sizeof(Item) de quem gravou
+    unsigned int totalItens;
+    unsigned int tamanhoIndice; // TAM_INDICE de quem gravou
+    unsigned int soma;          // Soma de verificação dos itens e do índice
+} CabecalhoArquivo;
+
+// Soma de verificação FNV-1a sobre bytes, continuando a partir de 'h'
+unsigned int somaVerificacao(const void* dados, size_t tamanho, unsigned int h) {
+    const unsigned char* p = (const unsigned char*)dados;
+    for (size_t i = 0; i < tamanho; i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Função para salvar a mochila (itens e índice) no arquivo
+// Grava num arquivo temporário, força os dados para o disco (fflush + fsync) e só depois
+// o renomeia, para nunca deixar um arquivo pela metade
+void salvarMochila() {
+    CabecalhoArquivo cab;
+    memset(&cab, 0, sizeof(cab));
+    memcpy(cab.magica, "MOCHILA", 8);
+    cab.versao = VERSAO_ARQUIVO;
+    cab.tamanhoItem = sizeof(Item);
+    cab.totalItens = (unsigned int)totalItens;
+    cab.tamanhoIndice = TAM_INDICE;
+    cab.soma = somaVerificacao(mochila, (size_t)totalItens * sizeof(Item), 2166136261u);
+    cab.soma = somaVerificacao(indiceNomes, sizeof(indiceNomes), cab.soma);
+
+    FILE* arquivo = fopen(ARQUIVO_MOCHILA ".tmp", "wb");
+    if (!arquivo) {
+        printf("Não foi possível criar o arquivo.\n");
+        return;
+    }
+    int ok = fwrite(&cab, sizeof(cab), 1, arquivo) == 1
+          && fwrite(mochila, sizeof(Item), (size_t)totalItens, arquivo) == (size_t)totalItens
+          && fwrite(indiceNomes, sizeof(indiceNomes), 1, arquivo) == 1
+          && fflush(arquivo) == 0
+          && fsync(fileno(arquivo)) == 0;
+    if (fclose(arquivo) != 0 || !ok || rename(ARQUIVO_MOCHILA ".tmp", ARQUIVO_MOCHILA) != 0) {
+        remove(ARQUIVO_MOCHILA ".tmp");
+        printf("Falha ao gravar o arquivo.\n");
+        return;
+    }
+    printf("Mochila salva em %s (%d itens).\n", ARQUIVO_MOCHILA, totalItens);
+}
+
+// Função para carregar a mochila salva, substituindo a atual
+// Os itens e o índice são lidos em blocos inteiros; o arquivo só é aceito se formato,
+// versão, tamanhos e soma de verificação baterem e se o conteúdo for utilizável:
+// nomes e tipos terminados em '\0' e cada posição do índice vazia (-1) ou apontando
+// para um item carregado, com cada item no índice exatamente uma vez. A soma só pega
+// bytes trocados por acidente; sem essas verificações um arquivo montado com a soma
+// certa faria indiceBuscar ler fora da mochila.
+void carregarMochila() {
+    FILE* arquivo = fopen(ARQUIVO_MOCHILA, "rb");
+    if (!arquivo) {
+        printf("Nenhuma mochila salva em %s.\n", ARQUIVO_MOCHILA);
+        return;
+    }
+    CabecalhoArquivo cab;
+    Item itens[MAX_ITENS];
+    int indice[TAM_INDICE];
+    int ok = fread(&cab, sizeof(cab), 1, arquivo) == 1
+          && memcmp(cab.magica, "MOCHILA", 8) == 0
+          && cab.versao == VERSAO_ARQUIVO
+          && cab.tamanhoItem == sizeof(Item)
+          && cab.totalItens <= MAX_ITENS
+          && cab.tamanhoIndice == TAM_INDICE
+          && fread(itens, sizeof(Item), cab.totalItens, arquivo) == cab.totalItens
+          && fread(indice, sizeof(indice), 1, arquivo) == 1;
+    fclose(arquivo);
+    if (ok) {
+        unsigned int soma = somaVerificacao(itens, (size_t)cab.totalItens * sizeof(Item), 2166136261u);
+        ok = somaVerificacao(indice, sizeof(indice), soma) == cab.soma;
+    }
+    for (unsigned int i = 0; ok && i < cab.totalItens; i++) {
+        ok = memchr(itens[i].nome, '\0', sizeof(itens[i].nome)) != NULL
+          && memchr(itens[i].tipo, '\0', sizeof(itens[i].tipo)) != NULL;
+    }
+    int referencias[MAX_ITENS] = { 0 };
+    int ocupadas = 0;
+    for (int i = 0; ok && i < TAM_INDICE; i++) {
+        if (indice[i] != -1) {
+            ok = indice[i] >= 0 && indice[i] < (int)cab.totalItens && referencias[indice[i]]++ == 0;
+            ocupadas++;
         }
     }
+    ok = ok && ocupadas == (int)cab.totalItens;
+    if (!ok) {
+        printf("Arquivo inválido ou corrompido; a mochila atual foi mantida.\n");
+        return;
+    }
+    memcpy(mochila, itens, (size_t)cab.totalItens * sizeof(Item));
+    memcpy(indiceNomes, indice, sizeof(indice));
+    totalItens = (int)cab.totalItens;
+    printf("%d itens carregados de %s.\n", totalItens, ARQUIVO_MOCHILA);
+}
 
-    if (!encontrado) {
-        printf("Item não encontrado.\n");
+// Função para mostrar as estatísticas: contadores e, para cada operação feita,
+// a latência média e os baldes não vazios do histograma
+void mostrarEstatisticas() {
+#ifdef SEM_ESTATISTICAS
+    printf("Estatísticas desligadas na compilação (-DSEM_ESTATISTICAS).\n");
+#else
+    printf("\n--- Estatísticas ---\n");
+    printf("Comparações: %lld | Itens movidos: %lld\n", estatisticas.comparacoes, estatisticas.movimentos);
+    for (int op = 0; op < NUM_OPERACOES; op++) {
+        long long n = estatisticas.operacoes[op];
+        if (n == 0) {
+            continue;
+        }
+        printf("%s: %lld operações, média %.0f ns\n", nomesOperacoes[op], n, (double)estatisticas.nanossegundos[op] / n);
+        for (int b = 0; b < BALDES_LATENCIA; b++) {
+            if (estatisticas.latencias[op][b] > 0) {
+                printf("  até %12llu ns: %lld\n", (1ULL << (b + 1)) - 1, estatisticas.latencias[op][b]);
+            }
+        }
     }
+#endif
+}
+
+// Função para exportar as estatísticas em CSV (metrica,valor), no mesmo formato
+// dos outros níveis. Retorna 1 se o arquivo foi gravado, 0 caso contrário.
+int exportarEstatisticas(const char* caminho) {
+    FILE* arquivo = fopen(caminho, "w");
+    if (!arquivo) {
+        return 0;
+    }
+    fprintf(arquivo, "metrica,valor\n");
+    fprintf(arquivo, "comparacoes,%lld\n", estatisticas.comparacoes);
+    fprintf(arquivo, "movimentos,%lld\n", estatisticas.movimentos);
+    fprintf(arquivo, "alocacoes,%lld\n", estatisticas.alocacoes);
+    for (int op = 0; op < NUM_OPERACOES; op++) {
+        fprintf(arquivo, "%s.quantidade,%lld\n", nomesOperacoes[op], estatisticas.operacoes[op]);
+        fprintf(arquivo, "%s.ns_total,%lld\n", nomesOperacoes[op], estatisticas.nanossegundos[op]);
+        for (int b = 0; b < BALDES_LATENCIA; b++) {
+            fprintf(arquivo, "%s.ate_%lluns,%lld\n", nomesOperacoes[op], (1ULL << (b + 1)) - 1, estatisticas.latencias[op][b]);
+        }
+    }
+    return fclose(arquivo) == 0;
 }
 
 // Função principal que exibe o menu e interage com o usuário
-int main() {
+// Com --estatisticas <arquivo.csv> grava as estatísticas no arquivo ao sair
+int main(int argc, char* argv[]) {
     int opcao;
+    const char* arquivoEstatisticas = NULL;
+
+    if (argc == 3 && strcmp(argv[1], "--estatisticas") == 0) {
+        arquivoEstatisticas = argv[2];
+    } else if (argc != 1) {
+        fprintf(stderr, "Uso: %s [--estatisticas arquivo.csv]\n", argv[0]);
+        return 1;
+    }
+
+    iniciarIndice();
 
     do {
         printf("\n===== SISTEMA DE INVENTÁRIO =====\n");
@@ -135,6 +441,9 @@ int main() {
         printf("2. Remover item\n");
         printf("3. Listar itens\n");
         printf("4. Buscar item\n");
+        printf("5. Salvar mochila\n");
+        printf("6. Carregar mochila salva\n");
+        printf("7. Estatísticas\n");
         printf("0. Sair\n");
         printf("Escolha uma opcao: ");
         scanf("%d", &opcao);
@@ -152,6 +461,15 @@ int main() {
             case 4:
                 buscarItem();
                 break;
+            case 5:
+                salvarMochila();
+                break;
+            case 6:
+                carregarMochila();
+                break;
+            case 7:
+                mostrarEstatisticas();
+                break;
             case 0:
                 printf("Saindo do sistema...\n");
                 break;
@@ -161,5 +479,9 @@ int main() {
 
     } while (opcao != 0);
 
+    if (arquivoEstatisticas && !exportarEstatisticas(arquivoEstatisticas)) {
+        fprintf(stderr, "Não foi possível gravar as estatísticas em %s.\n", arquivoEstatisticas);
+        return 1;
+    }
     return 0;
 }